@@ -0,0 +1,128 @@
+
+#include "asset_pack.h"
+#include "utils.h"
+
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+int AssetPack_Open(AssetPack* pack, const char* path)
+{
+    memset(pack, 0, sizeof(AssetPack));
+
+#if defined(_WIN32)
+    return 0;
+#else
+    /* entries are used in place */
+    if (End_IsBig())
+        return 0;
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd == -1)
+        return 0;
+
+    struct stat info;
+
+    if (fstat(fd, &info) != 0 || info.st_size < sizeof(AssetPackHeader))
+    {
+        close(fd);
+        return 0;
+    }
+
+    void* base = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    /* the mapping stays valid after the descriptor closes */
+    close(fd);
+
+    if (base == MAP_FAILED)
+        return 0;
+
+    pack->base = base;
+    pack->size = info.st_size;
+
+    const AssetPackHeader* header = base;
+
+    if (header->magic != ASSET_PACK_MAGIC || header->version != ASSET_PACK_VERSION)
+    {
+        printf("invalid asset pack: %s\n", path);
+        AssetPack_Close(pack);
+        return 0;
+    }
+
+    if (sizeof(AssetPackHeader) + header->entryCount * sizeof(AssetPackEntry) > pack->size)
+    {
+        printf("truncated asset pack: %s\n", path);
+        AssetPack_Close(pack);
+        return 0;
+    }
+
+    pack->entries = (const AssetPackEntry*)(pack->base + sizeof(AssetPackHeader));
+    pack->entryCount = header->entryCount;
+
+    for (int i = 0; i < pack->entryCount; ++i)
+    {
+        const AssetPackEntry* entry = pack->entries + i;
+
+        if ((size_t)entry->offset + entry->length > pack->size)
+        {
+            printf("truncated asset pack: %s\n", path);
+            AssetPack_Close(pack);
+            return 0;
+        }
+    }
+
+    return 1;
+#endif
+}
+
+void AssetPack_Close(AssetPack* pack)
+{
+#if !defined(_WIN32)
+    if (pack->base)
+        munmap((void*)pack->base, pack->size);
+#endif
+
+    memset(pack, 0, sizeof(AssetPack));
+}
+
+static int AssetPackEntry_Compare(const void* a, const void* b)
+{
+    const AssetPackEntry* ea = a;
+    const AssetPackEntry* eb = b;
+
+    if (ea->type != eb->type)
+        return ea->type < eb->type ? -1 : 1;
+
+    if (ea->identifier != eb->identifier)
+        return ea->identifier < eb->identifier ? -1 : 1;
+
+    return 0;
+}
+
+const AssetPackEntry* AssetPack_Find(const AssetPack* pack, int type, int identifier)
+{
+    if (!pack->entries)
+        return NULL;
+
+    AssetPackEntry key;
+    key.type = type;
+    key.identifier = identifier;
+
+    return bsearch(&key, pack->entries, pack->entryCount, sizeof(AssetPackEntry), AssetPackEntry_Compare);
+}
+
+const void* AssetPack_Data(const AssetPack* pack, const AssetPackEntry* entry)
+{
+    return pack->base + entry->offset;
+}
+
+FILE* AssetPack_OpenStream(const AssetPack* pack, const AssetPackEntry* entry)
+{
+    return File_OpenMemory(AssetPack_Data(pack, entry), entry->length);
+}
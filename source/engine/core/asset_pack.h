@@ -0,0 +1,61 @@
+
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ A pack is every manifest asset concatenated into one file (see tools/assetmanifest -pack).
+ It is mapped once and each asset is found by (type, identifier) from data_assets.h,
+ so loading does not open and seek hundreds of small files.
+
+ layout, little endian:
+ AssetPackHeader
+ AssetPackEntry[entryCount] sorted by type then identifier
+ payloads, each aligned to ASSET_PACK_ALIGN
+ */
+
+#define ASSET_PACK_MAGIC 0x50425250 /* "PRBP" */
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_ALIGN 16
+#define ASSET_PACK_EXT_MAX 8
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+} AssetPackHeader;
+
+typedef struct
+{
+    uint32_t type;
+    uint32_t identifier;
+    uint32_t offset;
+    uint32_t length;
+    /* extension of the source file, selects the loader */
+    char extension[ASSET_PACK_EXT_MAX];
+} AssetPackEntry;
+
+typedef struct
+{
+    const unsigned char* base;
+    size_t size;
+
+    const AssetPackEntry* entries;
+    int entryCount;
+} AssetPack;
+
+/* returns 0 if the pack is missing or invalid, callers fall back to loose files */
+extern int AssetPack_Open(AssetPack* pack, const char* path);
+extern void AssetPack_Close(AssetPack* pack);
+
+extern const AssetPackEntry* AssetPack_Find(const AssetPack* pack, int type, int identifier);
+extern const void* AssetPack_Data(const AssetPack* pack, const AssetPackEntry* entry);
+
+/* read only stream over an entry for the FILE* based loaders. close with fclose */
+extern FILE* AssetPack_OpenStream(const AssetPack* pack, const AssetPackEntry* entry);
+
+#endif
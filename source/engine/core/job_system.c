@@ -0,0 +1,232 @@
+
+#include "job_system.h"
+#include "vec_math.h"
+#include <stdio.h>
+
+static int JobQueue_Push(JobQueue* queue, Job job)
+{
+    Mutex_Lock(&queue->mutex);
+    
+    int pushed = (queue->tail - queue->head < JOB_QUEUE_MAX);
+    
+    if (pushed)
+    {
+        queue->jobs[queue->tail % JOB_QUEUE_MAX] = job;
+        ++queue->tail;
+    }
+    
+    Mutex_Unlock(&queue->mutex);
+    return pushed;
+}
+
+/* the owner works newest first, while the data it just queued is still in cache */
+static int JobQueue_Pop(JobQueue* queue, Job* job)
+{
+    Mutex_Lock(&queue->mutex);
+    
+    int taken = (queue->tail > queue->head);
+    
+    if (taken)
+    {
+        --queue->tail;
+        *job = queue->jobs[queue->tail % JOB_QUEUE_MAX];
+        
+        if (queue->tail == queue->head)
+            queue->head = queue->tail = 0;
+    }
+    
+    Mutex_Unlock(&queue->mutex);
+    return taken;
+}
+
+static int JobQueue_Steal(JobQueue* queue, Job* job)
+{
+    Mutex_Lock(&queue->mutex);
+    
+    int taken = (queue->tail > queue->head);
+    
+    if (taken)
+    {
+        *job = queue->jobs[queue->head % JOB_QUEUE_MAX];
+        ++queue->head;
+        
+        if (queue->tail == queue->head)
+            queue->head = queue->tail = 0;
+    }
+    
+    Mutex_Unlock(&queue->mutex);
+    return taken;
+}
+
+static int JobSystem_Take(JobSystem* jobs, int index, Job* job)
+{
+    int taken = JobQueue_Pop(jobs->queues + index, job);
+    
+    for (int i = 1; i < jobs->threadCount && !taken; ++i)
+        taken = JobQueue_Steal(jobs->queues + (index + i) % jobs->threadCount, job);
+    
+    if (taken)
+    {
+        Mutex_Lock(&jobs->mutex);
+        --jobs->queued;
+        Mutex_Unlock(&jobs->mutex);
+    }
+    
+    return taken;
+}
+
+static void JobSystem_RunJobs(JobSystem* jobs, int index)
+{
+    Job job;
+    
+    while (JobSystem_Take(jobs, index, &job))
+    {
+        job.func(job.data, job.first, job.count);
+        
+        Mutex_Lock(&jobs->mutex);
+        
+        if (--jobs->pending == 0)
+            Cond_Broadcast(&jobs->done);
+        
+        Mutex_Unlock(&jobs->mutex);
+    }
+}
+
+static void* JobSystem_Work(void* arg)
+{
+    JobWorker* worker = arg;
+    JobSystem* jobs = worker->system;
+    
+    Mutex_Lock(&jobs->mutex);
+    
+    while (jobs->running)
+    {
+        if (jobs->queued == 0)
+        {
+            Cond_Wait(&jobs->wake, &jobs->mutex);
+            continue;
+        }
+        
+        Mutex_Unlock(&jobs->mutex);
+        JobSystem_RunJobs(jobs, worker->index);
+        Mutex_Lock(&jobs->mutex);
+    }
+    
+    Mutex_Unlock(&jobs->mutex);
+    return NULL;
+}
+
+int JobSystem_Init(JobSystem* jobs, int threadCount)
+{
+    jobs->threadCount = CLAMP(threadCount, 1, JOB_THREADS_MAX);
+    jobs->queued = 0;
+    jobs->pending = 0;
+    jobs->running = 1;
+    
+    Mutex_Init(&jobs->mutex);
+    Cond_Init(&jobs->wake);
+    Cond_Init(&jobs->done);
+    
+    for (int i = 0; i < JOB_THREADS_MAX; ++i)
+    {
+        Mutex_Init(&jobs->queues[i].mutex);
+        jobs->queues[i].head = 0;
+        jobs->queues[i].tail = 0;
+    }
+    
+    for (int i = 1; i < jobs->threadCount; ++i)
+    {
+        JobWorker* worker = jobs->workers + i;
+        worker->system = jobs;
+        worker->index = i;
+        
+        if (!Thread_Start(&worker->thread, JobSystem_Work, worker))
+        {
+            /* carry on with the threads we have */
+            printf("failed to start job thread %i\n", i);
+            jobs->threadCount = i;
+            break;
+        }
+    }
+    
+    return 1;
+}
+
+void JobSystem_Shutdown(JobSystem* jobs)
+{
+    Mutex_Lock(&jobs->mutex);
+    jobs->running = 0;
+    Cond_Broadcast(&jobs->wake);
+    Mutex_Unlock(&jobs->mutex);
+    
+    for (int i = 1; i < jobs->threadCount; ++i)
+        Thread_Join(&jobs->workers[i].thread);
+    
+    for (int i = 0; i < JOB_THREADS_MAX; ++i)
+        Mutex_Shutdown(&jobs->queues[i].mutex);
+    
+    Cond_Shutdown(&jobs->done);
+    Cond_Shutdown(&jobs->wake);
+    Mutex_Shutdown(&jobs->mutex);
+    
+    jobs->threadCount = 1;
+}
+
+void JobSystem_ParallelFor(JobSystem* jobs, JobFunc func, void* data, int count, int batchSize)
+{
+    if (count < 1)
+        return;
+    
+    batchSize = MAX(batchSize, 1);
+    
+    /* every job has to fit in the queues at once */
+    int jobMax = jobs->threadCount * JOB_QUEUE_MAX;
+    batchSize = MAX(batchSize, (count + jobMax - 1) / jobMax);
+    
+    int jobCount = (count + batchSize - 1) / batchSize;
+    
+    if (jobs->threadCount < 2 || jobCount < 2)
+    {
+        func(data, 0, count);
+        return;
+    }
+    
+    /* counted before they are visible, so pending can't reach 0 early */
+    Mutex_Lock(&jobs->mutex);
+    jobs->queued += jobCount;
+    jobs->pending += jobCount;
+    Mutex_Unlock(&jobs->mutex);
+    
+    for (int i = 0; i < jobCount; ++i)
+    {
+        Job job;
+        job.func = func;
+        job.data = data;
+        job.first = i * batchSize;
+        job.count = MIN(batchSize, count - job.first);
+        
+        if (JobQueue_Push(jobs->queues + i % jobs->threadCount, job))
+            continue;
+        
+        /* the batch size makes every job fit, but a job no queue holds would leave pending above 0 forever */
+        func(data, job.first, job.count);
+        
+        Mutex_Lock(&jobs->mutex);
+        --jobs->queued;
+        --jobs->pending;
+        Mutex_Unlock(&jobs->mutex);
+    }
+    
+    Mutex_Lock(&jobs->mutex);
+    Cond_Broadcast(&jobs->wake);
+    Mutex_Unlock(&jobs->mutex);
+    
+    JobSystem_RunJobs(jobs, 0);
+    
+    Mutex_Lock(&jobs->mutex);
+    
+    while (jobs->pending > 0)
+        Cond_Wait(&jobs->done, &jobs->mutex);
+    
+    Mutex_Unlock(&jobs->mutex);
+}
@@ -0,0 +1,75 @@
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include "thread.h"
+
+/*
+ Splits loops across worker threads.
+
+ Each thread has a queue of jobs. A thread takes the newest job from its own queue
+ and steals the oldest from the others when it runs dry. The calling thread works
+ alongside the workers until the loop is done, so parallel phases are synchronous.
+ Jobs must not start other jobs.
+ */
+
+#define JOB_THREADS_MAX 16
+#define JOB_QUEUE_MAX 64
+
+/* runs the loop body for indices first to first + count - 1 */
+typedef void (*JobFunc)(void* data, int first, int count);
+
+typedef struct
+{
+    JobFunc func;
+    void* data;
+    int first;
+    int count;
+} Job;
+
+typedef struct
+{
+    Mutex mutex;
+    Job jobs[JOB_QUEUE_MAX];
+    
+    /* others steal from head, the owner takes from tail */
+    int head;
+    int tail;
+} JobQueue;
+
+struct JobSystem;
+
+typedef struct
+{
+    struct JobSystem* system;
+    Thread thread;
+    int index;
+} JobWorker;
+
+typedef struct JobSystem
+{
+    /* includes the calling thread, which owns queue 0 */
+    int threadCount;
+    
+    JobQueue queues[JOB_THREADS_MAX];
+    JobWorker workers[JOB_THREADS_MAX];
+    
+    Mutex mutex;
+    Cond wake;
+    Cond done;
+    
+    /* jobs waiting in queues, and jobs not yet finished */
+    int queued;
+    int pending;
+    
+    int running;
+} JobSystem;
+
+/* threadCount includes the calling thread. 1 or less runs every loop inline */
+extern int JobSystem_Init(JobSystem* jobs, int threadCount);
+extern void JobSystem_Shutdown(JobSystem* jobs);
+
+/* calls func over [0, count) in batches of at least batchSize and returns once all have run */
+extern void JobSystem_ParallelFor(JobSystem* jobs, JobFunc func, void* data, int count, int batchSize);
+
+#endif
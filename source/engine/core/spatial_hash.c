@@ -0,0 +1,313 @@
+
+#include "spatial_hash.h"
+#include <stdlib.h>
+#include <string.h>
+
+int SpatialHash_Init(SpatialHash* hash, int itemCapacity, float cellSize, int bucketCount)
+{
+    /* round up to a power of 2 for masking */
+    int buckets = 1;
+    while (buckets < bucketCount)
+        buckets *= 2;
+    
+    hash->cellSize = cellSize;
+    hash->bucketCount = buckets;
+    hash->itemCapacity = itemCapacity;
+    
+    hash->buckets = malloc(sizeof(int) * buckets);
+    hash->items = malloc(sizeof(SpatialItem) * itemCapacity);
+    hash->activeItems = malloc(sizeof(int) * itemCapacity);
+    
+    hash->entries = NULL;
+    hash->entryCapacity = 0;
+    
+    hash->pairs = NULL;
+    hash->pairCount = 0;
+    hash->pairCapacity = 0;
+    
+    if (!hash->buckets || !hash->items || !hash->activeItems)
+        return 0;
+    
+    SpatialHash_Clear(hash);
+    return 1;
+}
+
+void SpatialHash_Shutdown(SpatialHash* hash)
+{
+    free(hash->buckets);
+    free(hash->items);
+    free(hash->activeItems);
+    free(hash->entries);
+    free(hash->pairs);
+    
+    hash->buckets = NULL;
+    hash->items = NULL;
+    hash->activeItems = NULL;
+    hash->entries = NULL;
+    hash->pairs = NULL;
+}
+
+void SpatialHash_Clear(SpatialHash* hash)
+{
+    for (int i = 0; i < hash->bucketCount; ++i)
+        hash->buckets[i] = -1;
+    
+    for (int i = 0; i < hash->itemCapacity; ++i)
+    {
+        hash->items[i].active = 0;
+        hash->items[i].oversize = 0;
+        hash->items[i].firstEntry = -1;
+    }
+    
+    hash->activeCount = 0;
+    hash->entryCount = 0;
+    hash->freeEntry = -1;
+    hash->pairCount = 0;
+}
+
+static int SpatialHash_Bucket(const SpatialHash* hash, const int* cell)
+{
+    unsigned int h = (unsigned int)cell[0] * 73856093u ^ (unsigned int)cell[1] * 19349663u ^ (unsigned int)cell[2] * 83492791u;
+    return h & (hash->bucketCount - 1);
+}
+
+static void SpatialHash_CellRange(const SpatialHash* hash, AABB bounds, int* cellMin, int* cellMax)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        cellMin[i] = (int)floorf(Vec3_Get(bounds.min, i) / hash->cellSize);
+        cellMax[i] = (int)floorf(Vec3_Get(bounds.max, i) / hash->cellSize);
+    }
+}
+
+static int SpatialHash_NewEntry(SpatialHash* hash)
+{
+    if (hash->freeEntry != -1)
+    {
+        int entry = hash->freeEntry;
+        hash->freeEntry = hash->entries[entry].next;
+        return entry;
+    }
+    
+    if (hash->entryCount == hash->entryCapacity)
+    {
+        int capacity = hash->entryCapacity ? hash->entryCapacity * 2 : 256;
+        SpatialEntry* entries = realloc(hash->entries, sizeof(SpatialEntry) * capacity);
+        
+        if (!entries)
+            return -1;
+        
+        hash->entries = entries;
+        hash->entryCapacity = capacity;
+    }
+    
+    return hash->entryCount++;
+}
+
+static void SpatialHash_Unlink(SpatialHash* hash, int item)
+{
+    SpatialItem* it = hash->items + item;
+    int e = it->firstEntry;
+    
+    while (e != -1)
+    {
+        SpatialEntry* entry = hash->entries + e;
+        
+        if (entry->prev != -1)
+            hash->entries[entry->prev].next = entry->next;
+        else
+            hash->buckets[SpatialHash_Bucket(hash, entry->cell)] = entry->next;
+        
+        if (entry->next != -1)
+            hash->entries[entry->next].prev = entry->prev;
+        
+        int itemNext = entry->itemNext;
+        
+        entry->next = hash->freeEntry;
+        hash->freeEntry = e;
+        
+        e = itemNext;
+    }
+    
+    it->firstEntry = -1;
+}
+
+static void SpatialHash_Link(SpatialHash* hash, int item)
+{
+    SpatialItem* it = hash->items + item;
+    int cell[3];
+    
+    for (cell[2] = it->cellMin[2]; cell[2] <= it->cellMax[2]; ++cell[2])
+    {
+        for (cell[1] = it->cellMin[1]; cell[1] <= it->cellMax[1]; ++cell[1])
+        {
+            for (cell[0] = it->cellMin[0]; cell[0] <= it->cellMax[0]; ++cell[0])
+            {
+                int e = SpatialHash_NewEntry(hash);
+                
+                if (e == -1)
+                    return;
+                
+                SpatialEntry* entry = hash->entries + e;
+                int bucket = SpatialHash_Bucket(hash, cell);
+                
+                entry->item = item;
+                memcpy(entry->cell, cell, sizeof(cell));
+                
+                entry->prev = -1;
+                entry->next = hash->buckets[bucket];
+                
+                if (entry->next != -1)
+                    hash->entries[entry->next].prev = e;
+                
+                hash->buckets[bucket] = e;
+                
+                entry->itemNext = it->firstEntry;
+                it->firstEntry = e;
+            }
+        }
+    }
+}
+
+void SpatialHash_Update(SpatialHash* hash, int item, AABB bounds)
+{
+    SpatialItem* it = hash->items + item;
+    
+    int cellMin[3];
+    int cellMax[3];
+    SpatialHash_CellRange(hash, bounds, cellMin, cellMax);
+    
+    it->bounds = bounds;
+    
+    if (it->active && memcmp(cellMin, it->cellMin, sizeof(cellMin)) == 0 && memcmp(cellMax, it->cellMax, sizeof(cellMax)) == 0)
+        return;
+    
+    SpatialHash_Unlink(hash, item);
+    
+    memcpy(it->cellMin, cellMin, sizeof(cellMin));
+    memcpy(it->cellMax, cellMax, sizeof(cellMax));
+    
+    if (!it->active)
+    {
+        it->active = 1;
+        it->activePosition = hash->activeCount;
+        hash->activeItems[hash->activeCount++] = item;
+    }
+    
+    /* the range is computed in floats so huge bounds don't overflow the count */
+    float cellCount = 1.0f;
+    for (int i = 0; i < 3; ++i)
+        cellCount *= (float)cellMax[i] - (float)cellMin[i] + 1.0f;
+    
+    it->oversize = (cellCount > SPATIAL_HASH_ITEM_CELLS_MAX);
+    
+    if (!it->oversize)
+        SpatialHash_Link(hash, item);
+}
+
+void SpatialHash_Remove(SpatialHash* hash, int item)
+{
+    SpatialItem* it = hash->items + item;
+    
+    if (!it->active)
+        return;
+    
+    SpatialHash_Unlink(hash, item);
+    
+    /* the last active item fills the gap */
+    int last = hash->activeItems[--hash->activeCount];
+    hash->activeItems[it->activePosition] = last;
+    hash->items[last].activePosition = it->activePosition;
+    
+    it->active = 0;
+    it->oversize = 0;
+}
+
+static void SpatialHash_AddPair(SpatialHash* hash, int a, int b)
+{
+    if (hash->pairCount == hash->pairCapacity)
+    {
+        int capacity = hash->pairCapacity ? hash->pairCapacity * 2 : 64;
+        SpatialPair* pairs = realloc(hash->pairs, sizeof(SpatialPair) * capacity);
+        
+        if (!pairs)
+            return;
+        
+        hash->pairs = pairs;
+        hash->pairCapacity = capacity;
+    }
+    
+    SpatialPair* pair = hash->pairs + hash->pairCount++;
+    pair->a = MIN(a, b);
+    pair->b = MAX(a, b);
+}
+
+static int SpatialPair_Compare(const void* a, const void* b)
+{
+    const SpatialPair* pa = a;
+    const SpatialPair* pb = b;
+    
+    if (pa->a != pb->a)
+        return pa->a - pb->a;
+    
+    return pa->b - pb->b;
+}
+
+int SpatialHash_FindPairs(SpatialHash* hash)
+{
+    hash->pairCount = 0;
+    
+    for (int k = 0; k < hash->activeCount; ++k)
+    {
+        int i = hash->activeItems[k];
+        const SpatialItem* it = hash->items + i;
+        
+        if (it->oversize)
+        {
+            for (int n = 0; n < hash->activeCount; ++n)
+            {
+                int j = hash->activeItems[n];
+                const SpatialItem* other = hash->items + j;
+                
+                /* two oversize items meet once */
+                if (j == i || (other->oversize && j < i))
+                    continue;
+                
+                if (AABB_IntersectsAABB(it->bounds, other->bounds))
+                    SpatialHash_AddPair(hash, i, j);
+            }
+            
+            continue;
+        }
+        
+        for (int e = it->firstEntry; e != -1; e = hash->entries[e].itemNext)
+        {
+            const int* cell = hash->entries[e].cell;
+            
+            for (int o = hash->buckets[SpatialHash_Bucket(hash, cell)]; o != -1; o = hash->entries[o].next)
+            {
+                const SpatialEntry* entry = hash->entries + o;
+                
+                /* other cells can share the bucket */
+                if (entry->item <= i || memcmp(entry->cell, cell, sizeof(entry->cell)) != 0)
+                    continue;
+                
+                const SpatialItem* other = hash->items + entry->item;
+                
+                /* items sharing several cells are reported from the first one only */
+                if (cell[0] != MAX(it->cellMin[0], other->cellMin[0]) ||
+                    cell[1] != MAX(it->cellMin[1], other->cellMin[1]) ||
+                    cell[2] != MAX(it->cellMin[2], other->cellMin[2]))
+                    continue;
+                
+                if (AABB_IntersectsAABB(it->bounds, other->bounds))
+                    SpatialHash_AddPair(hash, i, entry->item);
+            }
+        }
+    }
+    
+    /* callbacks see pairs in the same order as a brute force loop would give them */
+    qsort(hash->pairs, hash->pairCount, sizeof(SpatialPair), SpatialPair_Compare);
+    
+    return hash->pairCount;
+}
@@ -0,0 +1,88 @@
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include "geo_math.h"
+
+/*
+ Uniform grid broadphase for overlapping bounds.
+
+ Grid cells are hashed into a fixed table of buckets, so the world needs no extent.
+ Items keep their cells between updates and are only relinked when their bounds cross
+ into different cells, so items which stay put or move a little cost almost nothing.
+ Items covering more than SPATIAL_HASH_ITEM_CELLS_MAX cells are kept aside and tested against everything.
+ */
+
+#define SPATIAL_HASH_ITEM_CELLS_MAX 64
+
+typedef struct
+{
+    int a;
+    int b;
+} SpatialPair;
+
+typedef struct
+{
+    int item;
+    int cell[3];
+    
+    /* links in the bucket's list, and to the item's next entry */
+    int prev;
+    int next;
+    int itemNext;
+} SpatialEntry;
+
+typedef struct
+{
+    AABB bounds;
+    int cellMin[3];
+    int cellMax[3];
+    
+    int firstEntry;
+    int active;
+    int oversize;
+    
+    /* position in activeItems */
+    int activePosition;
+} SpatialItem;
+
+typedef struct
+{
+    float cellSize;
+    
+    /* power of 2 */
+    int bucketCount;
+    int* buckets;
+    
+    int itemCapacity;
+    SpatialItem* items;
+    
+    /* packed indices of active items, so finding pairs doesn't visit empty slots */
+    int activeCount;
+    int* activeItems;
+    
+    SpatialEntry* entries;
+    int entryCount;
+    int entryCapacity;
+    int freeEntry;
+    
+    /* filled by SpatialHash_FindPairs */
+    SpatialPair* pairs;
+    int pairCount;
+    int pairCapacity;
+} SpatialHash;
+
+extern int SpatialHash_Init(SpatialHash* hash, int itemCapacity, float cellSize, int bucketCount);
+extern void SpatialHash_Shutdown(SpatialHash* hash);
+
+/* removes every item */
+extern void SpatialHash_Clear(SpatialHash* hash);
+
+/* inserts the item, or moves it if it's already in */
+extern void SpatialHash_Update(SpatialHash* hash, int item, AABB bounds);
+extern void SpatialHash_Remove(SpatialHash* hash, int item);
+
+/* fills pairs with every pair of items whose bounds intersect, a < b, sorted by a then b. Returns pairCount */
+extern int SpatialHash_FindPairs(SpatialHash* hash);
+
+#endif
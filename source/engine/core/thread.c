@@ -0,0 +1,57 @@
+
+#include "thread.h"
+
+int Thread_Start(Thread* thread, ThreadFunc func, void* arg)
+{
+    return pthread_create(thread, NULL, func, arg) == 0;
+}
+
+void Thread_Join(Thread* thread)
+{
+    pthread_join(*thread, NULL);
+}
+
+void Mutex_Init(Mutex* mutex)
+{
+    pthread_mutex_init(mutex, NULL);
+}
+
+void Mutex_Shutdown(Mutex* mutex)
+{
+    pthread_mutex_destroy(mutex);
+}
+
+void Mutex_Lock(Mutex* mutex)
+{
+    pthread_mutex_lock(mutex);
+}
+
+void Mutex_Unlock(Mutex* mutex)
+{
+    pthread_mutex_unlock(mutex);
+}
+
+void Cond_Init(Cond* cond)
+{
+    pthread_cond_init(cond, NULL);
+}
+
+void Cond_Shutdown(Cond* cond)
+{
+    pthread_cond_destroy(cond);
+}
+
+void Cond_Wait(Cond* cond, Mutex* mutex)
+{
+    pthread_cond_wait(cond, mutex);
+}
+
+void Cond_Signal(Cond* cond)
+{
+    pthread_cond_signal(cond);
+}
+
+void Cond_Broadcast(Cond* cond)
+{
+    pthread_cond_broadcast(cond);
+}
@@ -0,0 +1,29 @@
+
+#ifndef THREAD_H
+#define THREAD_H
+
+#include <pthread.h>
+
+/* thin wrappers so engine code doesn't depend on the threading library */
+
+typedef pthread_t Thread;
+typedef pthread_mutex_t Mutex;
+typedef pthread_cond_t Cond;
+
+typedef void* (*ThreadFunc)(void* arg);
+
+extern int Thread_Start(Thread* thread, ThreadFunc func, void* arg);
+extern void Thread_Join(Thread* thread);
+
+extern void Mutex_Init(Mutex* mutex);
+extern void Mutex_Shutdown(Mutex* mutex);
+extern void Mutex_Lock(Mutex* mutex);
+extern void Mutex_Unlock(Mutex* mutex);
+
+extern void Cond_Init(Cond* cond);
+extern void Cond_Shutdown(Cond* cond);
+extern void Cond_Wait(Cond* cond, Mutex* mutex);
+extern void Cond_Signal(Cond* cond);
+extern void Cond_Broadcast(Cond* cond);
+
+#endif
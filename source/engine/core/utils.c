@@ -2,6 +2,7 @@
 #include "utils.h"
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
 
 const int g_endian = 1;
 
@@ -109,3 +110,26 @@ unsigned long String_Hash(const char* string)
     
     return hash;
 }
+
+FILE* File_OpenMemory(const void* data, size_t size)
+{
+#if defined(_WIN32)
+    return NULL;
+#else
+    /* fmemopen does not write through "r" streams, so the cast is safe */
+    return fmemopen((void*)data, size, "rb");
+#endif
+}
+
+const void* End_LittleInPlace(const void* base, long offset, size_t align)
+{
+    if (!base || End_IsBig())
+        return NULL;
+    
+    const unsigned char* p = (const unsigned char*)base + offset;
+    
+    if ((uintptr_t)p % align != 0)
+        return NULL;
+    
+    return p;
+}
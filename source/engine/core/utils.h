@@ -22,6 +22,9 @@ extern int String_Prefix(const char* str, const char* pre, size_t maxSize);
 
 extern unsigned long String_Hash(const char* string);
 
+/* read only stream over memory for the FILE* based loaders, NULL on Windows. close with fclose */
+extern FILE* File_OpenMemory(const void* data, size_t size);
+
 
 extern const int g_endian;
 
@@ -35,4 +38,8 @@ extern const int g_endian;
 #define End_ReadBig16(x) End_IsBig() ? x : End_Swap16(x)
 #define End_ReadBig32(x) End_IsBig() ? x : End_Swap32(x)
 
+/* base + offset when the little endian data there can be used in place: base is set,
+ the host is little endian and the address is aligned. NULL to read a copy instead */
+extern const void* End_LittleInPlace(const void* base, long offset, size_t align);
+
 #endif
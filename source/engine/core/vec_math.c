@@ -6,6 +6,40 @@
 #endif // __APPLE__
 
 
+Vec2 Vec3_OctEncode(Vec3 n)
+{
+    float l1 = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+    
+    if (l1 == 0.0f)
+        return Vec2_Create(0.0f, 0.0f);
+    
+    Vec2 e = Vec2_Create(n.x / l1, n.y / l1);
+    
+    /* the lower hemisphere folds over the diagonals */
+    if (n.z < 0.0f)
+    {
+        Vec2 folded;
+        folded.x = (1.0f - fabsf(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f);
+        folded.y = (1.0f - fabsf(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f);
+        e = folded;
+    }
+    
+    return e;
+}
+
+Vec3 Vec2_OctDecode(Vec2 e)
+{
+    Vec3 n = Vec3_Create(e.x, e.y, 1.0f - fabsf(e.x) - fabsf(e.y));
+    
+    if (n.z < 0.0f)
+    {
+        n.x = (1.0f - fabsf(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f);
+        n.y = (1.0f - fabsf(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    
+    return Vec3_Norm(n);
+}
+
 Mat4 Mat4_CreateIdentity()
 {
     Mat4 m;
@@ -399,6 +433,20 @@ Quat Quat_Slerp(Quat q0, Quat q1, float t)
     return  Quat_Add(q0, q1);
 }
 
+float Quat_Angle(Quat q0, Quat q1)
+{
+    q0 = Quat_Norm(q0);
+    q1 = Quat_Norm(q1);
+    
+    if (Quat_Dot(q0, q1) < 0.0f)
+        q1 = Quat_Scale(q1, -1.0f);
+    
+    /* acos of the dot is too coarse near 0, the chord lengths give theta / 4 */
+    Quat d = Quat_Sub(q0, q1);
+    Quat s = Quat_Add(q0, q1);
+    return 4.0f * atan2f(sqrtf(Quat_Dot(d, d)), sqrtf(Quat_Dot(s, s)));
+}
+
 void Quat_ToMatrix(Quat a, Mat4* dest)
 {
     float x2 = 2.0f * a.x,  y2 = 2.0f * a.y,  z2 = 2.0f * a.z;
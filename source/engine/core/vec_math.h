@@ -296,6 +296,11 @@ static inline Vec3 Vec3_Lerp(Vec3 v0, Vec3 v1, float t)
     return r;
 }
 
+/* octahedral mapping of a unit vector onto the [-1, 1] square, for packing normals in two components.
+ http://jcgt.org/published/0003/02/01/ */
+extern Vec2 Vec3_OctEncode(Vec3 n);
+extern Vec3 Vec2_OctDecode(Vec2 e);
+
 static const Vec4 Vec4_Zero = {0.0f, 0.0f, 0.0f, 0.0f};
 
 static inline Vec4 Vec4_Create(float x, float y, float z, float w)
@@ -408,6 +413,7 @@ static inline float Quat_Dot(Quat q0, Quat q1)
     return q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w;
 }
 
+/* the conjugate, the inverse of a unit quaternion. Use Quat_Scale(q, -1.0f) for the same rotation with the other sign */
 static inline Quat Quat_Negate(Quat q)
 {
     Quat r;
@@ -435,6 +441,9 @@ extern void Quat_ToMatrix( Quat a, Mat4* dest);
 extern Quat Quat_Norm(Quat q);
 extern Quat Quat_Slerp(Quat q0, Quat q1, float t);
 
+/* angle in radians of the rotation between q0 and q1, either sign of each */
+extern float Quat_Angle(Quat q0, Quat q1);
+
 
 
 #endif
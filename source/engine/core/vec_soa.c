@@ -0,0 +1,222 @@
+
+#include "vec_soa.h"
+
+#if VEC_SOA_SSE
+#include <emmintrin.h>
+#elif VEC_SOA_NEON
+#include <arm_neon.h>
+#endif
+
+/* SoaF is one lane group. Each backend provides the same handful of operations */
+
+#if VEC_SOA_SSE
+
+typedef __m128 SoaF;
+
+static inline SoaF SoaF_Load(const float* p) { return _mm_loadu_ps(p); }
+static inline void SoaF_Store(float* p, SoaF a) { _mm_storeu_ps(p, a); }
+static inline SoaF SoaF_Set(float x) { return _mm_set1_ps(x); }
+static inline SoaF SoaF_Add(SoaF a, SoaF b) { return _mm_add_ps(a, b); }
+static inline SoaF SoaF_Sub(SoaF a, SoaF b) { return _mm_sub_ps(a, b); }
+static inline SoaF SoaF_Mul(SoaF a, SoaF b) { return _mm_mul_ps(a, b); }
+static inline SoaF SoaF_Div(SoaF a, SoaF b) { return _mm_div_ps(a, b); }
+static inline SoaF SoaF_Sqrt(SoaF a) { return _mm_sqrt_ps(a); }
+static inline SoaF SoaF_SignBit(SoaF a) { return _mm_and_ps(a, _mm_set1_ps(-0.0f)); }
+static inline SoaF SoaF_Xor(SoaF a, SoaF b) { return _mm_xor_ps(a, b); }
+
+#elif VEC_SOA_NEON
+
+typedef float32x4_t SoaF;
+
+static inline SoaF SoaF_Load(const float* p) { return vld1q_f32(p); }
+static inline void SoaF_Store(float* p, SoaF a) { vst1q_f32(p, a); }
+static inline SoaF SoaF_Set(float x) { return vdupq_n_f32(x); }
+static inline SoaF SoaF_Add(SoaF a, SoaF b) { return vaddq_f32(a, b); }
+static inline SoaF SoaF_Sub(SoaF a, SoaF b) { return vsubq_f32(a, b); }
+static inline SoaF SoaF_Mul(SoaF a, SoaF b) { return vmulq_f32(a, b); }
+static inline SoaF SoaF_Div(SoaF a, SoaF b) { return vdivq_f32(a, b); }
+static inline SoaF SoaF_Sqrt(SoaF a) { return vsqrtq_f32(a); }
+
+static inline SoaF SoaF_SignBit(SoaF a)
+{
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vdupq_n_u32(0x80000000)));
+}
+
+static inline SoaF SoaF_Xor(SoaF a, SoaF b)
+{
+    return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+}
+
+#else
+
+typedef struct
+{
+    float v[VEC_SOA_WIDTH];
+} SoaF;
+
+#define SOA_F_LANES(expr) SoaF r; for (int i = 0; i < VEC_SOA_WIDTH; ++i) { r.v[i] = (expr); } return r;
+
+static inline SoaF SoaF_Load(const float* p) { SOA_F_LANES(p[i]) }
+static inline void SoaF_Store(float* p, SoaF a) { for (int i = 0; i < VEC_SOA_WIDTH; ++i) p[i] = a.v[i]; }
+static inline SoaF SoaF_Set(float x) { SOA_F_LANES(x) }
+static inline SoaF SoaF_Add(SoaF a, SoaF b) { SOA_F_LANES(a.v[i] + b.v[i]) }
+static inline SoaF SoaF_Sub(SoaF a, SoaF b) { SOA_F_LANES(a.v[i] - b.v[i]) }
+static inline SoaF SoaF_Mul(SoaF a, SoaF b) { SOA_F_LANES(a.v[i] * b.v[i]) }
+static inline SoaF SoaF_Div(SoaF a, SoaF b) { SOA_F_LANES(a.v[i] / b.v[i]) }
+static inline SoaF SoaF_Sqrt(SoaF a) { SOA_F_LANES(sqrtf(a.v[i])) }
+
+/* sign handling only needs the sign as a +-1 factor here, rather than the bit */
+static inline SoaF SoaF_SignBit(SoaF a) { SOA_F_LANES(a.v[i] < 0.0f ? -1.0f : 1.0f) }
+static inline SoaF SoaF_Xor(SoaF a, SoaF sign) { SOA_F_LANES(a.v[i] * sign.v[i]) }
+
+#endif
+
+/* Eberly's coefficients, 8 terms for float precision */
+#define SLERP_TERMS 8
+#define SLERP_ONE_PLUS_MU 1.90110745351730037f
+
+/* u[i] = 1 / (i (2i + 1)) and v[i] = i / (2i + 1), the last term absorbs the error of truncating the series.
+ Constant so the kernels can run on any thread */
+static const float kSlerpU[SLERP_TERMS] =
+{
+    1.0f / 3.0f, 1.0f / 10.0f, 1.0f / 21.0f, 1.0f / 36.0f,
+    1.0f / 55.0f, 1.0f / 78.0f, 1.0f / 105.0f, SLERP_ONE_PLUS_MU / 136.0f
+};
+
+static const float kSlerpV[SLERP_TERMS] =
+{
+    1.0f / 3.0f, 2.0f / 5.0f, 3.0f / 7.0f, 4.0f / 9.0f,
+    5.0f / 11.0f, 6.0f / 13.0f, 7.0f / 15.0f, SLERP_ONE_PLUS_MU * 8.0f / 17.0f
+};
+
+/* per term factors for a fixed t. The series is sin(t theta) / sin(theta) in powers of cos(theta) - 1 */
+static void Slerp_Factors(float t, float* factors)
+{
+    float tSq = t * t;
+    
+    for (int i = 0; i < SLERP_TERMS; ++i)
+        factors[i] = kSlerpU[i] * tSq - kSlerpV[i];
+}
+
+void QuatSoA_Slerp(QuatSoA dest, QuatSoA from, QuatSoA to, float t, int count)
+{
+    float factorsT[SLERP_TERMS];
+    float factorsD[SLERP_TERMS];
+    
+    Slerp_Factors(t, factorsT);
+    Slerp_Factors(1.0f - t, factorsD);
+    
+    SoaF fT[SLERP_TERMS];
+    SoaF fD[SLERP_TERMS];
+    
+    for (int i = 0; i < SLERP_TERMS; ++i)
+    {
+        fT[i] = SoaF_Set(factorsT[i]);
+        fD[i] = SoaF_Set(factorsD[i]);
+    }
+    
+    const SoaF one = SoaF_Set(1.0f);
+    const SoaF scaleT = SoaF_Set(t);
+    const SoaF scaleD = SoaF_Set(1.0f - t);
+    
+    for (int i = 0; i < count; i += VEC_SOA_WIDTH)
+    {
+        SoaF ax = SoaF_Load(from.x + i);
+        SoaF ay = SoaF_Load(from.y + i);
+        SoaF az = SoaF_Load(from.z + i);
+        SoaF aw = SoaF_Load(from.w + i);
+        
+        SoaF bx = SoaF_Load(to.x + i);
+        SoaF by = SoaF_Load(to.y + i);
+        SoaF bz = SoaF_Load(to.z + i);
+        SoaF bw = SoaF_Load(to.w + i);
+        
+        SoaF cosTheta = SoaF_Add(SoaF_Add(SoaF_Mul(ax, bx), SoaF_Mul(ay, by)),
+                                 SoaF_Add(SoaF_Mul(az, bz), SoaF_Mul(aw, bw)));
+        
+        /* shortest path: slerp with |cos| and flip the sign of to's weight */
+        SoaF sign = SoaF_SignBit(cosTheta);
+        SoaF xm1 = SoaF_Sub(SoaF_Xor(cosTheta, sign), one);
+        
+        SoaF wT = one;
+        SoaF wD = one;
+        
+        for (int k = SLERP_TERMS - 1; k >= 0; --k)
+        {
+            wT = SoaF_Add(one, SoaF_Mul(SoaF_Mul(fT[k], xm1), wT));
+            wD = SoaF_Add(one, SoaF_Mul(SoaF_Mul(fD[k], xm1), wD));
+        }
+        
+        wT = SoaF_Xor(SoaF_Mul(scaleT, wT), sign);
+        wD = SoaF_Mul(scaleD, wD);
+        
+        SoaF x = SoaF_Add(SoaF_Mul(ax, wD), SoaF_Mul(bx, wT));
+        SoaF y = SoaF_Add(SoaF_Mul(ay, wD), SoaF_Mul(by, wT));
+        SoaF z = SoaF_Add(SoaF_Mul(az, wD), SoaF_Mul(bz, wT));
+        SoaF w = SoaF_Add(SoaF_Mul(aw, wD), SoaF_Mul(bw, wT));
+        
+        SoaF length = SoaF_Sqrt(SoaF_Add(SoaF_Add(SoaF_Mul(x, x), SoaF_Mul(y, y)),
+                                         SoaF_Add(SoaF_Mul(z, z), SoaF_Mul(w, w))));
+        
+        SoaF_Store(dest.x + i, SoaF_Div(x, length));
+        SoaF_Store(dest.y + i, SoaF_Div(y, length));
+        SoaF_Store(dest.z + i, SoaF_Div(z, length));
+        SoaF_Store(dest.w + i, SoaF_Div(w, length));
+    }
+}
+
+void QuatSoA_Mult(QuatSoA dest, QuatSoA a, QuatSoA b, int count)
+{
+    for (int i = 0; i < count; i += VEC_SOA_WIDTH)
+    {
+        SoaF ax = SoaF_Load(a.x + i);
+        SoaF ay = SoaF_Load(a.y + i);
+        SoaF az = SoaF_Load(a.z + i);
+        SoaF aw = SoaF_Load(a.w + i);
+        
+        SoaF bx = SoaF_Load(b.x + i);
+        SoaF by = SoaF_Load(b.y + i);
+        SoaF bz = SoaF_Load(b.z + i);
+        SoaF bw = SoaF_Load(b.w + i);
+        
+        SoaF x = SoaF_Sub(SoaF_Add(SoaF_Add(SoaF_Mul(aw, bx), SoaF_Mul(ax, bw)), SoaF_Mul(ay, bz)), SoaF_Mul(az, by));
+        SoaF y = SoaF_Sub(SoaF_Add(SoaF_Add(SoaF_Mul(aw, by), SoaF_Mul(ay, bw)), SoaF_Mul(az, bx)), SoaF_Mul(ax, bz));
+        SoaF z = SoaF_Sub(SoaF_Add(SoaF_Add(SoaF_Mul(aw, bz), SoaF_Mul(az, bw)), SoaF_Mul(ax, by)), SoaF_Mul(ay, bx));
+        SoaF w = SoaF_Sub(SoaF_Sub(SoaF_Sub(SoaF_Mul(aw, bw), SoaF_Mul(ax, bx)), SoaF_Mul(ay, by)), SoaF_Mul(az, bz));
+        
+        SoaF_Store(dest.x + i, x);
+        SoaF_Store(dest.y + i, y);
+        SoaF_Store(dest.z + i, z);
+        SoaF_Store(dest.w + i, w);
+    }
+}
+
+void QuatSoA_Transform(Vec3SoA dest, QuatSoA q, Vec3SoA v, Vec3SoA offset, int count)
+{
+    const SoaF two = SoaF_Set(2.0f);
+    
+    for (int i = 0; i < count; i += VEC_SOA_WIDTH)
+    {
+        SoaF qx = SoaF_Load(q.x + i);
+        SoaF qy = SoaF_Load(q.y + i);
+        SoaF qz = SoaF_Load(q.z + i);
+        SoaF qw = SoaF_Load(q.w + i);
+        
+        SoaF vx = SoaF_Load(v.x + i);
+        SoaF vy = SoaF_Load(v.y + i);
+        SoaF vz = SoaF_Load(v.z + i);
+        
+        /* t = 2 cross(q.xyz, v), r = v + t q.w + cross(q.xyz, t) */
+        SoaF tx = SoaF_Mul(two, SoaF_Sub(SoaF_Mul(qy, vz), SoaF_Mul(qz, vy)));
+        SoaF ty = SoaF_Mul(two, SoaF_Sub(SoaF_Mul(qz, vx), SoaF_Mul(qx, vz)));
+        SoaF tz = SoaF_Mul(two, SoaF_Sub(SoaF_Mul(qx, vy), SoaF_Mul(qy, vx)));
+        
+        SoaF rx = SoaF_Add(SoaF_Add(vx, SoaF_Mul(tx, qw)), SoaF_Sub(SoaF_Mul(qy, tz), SoaF_Mul(qz, ty)));
+        SoaF ry = SoaF_Add(SoaF_Add(vy, SoaF_Mul(ty, qw)), SoaF_Sub(SoaF_Mul(qz, tx), SoaF_Mul(qx, tz)));
+        SoaF rz = SoaF_Add(SoaF_Add(vz, SoaF_Mul(tz, qw)), SoaF_Sub(SoaF_Mul(qx, ty), SoaF_Mul(qy, tx)));
+        
+        SoaF_Store(dest.x + i, SoaF_Add(rx, SoaF_Load(offset.x + i)));
+        SoaF_Store(dest.y + i, SoaF_Add(ry, SoaF_Load(offset.y + i)));
+        SoaF_Store(dest.z + i, SoaF_Add(rz, SoaF_Load(offset.z + i)));
+    }
+}
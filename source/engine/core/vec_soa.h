@@ -0,0 +1,89 @@
+
+#ifndef VEC_SOA_H
+#define VEC_SOA_H
+
+#include "vec_math.h"
+
+/*
+ Quaternion math over structure of arrays, so a batch of joints is posed a few lanes per instruction.
+ The kernels are picked at compile time: SSE on x86, NEON on 64 bit ARM, otherwise a scalar loop.
+ Define VEC_SOA_SCALAR to force the scalar loop.
+ */
+
+#if !defined(VEC_SOA_SCALAR) && (defined(__SSE2__) || defined(_M_X64))
+#define VEC_SOA_SSE 1
+#elif !defined(VEC_SOA_SCALAR) && defined(__ARM_NEON) && defined(__aarch64__)
+#define VEC_SOA_NEON 1
+#endif
+
+/* lanes per step. The scalar loop keeps the same width so padding doesn't depend on the platform */
+#define VEC_SOA_WIDTH 4
+
+/* arrays passed to the kernels must have room for the count rounded up to the width */
+#define VEC_SOA_PAD(count) (((count) + VEC_SOA_WIDTH - 1) & ~(VEC_SOA_WIDTH - 1))
+
+typedef struct
+{
+    float* x;
+    float* y;
+    float* z;
+    float* w;
+} QuatSoA;
+
+typedef struct
+{
+    float* x;
+    float* y;
+    float* z;
+} Vec3SoA;
+
+/* views consecutive arrays of stride floats, starting at base */
+static inline QuatSoA QuatSoA_Arrays(float* base, int stride)
+{
+    QuatSoA q;
+    q.x = base; q.y = base + stride; q.z = base + stride * 2; q.w = base + stride * 3;
+    return q;
+}
+
+static inline Vec3SoA Vec3SoA_Arrays(float* base, int stride)
+{
+    Vec3SoA v;
+    v.x = base; v.y = base + stride; v.z = base + stride * 2;
+    return v;
+}
+
+static inline void QuatSoA_Set(QuatSoA dest, int i, Quat q)
+{
+    dest.x[i] = q.x; dest.y[i] = q.y; dest.z[i] = q.z; dest.w[i] = q.w;
+}
+
+static inline Quat QuatSoA_Get(QuatSoA q, int i)
+{
+    Quat r;
+    r.x = q.x[i]; r.y = q.y[i]; r.z = q.z[i]; r.w = q.w[i];
+    return r;
+}
+
+static inline void Vec3SoA_Set(Vec3SoA dest, int i, Vec3 v)
+{
+    dest.x[i] = v.x; dest.y[i] = v.y; dest.z[i] = v.z;
+}
+
+static inline Vec3 Vec3SoA_Get(Vec3SoA v, int i)
+{
+    return Vec3_Create(v.x[i], v.y[i], v.z[i]);
+}
+
+/*
+ shortest path slerp, normalized. Uses Eberly's polynomial form rather than acos and sin.
+ "A Fast and Accurate Algorithm for Computing SLERP" https://www.geometrictools.com/Documentation/FastAndAccurateSlerp.pdf
+ */
+extern void QuatSoA_Slerp(QuatSoA dest, QuatSoA from, QuatSoA to, float t, int count);
+
+/* dest = a * b, as Quat_Mult */
+extern void QuatSoA_Mult(QuatSoA dest, QuatSoA a, QuatSoA b, int count);
+
+/* dest = q rotating v, plus offset. As Quat_MultVec3 */
+extern void QuatSoA_Transform(Vec3SoA dest, QuatSoA q, Vec3SoA v, Vec3SoA offset, int count);
+
+#endif
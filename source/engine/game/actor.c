@@ -16,31 +16,36 @@ void Actor_Init(Actor* actor)
     memset(actor->name, 0, sizeof(char) * SCENE_ELEMENT_NAME_MAX);
     memset(actor->eventName, 0, sizeof(char) * SCRIPT_ID_NAME_MAX);
     
-    actor->dead = 1;
+    *actor->dead = 1;
     
-    actor->type = kActorEmpty;
-    actor->renderType = kActorRenderNone;
+    *actor->type = kActorEmpty;
+    *actor->renderType = kActorRenderNone;
 
-    NavPath_Init(&actor->path);
+    NavPath_Init(actor->path);
     
-    actor->position = Vec3_Zero;
-    actor->rotation = Quat_Identity;
-    actor->bounds = AABB_CreateCentered(Vec3_Zero, Vec3_Create(1.0f, 1.0f, 1.0f));
+    *actor->position = Vec3_Zero;
+    *actor->rotation = Quat_Identity;
+    *actor->bounds = AABB_CreateCentered(Vec3_Zero, Vec3_Create(1.0f, 1.0f, 1.0f));
     
-    actor->onPath = 0;
+    *actor->onPath = 0;
     
-    Mat4_Identity(&actor->worldMatrix);
+    actor->animInfo.marker = NULL;
+    actor->animInfo.finishedAnim = 0;
+    actor->animInfo.finishedTransition = 0;
+    
+    Mat4_Identity(actor->worldMatrix);
     
     actor->item = NULL;
     
     actor->onTap = NULL;
     actor->onUpdate = NULL;
+    actor->onPose = NULL;
     actor->onTouch = NULL;
     actor->onKill = NULL;
     actor->onSpawn = NULL;
     actor->onUse = NULL;
     
-    actor->tapEnabled = 0;
+    *actor->tapEnabled = 0;
 }
 
 int Actor_StartPath(Actor* actor, Vec3 destination)
@@ -63,23 +68,23 @@ int Actor_StartPath(Actor* actor, Vec3 destination)
     
     if (startPoly == hitInfo.poly)
     {
-        actor->path.nodeCount = 0;
-        NavPath_AddNode(&actor->path, destination, -1, -1);
+        actor->path->nodeCount = 0;
+        NavPath_AddNode(actor->path, destination, -1, -1);
     }
     else
     {
         NavSolver_Solve(&g_engine.navSystem.solver,
                         &g_engine.navSystem.navMesh,
-                        actor->position,
+                        *actor->position,
                         destination,
                         startPoly,
                         hitInfo.poly,
-                        &actor->path);
+                        actor->path);
         
-        NavSolver_SmoothPath(&g_engine.navSystem.navMesh, &actor->path, actor->position, destination, 0.25f);
+        NavSolver_SmoothPath(&g_engine.navSystem.navMesh, actor->path, *actor->position, destination, 0.25f);
     }
     
-    actor->onPath = 1;
+    *actor->onPath = 1;
     actor->pathIndex = 0;
         
     return 1;
@@ -90,12 +95,12 @@ static void Player_OnUpdate(Actor* actor)
     Engine* engine = &g_engine;
     
     // Raycast from unit loctation to determine which nav polygon the unit is on
-    Ray3 ray = Ray3_Create(Vec3_Add(actor->position, Vec3_Create(0.0f, 0.0f, 1.0f)), Vec3_Create(0.0f, 0.0f, -1.0f));
+    Ray3 ray = Ray3_Create(Vec3_Add(*actor->position, Vec3_Create(0.0f, 0.0f, 1.0f)), Vec3_Create(0.0f, 0.0f, -1.0f));
     
     NavRaycastResult hitInfo;
     if (NavSystem_Raycast(&engine->navSystem, ray, &hitInfo))
     {
-        actor->position.z = hitInfo.point.z;
+        actor->position->z = hitInfo.point.z;
         actor->pathPoly = hitInfo.poly;
     }
     else
@@ -103,13 +108,13 @@ static void Player_OnUpdate(Actor* actor)
         actor->pathPoly = NULL;
     }
     
-    if (actor->onPath)
+    if (*actor->onPath)
     {
-        SkelAnimator_SetAnim(&actor->skelModel.animator, g_engine.renderSystem.anims + ANIM_ASTRONAUT_WALK, 0, 15);
+        SkelAnimator_SetAnim(&actor->skelModel->animator, g_engine.renderSystem.anims + ANIM_ASTRONAUT_WALK, 0, 15);
 
         // move along path
-        Vec3 dest = actor->path.nodes[actor->pathIndex].position;
-        Vec3 dir = Vec3_Sub(dest, actor->position);
+        Vec3 dest = actor->path->nodes[actor->pathIndex].position;
+        Vec3 dir = Vec3_Sub(dest, *actor->position);
         
         float speed = 0.04f;
         
@@ -120,49 +125,35 @@ static void Player_OnUpdate(Actor* actor)
             actor->targetAngle = RAD_TO_DEG(atan2(dir.y, dir.x));
             
             dir = Vec3_Norm(dir);
-            float z = actor->position.z;
-            actor->position = Vec3_Add(actor->position, Vec3_Scale(dir, speed));
-            actor->position.z = z;
+            float z = actor->position->z;
+            *actor->position = Vec3_Add(*actor->position, Vec3_Scale(dir, speed));
+            actor->position->z = z;
         }
         else
         {
-            actor->position = dest;
+            *actor->position = dest;
             
-            if (actor->pathIndex + 1 < actor->path.nodeCount)
+            if (actor->pathIndex + 1 < actor->path->nodeCount)
             {
                 actor->pathIndex++;
             }
             else
             {
-                actor->onPath = 0;
+                *actor->onPath = 0;
             }
         }
-        
-        SkelModel_Tick(&actor->skelModel);
     }
     else
     {
         if (actor->useTarget)
         {
-            Vec2 dir = Vec2_Sub(Vec2_FromVec3(actor->useTarget->position), Vec2_FromVec3(actor->position));
+            Vec2 dir = Vec2_Sub(Vec2_FromVec3(*actor->useTarget->position), Vec2_FromVec3(*actor->position));
             actor->targetAngle = DEG_TO_RAD(atan2f(dir.x, dir.y)) + 90.0f;
-            SkelAnimator_SetAnim(&actor->skelModel.animator, g_engine.renderSystem.anims + ANIM_ASTRONAUT_PRESS, 0, 15);
-            
-            SkelAnimatorInfo info =  SkelModel_Tick(&actor->skelModel);
-            
-            if (info.marker != NULL)
-            {
-                if (actor->useTarget)
-                    actor->useTarget->onUse(actor->useTarget, actor);
-                actor->useTarget = NULL;
-                
-            }
+            SkelAnimator_SetAnim(&actor->skelModel->animator, g_engine.renderSystem.anims + ANIM_ASTRONAUT_PRESS, 0, 15);
         }
         else
         {
-            SkelAnimator_SetAnim(&actor->skelModel.animator, g_engine.renderSystem.anims + ANIM_ASTRONAUT_IDLE, 0, 15);
-            SkelModel_Tick(&actor->skelModel);
-
+            SkelAnimator_SetAnim(&actor->skelModel->animator, g_engine.renderSystem.anims + ANIM_ASTRONAUT_IDLE, 0, 15);
         }
         
     }
@@ -174,46 +165,59 @@ static void Player_OnUpdate(Actor* actor)
         actor->angle += diff;
     }
 
-    actor->skelModel.skel.rotation = Quat_CreateAngle(actor->angle + 90.0f, 0.0f, 0.0f, 1.0f);
+    actor->skelModel->skel.rotation = Quat_CreateAngle(actor->angle + 90.0f, 0.0f, 0.0f, 1.0f);
     
-    actor->bounds = AABB_CreateCentered(actor->position, Vec3_Create(1.0f, 1.0f, 1.0f));
+    *actor->bounds = AABB_CreateCentered(*actor->position, Vec3_Create(1.0f, 1.0f, 1.0f));
+}
+
+static void Player_OnPose(Actor* actor)
+{
+    /* the press animation marks the moment of contact */
+    const SkelAnim* press = g_engine.renderSystem.anims + ANIM_ASTRONAUT_PRESS;
+    
+    if (actor->useTarget && actor->animInfo.marker != NULL && actor->skelModel->animator.anim == press)
+    {
+        actor->useTarget->onUse(actor->useTarget, actor);
+        actor->useTarget = NULL;
+    }
     
-    const SkelAttachPoint* attachPoint = Skel_FindAttachPoint(&actor->skelModel.skel, "tool_attatch_point");
+    const SkelAttachPoint* attachPoint = Skel_FindAttachPoint(&actor->skelModel->skel, "tool_attatch_point");
     Actor* item = actor->item;
-    item->position = Vec3_Add(actor->position, attachPoint->modelPosition);
-    item->rotation = attachPoint->modelRotation;
+    *item->position = Vec3_Add(*actor->position, attachPoint->modelPosition);
+    *item->rotation = attachPoint->modelRotation;
 }
 
 static void Weapon_OnUpdate(Actor* actor)
 {
-    actor->rotation = Quat_Mult(actor->rotation, Quat_CreateAngle(0.5f, 0.0f, 0.0f, 1.0f));
+    *actor->rotation = Quat_Mult(*actor->rotation, Quat_CreateAngle(0.5f, 0.0f, 0.0f, 1.0f));
 }
 
 static void Weapon_OnSpawn(Actor* actor, int flags)
 {
     actor->onUpdate = Weapon_OnUpdate;
-    StaticModel_Copy(&actor->staticModel, g_engine.renderSystem.models + MODEL_WRENCH);
-    actor->renderType = kActorRenderStaticModel;
+    StaticModel_Copy(actor->staticModel, g_engine.renderSystem.models + MODEL_WRENCH);
+    *actor->renderType = kActorRenderStaticModel;
     
-    actor->staticModel.material.albedoMap = TEX_WRENCH_ALBEDO;
-    actor->staticModel.material.specularMap = TEX_WRENCH_SPECULAR;
+    actor->staticModel->material.albedoMap = TEX_WRENCH_ALBEDO;
+    actor->staticModel->material.specularMap = TEX_WRENCH_SPECULAR;
 }
 
 static void Player_OnSpawn(Actor* actor, int flags)
 {
     actor->onUpdate = Player_OnUpdate;
+    actor->onPose = Player_OnPose;
     
     g_engine.sceneSystem.playerIndex = actor->index;
-    actor->renderType = kActorRenderSkelModel;
+    *actor->renderType = kActorRenderSkelModel;
     
-    SkelModel_Copy(&actor->skelModel, g_engine.renderSystem.skelModels + SKEL_ASTRONAUT);
+    SkelModel_Copy(actor->skelModel, g_engine.renderSystem.skelModels + SKEL_ASTRONAUT);
     
-    actor->skelModel.material.albedoMap = TEX_ASTRONAUT_ALBEDO;
-    actor->skelModel.material.normalMap = TEX_ASTRONAUT_NORMAL;
-    actor->skelModel.material.specularMap = TEX_ASTRONAUT_SPECULAR;
-    actor->skelModel.material.glossMap = TEX_ASTRONAUT_GLOSS;
+    actor->skelModel->material.albedoMap = TEX_ASTRONAUT_ALBEDO;
+    actor->skelModel->material.normalMap = TEX_ASTRONAUT_NORMAL;
+    actor->skelModel->material.specularMap = TEX_ASTRONAUT_SPECULAR;
+    actor->skelModel->material.glossMap = TEX_ASTRONAUT_GLOSS;
 
-    actor->item = SceneSystem_SpawnAt(&g_engine.sceneSystem, kActorWeapon, actor->position, actor->rotation, 0);
+    actor->item = SceneSystem_SpawnAt(&g_engine.sceneSystem, kActorWeapon, *actor->position, *actor->rotation, 0);
 }
 
 static void Button_OnUse(Actor* actor, Actor* user)
@@ -227,7 +231,7 @@ static void Button_OnTap(Actor* actor, Ray3 ray)
     if (actor->pathPoly)
     {
         Actor* player = SceneSystem_Player(&g_engine.sceneSystem);
-        Actor_StartPath(player, actor->position);
+        Actor_StartPath(player, *actor->position);
         player->useTarget = actor;
     }
 }
@@ -236,21 +240,21 @@ static void Button_OnSpawn(Actor* actor, int flags)
 {
     actor->onUse = Button_OnUse;
     actor->onTap = Button_OnTap;
-    actor->tapEnabled = 1;
+    *actor->tapEnabled = 1;
     
-    Ray3 ray = Ray3_Create(AABB_Center(actor->bounds), Vec3_Create(0.0f, 0.0f, -1.0f));
+    Ray3 ray = Ray3_Create(AABB_Center(*actor->bounds), Vec3_Create(0.0f, 0.0f, -1.0f));
     
     NavRaycastResult result;
     if (NavSystem_Raycast(&g_engine.navSystem, ray, &result))
     {
         actor->pathPoly = result.poly;
-        actor->position = result.point;
+        *actor->position = result.point;
     }
 }
 
 static void Trigger_OnTouch(Actor* actor, Actor* other)
 {
-    if (other->type == kActorPlayer)
+    if (*other->type == kActorPlayer)
     {
         if (!String_IsEmpty(actor->eventName))
             ScriptSystem_RunEvent(&g_engine.scriptSystem, actor->eventName);
@@ -268,7 +272,7 @@ static void ViewTrigger_OnTap(Actor* actor, Ray3 ray)
     {
         Actor* player = SceneSystem_Player(&g_engine.sceneSystem);
         
-        Actor_StartPath(player, actor->position);
+        Actor_StartPath(player, *actor->position);
     }
 }
 
@@ -278,7 +282,7 @@ static void ViewTrigger_OnUpdate(Actor* actor)
     {
         Actor* player = SceneSystem_Player(&g_engine.sceneSystem);
 
-        if (player && AABB_IntersectsPoint(actor->bounds, player->position))
+        if (player && AABB_IntersectsPoint(*actor->bounds, *player->position))
             Engine_LoadView(&g_engine, actor->viewName);
     }
 }
@@ -287,27 +291,27 @@ static void ViewTrigger_OnSpawn(Actor* actor, int flags)
 {
     actor->onUpdate = ViewTrigger_OnUpdate;
     
-    if (actor->tapEnabled)
+    if (*actor->tapEnabled)
         actor->onTap = ViewTrigger_OnTap;
     
-    Ray3 ray = Ray3_Create(AABB_Center(actor->bounds), Vec3_Create(0.0f, 0.0f, -1.0f));
+    Ray3 ray = Ray3_Create(AABB_Center(*actor->bounds), Vec3_Create(0.0f, 0.0f, -1.0f));
     
     NavRaycastResult result;
     if (NavSystem_Raycast(&g_engine.navSystem, ray, &result))
     {
         actor->pathPoly = result.poly;
-        actor->position = result.point;
+        *actor->position = result.point;
     }
 }
 
 static void SceneStart_OnSpawn(Actor* actor, int flags)
 {
-    SceneSystem_SpawnAt(&g_engine.sceneSystem, kActorPlayer, actor->position, actor->rotation, 0);
+    SceneSystem_SpawnAt(&g_engine.sceneSystem, kActorPlayer, *actor->position, *actor->rotation, 0);
 }
 
 static void Waypoint_OnSpawn(Actor* actor, int flags)
 {
-    Ray3 ray = Ray3_Create(actor->position, Vec3_Create(0.0f, 0.0f, -1.0f));
+    Ray3 ray = Ray3_Create(*actor->position, Vec3_Create(0.0f, 0.0f, -1.0f));
 
     NavRaycastResult result;
     if (NavSystem_Raycast(&g_engine.navSystem, ray, &result))
@@ -48,45 +48,50 @@ extern int ActorTypeEntry_Compare(const void* a, const void* b);
 typedef struct Actor
 {
     int index;
-    char name[SCENE_ELEMENT_NAME_MAX];
-    int dead;
-    ActorType type;
-    ActorRenderType renderType;
     
-    AABB bounds;
-    Vec3 position;
-    Quat rotation;
+    void (*onUpdate)(struct Actor* actor);
+    /* after skeletal actors are animated and posed, which happens in parallel between onUpdate and onTouch */
+    void (*onPose)(struct Actor* actor);
+    void (*onTouch)(struct Actor* actor, struct Actor* other);
+    void (*onTap)(struct Actor* actor, Ray3 ray);
+    
+    /* into SceneSystem's component arrays, set once by SceneSystem_Init.
+     the per frame loops read the flags and transforms from the arrays, and the models,
+     path and names live there too, so an Actor is a few cache lines rather than 4 KB */
+    int* dead;
+    ActorType* type;
+    ActorRenderType* renderType;
+    int* onPath;
+    int* tapEnabled;
+    
+    AABB* bounds;
+    Vec3* position;
+    Quat* rotation;
+    Mat4* worldMatrix;
     
-    Mat4 worldMatrix;
+    char* name;
+    NavPath* path;
+    SkelModel* skelModel;
+    StaticModel* staticModel;
+    char* eventName;
+    char* viewName;
     
     int pathIndex;
     float angle;
     float targetAngle;
-    NavPath path;
     NavPoly* pathPoly;
     int destinationPolyIndex;
-    int onPath;
     Vec3 destination;
     
-    SkelModel skelModel;
-    StaticModel staticModel;
-    
-    int tapEnabled;
+    /* result of this frame's animation tick, for onPose */
+    SkelAnimatorInfo animInfo;
     
     struct Actor* useTarget;
     struct Actor* item;
     
-    char eventName[SCRIPT_EVENT_MAX];
-    char viewName[SCRIPT_EVENT_MAX];
-
     void (*onSpawn)(struct Actor* actor, int flags);
     void (*onKill)(struct Actor* actor);
-    
-    void (*onUpdate)(struct Actor* actor);
-    void (*onTouch)(struct Actor* actor, struct Actor* other);
     void (*onUse)(struct Actor* actor, struct Actor* user);
-        
-    void (*onTap)(struct Actor* actor, Ray3 ray);
 } Actor;
 
 extern ActorTypeEntry g_actorTypeTable[];
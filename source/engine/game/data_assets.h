@@ -10,6 +10,16 @@ typedef struct
     const char* path;
 } AssetEntry;
 
+enum
+{
+    AssetType_texture,
+    AssetType_skelModel,
+    AssetType_skelAnim,
+    AssetType_sound,
+    AssetType_script,
+    AssetType_staticModel,
+};
+
 enum
 {
     TEX_ASTRONAUT_ALBEDO,
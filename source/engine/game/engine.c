@@ -35,14 +35,31 @@ int Engine_Init(Engine* engine,
     
     engine->controlEnabled = 1;
     
+    engine->currentView = NULL;
+    engine->pendingView = NULL;
+    
+    ViewCache_Init(&engine->viewCache, engineSettings.viewCacheBudget);
+    JobSystem_Init(&engine->jobSystem, engineSettings.jobThreads);
+    
     Engine_LoadAssets(engine);
+    SceneSystem_Init(&engine->sceneSystem);
     Engine_LoadScene(engine, "scenes/quarters");
     
+    /* nothing to keep on screen yet */
     Engine_LoadView(engine, "hallway");
+    Engine_FinishViewLoad(engine, 1);
         
     return 1;
 }
 
+void Engine_Shutdown(Engine* engine)
+{
+    /* the loaders decode into memory they free, so they go before anything else */
+    ViewCache_Shutdown(&engine->viewCache);
+    JobSystem_Shutdown(&engine->jobSystem);
+    RenderSystem_Shutdown(&engine->renderSystem, engine);
+}
+
 void Engine_LoadScene(Engine* engine, const char* pathToFolder)
 {
     strncpy(engine->sceneFolder, pathToFolder, MAX_OS_PATH);
@@ -67,28 +84,16 @@ void Engine_LoadScene(Engine* engine, const char* pathToFolder)
     char manifestPath[MAX_OS_PATH];
     Filepath_Append(manifestPath, fullFolderPath, "level.manifest");
     SceneSystem_Load(&engine->sceneSystem, manifestPath);
+    
+    ViewCache_Build(&engine->viewCache,
+                    &engine->sceneSystem,
+                    engine->renderSystem.viewportWidth,
+                    engine->renderSystem.viewportHeight);
 }
 
-int Engine_LoadView(Engine* engine, const char* viewName)
+static void Engine_ShowView(Engine* engine, SceneView* view)
 {
-    clock_t startTime = clock();
-    SceneView* view = SceneSystem_FindView(&engine->sceneSystem, viewName);
-    if (engine->currentView == view)
-        return 0;
-    
     engine->currentView = view;
-
-    char filename[MAX_OS_PATH];
-    sprintf(filename, "%s.png", viewName);
-    char fullpath[MAX_OS_PATH];
-    Filepath_Append(fullpath, engine->sceneFolder, filename);
-    
-    RenderSystem_LoadTexture(&engine->renderSystem, TEX_VIEW_BG, kTextureFlagNone, fullpath);
-    
-    sprintf(filename, "%s_depth.png", viewName);
-    Filepath_Append(fullpath, engine->sceneFolder, filename);
-    
-    RenderSystem_LoadTexture(&engine->renderSystem, TEX_VIEW_BG_DEPTH, kTextureFlagNone, fullpath);
     
     engine->renderSystem.cam.near = view->near;
     engine->renderSystem.cam.far = view->far;
@@ -102,36 +107,179 @@ int Engine_LoadView(Engine* engine, const char* viewName)
     engine->sceneSystem.activeLights[0] = SceneSystem_FindLight(&engine->sceneSystem, view->primaryLight);
     engine->sceneSystem.activeLights[1] = SceneSystem_FindLight(&engine->sceneSystem, view->secondaryLight);
     
-    for (int i = 0; i < SCENE_ACTORS_MAX; ++i)
+    SceneSystem* scene = &engine->sceneSystem;
+    
+    for (int i = 0; i < scene->liveCount; ++i)
     {
-        Actor* actor = engine->sceneSystem.actors + i;
-        if (actor->dead) continue;
+        int index = scene->liveActors[i];
         
-        if (actor->type == kActorViewTrigger)
+        if (scene->actorTypes[index] == kActorViewTrigger)
         {
-            if (strncmp(actor->viewName, viewName, SCENE_ELEMENT_NAME_MAX) == 0)
+            if (strncmp(scene->actorViewNames[index], view->name, SCENE_ELEMENT_NAME_MAX) == 0)
             {
-                actor->tapEnabled = 0;
+                scene->actorTapEnabled[index] = 0;
             }
             else
             {
-                actor->tapEnabled = 1;
+                scene->actorTapEnabled[index] = 1;
             }
         }
     }
     
-    ScriptSystem_RunEvent(&engine->scriptSystem, viewName);
-    
-    sprintf(filename, "%s_cube.dds", viewName);
-    Filepath_Append(fullpath, engine->sceneFolder, filename);
-    RenderSystem_LoadTexture(&engine->renderSystem, TEX_VIEW_CUBE, 0, fullpath);
+    ScriptSystem_RunEvent(&engine->scriptSystem, view->name);
+}
 
-    clock_t endTime = clock();
-    printf("view time: %f\n", (endTime - startTime) / (float)CLOCKS_PER_SEC);
+/* drops the pending view's decode, from the loader or the prefetch it adopted */
+static void Engine_CancelViewLoad(Engine* engine)
+{
+    if (engine->viewCache.adopted)
+    {
+        ViewCache_Release(&engine->viewCache);
+    }
+    else
+    {
+        TextureBatch empty;
+        TextureBatch_Init(&empty);
+        TextureLoader_Request(&engine->renderSystem.textureLoader, &empty);
+    }
+    
+    engine->pendingView = NULL;
+}
 
+int Engine_LoadView(Engine* engine, const char* viewName)
+{
+    SceneView* view = SceneSystem_FindView(&engine->sceneSystem, viewName);
+    
+    if (!view)
+        return 0;
+    
+    if (engine->pendingView == view)
+        return 0;
+    
+    if (!engine->pendingView && engine->currentView == view)
+        return 0;
+    
+    if (engine->pendingView)
+        Engine_CancelViewLoad(engine);
+    
+    /* switching back before the plates arrive, the old ones are still resident */
+    if (engine->currentView == view)
+        return 0;
+    
+    clock_t startTime = clock();
+    
+    /* the prefetch is part decoded already, Engine_FinishViewLoad picks it up when it lands */
+    if (ViewCache_Adopt(&engine->viewCache, &engine->sceneSystem, view))
+    {
+        engine->pendingView = view;
+        engine->pendingViewTime = startTime;
+        return 1;
+    }
+    
+    TextureBatch batch;
+    
+    if (ViewCache_Take(&engine->viewCache, &engine->sceneSystem, view, &batch))
+    {
+        for (int i = 0; i < batch.count; ++i)
+        {
+            if (batch.loaded[i])
+                RenderSystem_UploadTexture(&engine->renderSystem, batch.slots[i], batch.textures + i);
+        }
+        
+        Engine_ShowView(engine, view);
+        
+        clock_t endTime = clock();
+        printf("view time: %f (cached)\n", (endTime - startTime) / (float)CLOCKS_PER_SEC);
+        return 1;
+    }
+    
+    engine->pendingView = view;
+    engine->pendingViewTime = startTime;
+    
+    Engine_ViewPlates(engine, view, &batch);
+    TextureLoader_Request(&engine->renderSystem.textureLoader, &batch);
     return 1;
 }
 
+/* prefers the precompressed dds written by tools/platecompress, falls back to the png */
+static void Engine_PlatePath(const Engine* engine, const char* viewName, const char* suffix, int compressed, char* fullpath)
+{
+    char filename[MAX_OS_PATH];
+    char path[MAX_OS_PATH];
+    
+    if (compressed)
+    {
+        sprintf(filename, "%s%s.dds", viewName, suffix);
+        Filepath_Append(path, engine->sceneFolder, filename);
+        Filepath_Append(fullpath, Filepath_DataPath(), path);
+        
+        FILE* file = fopen(fullpath, "rb");
+        if (file)
+        {
+            fclose(file);
+            return;
+        }
+    }
+    
+    sprintf(filename, "%s%s.png", viewName, suffix);
+    Filepath_Append(path, engine->sceneFolder, filename);
+    Filepath_Append(fullpath, Filepath_DataPath(), path);
+}
+
+void Engine_ViewPlates(const Engine* engine, const SceneView* view, TextureBatch* batch)
+{
+    TextureBatch_Init(batch);
+    
+    char filename[MAX_OS_PATH];
+    char path[MAX_OS_PATH];
+    char fullpath[MAX_OS_PATH];
+    
+    Engine_PlatePath(engine, view->name, "", engine->renderSystem.renderer->limits.textureDxt, fullpath);
+    TextureBatch_Add(batch, TEX_VIEW_BG, kTextureFlagNone, fullpath);
+    
+    /* depth is BC4 or 16 bit, which core GL always supports */
+    Engine_PlatePath(engine, view->name, "_depth", 1, fullpath);
+    TextureBatch_Add(batch, TEX_VIEW_BG_DEPTH, kTextureFlagNone, fullpath);
+    
+    sprintf(filename, "%s_cube.dds", view->name);
+    Filepath_Append(path, engine->sceneFolder, filename);
+    Filepath_Append(fullpath, Filepath_DataPath(), path);
+    TextureBatch_Add(batch, TEX_VIEW_CUBE, 0, fullpath);
+}
+
+void Engine_FinishViewLoad(Engine* engine, int block)
+{
+    if (!engine->pendingView)
+        return;
+    
+    TextureBatch batch;
+    
+    if (engine->viewCache.adopted)
+    {
+        if (!ViewCache_PollAdopted(&engine->viewCache, &batch, block))
+            return;
+    }
+    else if (!TextureLoader_Poll(&engine->renderSystem.textureLoader, &batch, block))
+    {
+        return;
+    }
+    
+    /* only the upload happens on this thread */
+    for (int i = 0; i < batch.count; ++i)
+    {
+        if (batch.loaded[i])
+            RenderSystem_UploadTexture(&engine->renderSystem, batch.slots[i], batch.textures + i);
+    }
+    
+    SceneView* view = engine->pendingView;
+    engine->pendingView = NULL;
+    
+    Engine_ShowView(engine, view);
+    
+    clock_t endTime = clock();
+    printf("view time: %f\n", (endTime - engine->pendingViewTime) / (float)CLOCKS_PER_SEC);
+}
+
 static void Engine_RecieveInput(Engine* engine, const InputState* state, const InputState* last, InputInfo* info)
 {
     if (!engine->controlEnabled)
@@ -150,15 +298,19 @@ static void Engine_RecieveInput(Engine* engine, const InputState* state, const I
         Actor* bestActor = NULL;
         float bestDistance = 0.0f;
         
-        for (int i = 0; i < SCENE_ACTORS_MAX; ++i)
-        {
-            Actor* actor = engine->sceneSystem.actors + i;
-            if (actor->dead) { continue; }
+        const SceneSystem* scene = &engine->sceneSystem;
         
-            if (actor->onTap && actor->tapEnabled)
+        for (int i = 0; i < scene->liveCount; ++i)
+        {
+            int index = scene->liveActors[i];
+            
+            /* the flag and bounds are in the arrays, only tappable actors are read */
+            if (scene->actorTapEnabled[index] && scene->actors[index].onTap)
             {
+                Actor* actor = engine->sceneSystem.actors + index;
+                
                 float t;
-                if (AABB_IntersectsRay(actor->bounds, mouseRay, &t))
+                if (AABB_IntersectsRay(scene->actorBounds[index], mouseRay, &t))
                 {
                     if (t < bestDistance || !bestActor)
                     {
@@ -189,10 +341,22 @@ static void Engine_RecieveInput(Engine* engine, const InputState* state, const I
     }
 }
 
+/* animates and poses skeletal actors, run across the job threads */
+static void Engine_PoseActors(void* data, int first, int count)
+{
+    Actor** actors = data;
+    
+    for (int i = first; i < first + count; ++i)
+        actors[i]->animInfo = SkelModel_Tick(actors[i]->skelModel);
+}
+
 void Engine_Update(Engine* engine, const InputState* inputState)
 {
     InputSystem_ProcessInput(&engine->inputSystem, inputState);
     
+    Engine_FinishViewLoad(engine, 0);
+    ViewCache_Update(&engine->viewCache, engine);
+    
     HintBuffer_Clear(&engine->renderSystem.hintBuffer);
 
     const InputState* currentInput = &engine->inputSystem.current;
@@ -200,43 +364,84 @@ void Engine_Update(Engine* engine, const InputState* inputState)
     
     Engine_RecieveInput(engine, currentInput, lastInput, &engine->inputSystem.info);
 
-    /* update entities */
-    for (int i = 0; i < SCENE_ACTORS_MAX; ++i)
+    /* update entities.
+     callbacks can spawn and kill, which reorders the live list, so walk a copy.
+     actors spawned this frame start updating next frame */
+    SceneSystem* scene = &engine->sceneSystem;
+    
+    int liveCount = scene->liveCount;
+    int live[SCENE_ACTORS_MAX];
+    memcpy(live, scene->liveActors, sizeof(int) * liveCount);
+    
+    Actor* posed[SCENE_ACTORS_MAX];
+    int posedCount = 0;
+    
+    /* only reads the component arrays, so it doesn't pull in the actors */
+    for (int i = 0; i < liveCount; ++i)
     {
-        Actor* actor = engine->sceneSystem.actors + i;
-        if (actor->dead) { continue; }
+        int index = live[i];
         
         Mat4 rot;
-        Mat4 translate = Mat4_CreateTranslate(actor->position);
-        Quat_ToMatrix(actor->rotation, &rot);
-        Mat4_Mult(&translate, &rot, &actor->worldMatrix);
-
+        Mat4 translate = Mat4_CreateTranslate(scene->actorPositions[index]);
+        Quat_ToMatrix(scene->actorRotations[index], &rot);
+        Mat4_Mult(&translate, &rot, scene->actorMatrices + index);
+    }
+    
+    for (int i = 0; i < liveCount; ++i)
+    {
+        int index = live[i];
+        if (scene->actorDead[index]) { continue; }
+        
+        Actor* actor = scene->actors + index;
+        
         if (actor->onUpdate)
         {
             actor->onUpdate(actor);
         }
         
-        for (int j = i + 1; j < SCENE_ACTORS_MAX; ++j)
-        {
-            Actor* other = engine->sceneSystem.actors + j;
-            
-            if (other->dead)
-                continue;
-            
-            if (AABB_IntersectsAABB(actor->bounds, other->bounds))
-            {
-                if (actor->onTouch)
-                    actor->onTouch(actor, other);
-                
-                if (other->onTouch)
-                    other->onTouch(other, actor);
-            }
-        }
+        if (scene->actorRenderTypes[index] == kActorRenderSkelModel && !scene->actorDead[index])
+            posed[posedCount++] = actor;
+    }
+    
+    /* each job only touches its own actors' skeletons */
+    JobSystem_ParallelFor(&engine->jobSystem, Engine_PoseActors, posed, posedCount, 1);
+    
+    for (int i = 0; i < liveCount; ++i)
+    {
+        int index = live[i];
+        if (scene->actorDead[index]) { continue; }
+        
+        if (scene->actorRenderTypes[index] == kActorRenderSkelModel && scene->actors[index].onPose)
+            scene->actors[index].onPose(scene->actors + index);
+        
+        SpatialHash_Update(&scene->touchHash, index, scene->actorBounds[index]);
+        
+        if (scene->actorOnPath[index])
+            HintBuffer_PackPath(&engine->renderSystem.hintBuffer, scene->actorPaths + index, Vec3_Create(0.0f, 0.0f, 1.0f));
+        
+        HintBuffer_PackAABB(&engine->renderSystem.hintBuffer, scene->actorBounds[index], Vec3_Create(0.7f, 0.7f, 0.7f));
+    }
+    
+    SpatialHash* touchHash = &scene->touchHash;
+    int pairCount = SpatialHash_FindPairs(touchHash);
+    
+    for (int i = 0; i < pairCount; ++i)
+    {
+        int a = touchHash->pairs[i].a;
+        int b = touchHash->pairs[i].b;
+        
+        /* an earlier touch may have killed one */
+        if (scene->actorDead[a] || scene->actorDead[b])
+            continue;
+        
+        Actor* actor = scene->actors + a;
+        Actor* other = scene->actors + b;
         
-        if (actor->onPath)
-            HintBuffer_PackPath(&engine->renderSystem.hintBuffer, &actor->path, Vec3_Create(0.0f, 0.0f, 1.0f));
+        if (actor->onTouch)
+            actor->onTouch(actor, other);
         
-        HintBuffer_PackAABB(&engine->renderSystem.hintBuffer, actor->bounds, Vec3_Create(0.7f, 0.7f, 0.7f));
+        if (other->onTouch)
+            other->onTouch(other, actor);
     }
     
     HintBuffer_PackNav(&engine->renderSystem.hintBuffer, &engine->navSystem.navMesh, Vec3_Create(0.0f, 1.0f, 0.0f));
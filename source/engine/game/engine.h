@@ -10,9 +10,13 @@
 #include "snd_system.h"
 #include "scene_system.h"
 #include "script_system.h"
+#include "view_cache.h"
+#include "asset_pack.h"
+#include "job_system.h"
 #include "data_assets.h"
 
 #include "utils.h"
+#include <time.h>
 
 
 typedef struct
@@ -23,6 +27,12 @@ typedef struct
     short renderWidth;
     short renderHeight;
     float renderScaleFactor;
+    
+    /* bytes of decoded plates kept for neighbouring views */
+    size_t viewCacheBudget;
+    
+    /* threads for parallel update phases, including the main thread. 1 or less runs them serially */
+    int jobThreads;
 } EngineSettings;
 
 
@@ -39,6 +49,17 @@ typedef struct Engine
     SceneSystem sceneSystem;
     SceneView* currentView;
     
+    /* view whose plates are decoding, it replaces currentView once they're resident */
+    SceneView* pendingView;
+    clock_t pendingViewTime;
+    
+    ViewCache viewCache;
+    
+    /* mapped data.pack, sounds play from it in place. empty when assets are loose files */
+    AssetPack assetPack;
+    
+    JobSystem jobSystem;
+    
     int controlEnabled;
 
     char sceneFolder[MAX_OS_PATH];    
@@ -51,8 +72,16 @@ extern int Engine_Init(Engine* engine,
                        SndDriver* sndDriver,
                        EngineSettings engineSettings);
 
+/* joins the loader and job threads and releases the renderer, while its context is still current */
+extern void Engine_Shutdown(Engine* engine);
+
 extern void Engine_LoadScene(Engine* engine, const char* pathToFolder);
+/* starts decoding a view's plates, the current view stays on screen until they are uploaded */
 extern int Engine_LoadView(Engine* engine, const char* viewName);
+extern void Engine_FinishViewLoad(Engine* engine, int block);
+
+/* the plates decoded for a view */
+extern void Engine_ViewPlates(const Engine* engine, const SceneView* view, TextureBatch* batch);
 
 extern void Engine_LoadAssets(Engine* engine);
 extern void Engine_UnloadAssets(Engine* engine);
@@ -109,29 +109,71 @@ void Engine_UnloadAssets(Engine* engine)
             SndSystem_LoadSnd(snd, entry->identifier, NULL);
         }
     }
+    
+    AssetPack_Close(&engine->assetPack);
 }
 
 
+/* stream over the packed copy of an asset, NULL to load the loose file */
+static FILE* Engine_OpenPacked(Engine* engine, int type, int identifier, const char** extension)
+{
+    const AssetPackEntry* packed = AssetPack_Find(&engine->assetPack, type, identifier);
+    
+    if (!packed)
+        return NULL;
+    
+    *extension = packed->extension;
+    return AssetPack_OpenStream(&engine->assetPack, packed);
+}
+
 void Engine_LoadAssets(Engine* engine)
 {
     RenderSystem* gl = &engine->renderSystem;
     SndSystem* snd = &engine->soundSystem;
-        
+    
+    char packPath[MAX_OS_PATH];
+    Filepath_Append(packPath, Filepath_DataPath(), "data.pack");
+    
+    if (AssetPack_Open(&engine->assetPack, packPath))
+    {
+        printf("loading assets from %s\n", packPath);
+    }
+    
+    const AssetPackEntry* packed;
+    const char* extension;
+    FILE* file;
+    
     for (int i = 0; i < Asset_textureCount; ++i)
     {
         const AssetEntry* entry = Asset_textureManifest + i;
         
-        if (entry->path)
+        if (!entry->path)
+            continue;
+        
+        if ((file = Engine_OpenPacked(engine, AssetType_texture, entry->identifier, &extension)))
+        {
+            RenderSystem_LoadTextureFile(gl, entry->identifier, kTextureFlagDefault, file, extension);
+            fclose(file);
+        }
+        else
         {
             RenderSystem_LoadTexture(gl, entry->identifier, kTextureFlagDefault, entry->path);
         }
     }
     
+    /* binary mesh and anim blocks are used in place, so the pack stays mapped until Engine_UnloadAssets */
     for (int i = 0; i < Asset_staticModelCount; ++i)
     {
         const AssetEntry* entry = Asset_staticModelManifest + i;
         
-        if (entry->path)
+        if (!entry->path)
+            continue;
+        
+        if ((packed = AssetPack_Find(&engine->assetPack, AssetType_staticModel, entry->identifier)))
+        {
+            RenderSystem_LoadStaticModelMemory(gl, entry->identifier, AssetPack_Data(&engine->assetPack, packed), packed->length, packed->extension);
+        }
+        else
         {
             RenderSystem_LoadStaticModel(gl, entry->identifier, entry->path);
         }
@@ -141,7 +183,14 @@ void Engine_LoadAssets(Engine* engine)
     {
         const AssetEntry* entry = Asset_skelModelManifest + i;
         
-        if (entry->path)
+        if (!entry->path)
+            continue;
+        
+        if ((packed = AssetPack_Find(&engine->assetPack, AssetType_skelModel, entry->identifier)))
+        {
+            RenderSystem_LoadSkelModelMemory(gl, entry->identifier, AssetPack_Data(&engine->assetPack, packed), packed->length, packed->extension);
+        }
+        else
         {
             RenderSystem_LoadSkelModel(gl, entry->identifier, entry->path);
         }
@@ -151,7 +200,14 @@ void Engine_LoadAssets(Engine* engine)
     {
         const AssetEntry* entry = Asset_skelAnimManifest + i;
         
-        if (entry->path)
+        if (!entry->path)
+            continue;
+        
+        if ((packed = AssetPack_Find(&engine->assetPack, AssetType_skelAnim, entry->identifier)))
+        {
+            RenderSystem_LoadAnimMemory(gl, entry->identifier, AssetPack_Data(&engine->assetPack, packed), packed->length, packed->extension);
+        }
+        else
         {
             RenderSystem_LoadAnim(gl, entry->identifier, entry->path);
         }
@@ -161,7 +217,15 @@ void Engine_LoadAssets(Engine* engine)
     {
         const AssetEntry* entry = Asset_soundManifest + i;
         
-        if (entry->path)
+        if (!entry->path)
+            continue;
+        
+        /* samples stay in the mapping, no copy */
+        if ((packed = AssetPack_Find(&engine->assetPack, AssetType_sound, entry->identifier)))
+        {
+            SndSystem_LoadSndMemory(snd, entry->identifier, AssetPack_Data(&engine->assetPack, packed), packed->length, packed->extension);
+        }
+        else
         {
             SndSystem_LoadSnd(snd, entry->identifier, entry->path);
         }
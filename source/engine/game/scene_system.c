@@ -26,11 +26,84 @@ int SceneNameEntry_Compare(const void* a, const void* b)
     return strncmp(ea->name, eb->name, SCENE_ELEMENT_NAME_MAX);
 }
 
+int SceneSystem_Init(SceneSystem* scene)
+{
+    for (int i = 0; i < SCENE_ACTORS_MAX; ++i)
+    {
+        Actor* actor = scene->actors + i;
+        actor->index = i;
+        
+        actor->dead = scene->actorDead + i;
+        actor->type = scene->actorTypes + i;
+        actor->renderType = scene->actorRenderTypes + i;
+        actor->onPath = scene->actorOnPath + i;
+        actor->tapEnabled = scene->actorTapEnabled + i;
+        
+        actor->bounds = scene->actorBounds + i;
+        actor->position = scene->actorPositions + i;
+        actor->rotation = scene->actorRotations + i;
+        actor->worldMatrix = scene->actorMatrices + i;
+        
+        actor->name = scene->actorNameStrings[i];
+        actor->path = scene->actorPaths + i;
+        actor->skelModel = scene->actorSkelModels + i;
+        actor->staticModel = scene->actorStaticModels + i;
+        actor->eventName = scene->actorEventNames[i];
+        actor->viewName = scene->actorViewNames[i];
+        
+        scene->actorDead[i] = 1;
+    }
+    
+    return SpatialHash_Init(&scene->touchHash, SCENE_ACTORS_MAX, SCENE_TOUCH_CELL_SIZE, SCENE_ACTORS_MAX * 2);
+}
+
+static void SceneSystem_AddLive(SceneSystem* scene, int index)
+{
+    scene->livePositions[index] = scene->liveCount;
+    scene->liveActors[scene->liveCount] = index;
+    ++scene->liveCount;
+}
+
+static void SceneSystem_RemoveLive(SceneSystem* scene, int index)
+{
+    int position = scene->livePositions[index];
+    int last = scene->liveActors[scene->liveCount - 1];
+    
+    scene->liveActors[position] = last;
+    scene->livePositions[last] = position;
+    scene->livePositions[index] = -1;
+    --scene->liveCount;
+}
+
+/* from the dead flags, after loading */
+static void SceneSystem_BuildLists(SceneSystem* scene)
+{
+    scene->liveCount = 0;
+    scene->freeCount = 0;
+    
+    /* pushed in reverse so the lowest slot is used first */
+    for (int i = SCENE_ACTORS_MAX - 1; i >= 0; --i)
+    {
+        scene->livePositions[i] = -1;
+        
+        if (scene->actorDead[i])
+            scene->freeActors[scene->freeCount++] = i;
+    }
+    
+    for (int i = 0; i < SCENE_ACTORS_MAX; ++i)
+    {
+        if (!scene->actorDead[i])
+            SceneSystem_AddLive(scene, i);
+    }
+}
+
 void SceneSystem_Load(SceneSystem* scene, const char* filepath)
 {
+    SpatialHash_Clear(&scene->touchHash);
+    
     for (int i = 0; i < SCENE_ACTORS_MAX; ++i)
     {
-        scene->actors[i].dead = 1;
+        scene->actorDead[i] = 1;
         
         scene->actorNames[i].index = -1;
         scene->actorNames[i].name = NULL;
@@ -126,7 +199,7 @@ void SceneSystem_Load(SceneSystem* scene, const char* filepath)
                 
                 Actor* actor = scene->actors + scene->actorCount;
                 Actor_Init(actor);
-                actor->dead = 0;
+                *actor->dead = 0;
                 
                 while (actorElement)
                 {
@@ -144,19 +217,19 @@ void SceneSystem_Load(SceneSystem* scene, const char* filepath)
                     }
                     else if (strcmp("position", actorElement->name->string) == 0)
                     {
-                        json_value_get_vec3(actorElement->value, &actor->position);
+                        json_value_get_vec3(actorElement->value, actor->position);
                     }
                     else if (strcmp("rotation", actorElement->name->string) == 0)
                     {
-                        json_value_get_quat(actorElement->value, &actor->rotation);
+                        json_value_get_quat(actorElement->value, actor->rotation);
                     }
                     else if (strcmp("bounds_min", actorElement->name->string) == 0)
                     {
-                        json_value_get_vec3(actorElement->value, &actor->bounds.min);
+                        json_value_get_vec3(actorElement->value, &actor->bounds->min);
                     }
                     else if (strcmp("bounds_max", actorElement->name->string) == 0)
                     {
-                        json_value_get_vec3(actorElement->value, &actor->bounds.max);
+                        json_value_get_vec3(actorElement->value, &actor->bounds->max);
                     }
                     else if (strcmp("view", actorElement->name->string) == 0)
                     {
@@ -164,7 +237,7 @@ void SceneSystem_Load(SceneSystem* scene, const char* filepath)
                     }
                     else if (strcmp("tap_enabled", actorElement->name->string) == 0)
                     {
-                        json_value_get_int(actorElement->value, &actor->tapEnabled);
+                        json_value_get_int(actorElement->value, actor->tapEnabled);
                     }
                     else if (strcmp("event", actorElement->name->string) == 0)
                     {
@@ -181,7 +254,7 @@ void SceneSystem_Load(SceneSystem* scene, const char* filepath)
                         {
                             if (strcmp(typeString, it->typeName) == 0)
                             {
-                                actor->type = it->type;
+                                *actor->type = it->type;
                                 actor->onSpawn = it->onSpawn;
                                 break;
                             }
@@ -238,15 +311,17 @@ void SceneSystem_Load(SceneSystem* scene, const char* filepath)
     
     free(root);
     
-    qsort(scene->actorNames, scene->actorCount, sizeof(SceneNameEntry), SceneNameEntry_Compare);
+    qsort(scene->actorNames, scene->actorNameCount, sizeof(SceneNameEntry), SceneNameEntry_Compare);
     qsort(scene->views, scene->viewCount, sizeof(SceneView), SceneView_Compare);
     qsort(scene->lights, scene->lightCount, sizeof(SceneLight), SceneLight_Compare);
 
-    for (int i = 0; i < SCENE_ACTORS_MAX; ++i)
+    SceneSystem_BuildLists(scene);
+    
+    /* only the loaded actors, those spawned by onSpawn have had theirs */
+    for (int i = 0; i < scene->actorCount; ++i)
     {
         Actor* actor = scene->actors + i;
-        actor->index = i;
-        if (actor->dead == 1)
+        if (*actor->dead == 1)
             continue;
         
         if (actor->onSpawn)
@@ -260,46 +335,49 @@ Actor* SceneSystem_SpawnAt(SceneSystem* scene,
                            Quat rotation,
                            int flags)
 {
-    for (int i = 0; i < SCENE_ACTORS_MAX; ++i)
+    if (scene->freeCount == 0)
+        return NULL;
+    
+    int index = scene->freeActors[--scene->freeCount];
+    Actor* actor = scene->actors + index;
+    
+    Actor_Init(actor);
+    
+    const ActorTypeEntry* it = g_actorTypeTable;
+    
+    while (it->type != kActorNone)
     {
-        Actor* actor = scene->actors + i;
-        
-        if (!actor->dead) continue;
-        
-        Actor_Init(actor);
-        
-        const ActorTypeEntry* it = g_actorTypeTable;
-        
-        while (it->type != kActorNone)
+        if (it->type == type)
         {
-            if (it->type == type)
-            {
-                actor->type = it->type;
-                actor->onSpawn = it->onSpawn;
-                break;
-            }
-            ++it;
+            *actor->type = it->type;
+            actor->onSpawn = it->onSpawn;
+            break;
         }
-
-        
-        actor->dead = 0;
-        actor->position = position;
-        
-        if (actor->onSpawn)
-            actor->onSpawn(actor, flags);
-
-        return actor;
+        ++it;
     }
     
-    return NULL;
+    *actor->dead = 0;
+    *actor->position = position;
+    SceneSystem_AddLive(scene, index);
+    
+    if (actor->onSpawn)
+        actor->onSpawn(actor, flags);
+    
+    return actor;
 }
 
 void SceneSystem_Kill(SceneSystem* scene, Actor* actor)
 {
+    if (*actor->dead)
+        return;
+    
     if (actor->onKill)
         actor->onKill(actor);
     
-    actor->dead = 1;
+    *actor->dead = 1;
+    SceneSystem_RemoveLive(scene, actor->index);
+    scene->freeActors[scene->freeCount++] = actor->index;
+    SpatialHash_Remove(&scene->touchHash, actor->index);
 }
 
 SceneView* SceneSystem_FindView(SceneSystem* scene, const char* name)
@@ -5,6 +5,7 @@
 #include "geo_math.h"
 #include "actor.h"
 #include "nav_system.h"
+#include "spatial_hash.h"
 
 
 typedef struct
@@ -43,10 +44,17 @@ extern int SceneNameEntry_Compare(const void* a, const void* b);
 
 #define SCENE_VIEWS_MAX 32
 #define SCENE_LIGHTS_MAX 32
+
+/* actor slots. Per frame work scales with live actors rather than slots, so this can be raised with -DSCENE_ACTORS_MAX */
+#ifndef SCENE_ACTORS_MAX
 #define SCENE_ACTORS_MAX 256
+#endif
 
 #define SCENE_LIGHTS_PER_VIEW 2
 
+/* actors are about a unit across, so most sit in one or two cells */
+#define SCENE_TOUCH_CELL_SIZE 2.0f
+
 typedef struct
 {
     int viewCount;
@@ -55,9 +63,42 @@ typedef struct
     int lightCount;
     SceneLight lights[SCENE_LIGHTS_MAX];
     
+    /* actors loaded from the scene file, in the first slots */
     int actorCount;
     Actor actors[SCENE_ACTORS_MAX];
     
+    /* hot actor components and flags, by actor index. Actors point into these, so the per frame
+     loops stream through a few bytes per actor instead of each whole Actor */
+    AABB actorBounds[SCENE_ACTORS_MAX];
+    Vec3 actorPositions[SCENE_ACTORS_MAX];
+    Quat actorRotations[SCENE_ACTORS_MAX];
+    Mat4 actorMatrices[SCENE_ACTORS_MAX];
+    
+    int actorDead[SCENE_ACTORS_MAX];
+    ActorType actorTypes[SCENE_ACTORS_MAX];
+    ActorRenderType actorRenderTypes[SCENE_ACTORS_MAX];
+    int actorOnPath[SCENE_ACTORS_MAX];
+    int actorTapEnabled[SCENE_ACTORS_MAX];
+    
+    /* cold actor data, by actor index. Touched on spawn, when following paths and when drawing */
+    char actorNameStrings[SCENE_ACTORS_MAX][SCENE_ELEMENT_NAME_MAX];
+    char actorEventNames[SCENE_ACTORS_MAX][SCRIPT_EVENT_MAX];
+    char actorViewNames[SCENE_ACTORS_MAX][SCRIPT_EVENT_MAX];
+    NavPath actorPaths[SCENE_ACTORS_MAX];
+    SkelModel actorSkelModels[SCENE_ACTORS_MAX];
+    StaticModel actorStaticModels[SCENE_ACTORS_MAX];
+    
+    /* indices of live actors, packed. A kill moves the last into the gap, so the order isn't stable */
+    int liveCount;
+    int liveActors[SCENE_ACTORS_MAX];
+    
+    /* each actor's position in liveActors, -1 when dead */
+    int livePositions[SCENE_ACTORS_MAX];
+    
+    /* stack of dead slots */
+    int freeCount;
+    int freeActors[SCENE_ACTORS_MAX];
+    
     int playerIndex;
     
     SceneView* currentView;
@@ -66,8 +107,12 @@ typedef struct
     int actorNameCount;
     SceneNameEntry actorNames[SCENE_ACTORS_MAX];
     
+    /* broadphase for onTouch, items are actor indices */
+    SpatialHash touchHash;
+    
 } SceneSystem;
 
+extern int SceneSystem_Init(SceneSystem* scene);
 extern void SceneSystem_Load(SceneSystem* scene, const char* filepath);
 
 
@@ -0,0 +1,282 @@
+#include "view_cache.h"
+#include "engine.h"
+#include <string.h>
+
+static void ViewCache_Clear(ViewCache* cache)
+{
+    for (int i = 0; i < SCENE_VIEWS_MAX; ++i)
+    {
+        ViewCacheEntry* entry = cache->entries + i;
+        
+        if (entry->state == kViewCacheReady)
+        {
+            for (int j = 0; j < entry->batch.count; ++j)
+            {
+                if (entry->batch.loaded[j])
+                    Texture_Shutdown(entry->batch.textures + j);
+            }
+        }
+        
+        entry->state = kViewCacheEmpty;
+        entry->bytes = 0;
+        entry->lastUsed = 0;
+    }
+    
+    cache->used = 0;
+}
+
+static void ViewCache_Evict(ViewCache* cache, int index)
+{
+    ViewCacheEntry* entry = cache->entries + index;
+    
+    for (int j = 0; j < entry->batch.count; ++j)
+    {
+        if (entry->batch.loaded[j])
+            Texture_Shutdown(entry->batch.textures + j);
+    }
+    
+    cache->used -= entry->bytes;
+    entry->bytes = 0;
+    entry->state = kViewCacheEvicted;
+    
+    ++cache->stats.evictions;
+}
+
+/* evicts least recently used plates, neighbours of the current view last */
+static void ViewCache_Trim(ViewCache* cache, int current)
+{
+    uint32_t keep = (current >= 0) ? cache->neighbours[current] : 0;
+    
+    while (cache->used > cache->budget)
+    {
+        int victim = -1;
+        int victimKept = 1;
+        
+        for (int i = 0; i < cache->viewCount; ++i)
+        {
+            const ViewCacheEntry* entry = cache->entries + i;
+            
+            if (entry->state != kViewCacheReady)
+                continue;
+            
+            int kept = (keep >> i) & 1;
+            
+            if (victim == -1 ||
+                kept < victimKept ||
+                (kept == victimKept && entry->lastUsed < cache->entries[victim].lastUsed))
+            {
+                victim = i;
+                victimKept = kept;
+            }
+        }
+        
+        if (victim == -1)
+            break;
+        
+        ViewCache_Evict(cache, victim);
+    }
+}
+
+int ViewCache_Init(ViewCache* cache, size_t budget)
+{
+    cache->budget = budget;
+    cache->used = 0;
+    cache->viewCount = 0;
+    cache->loading = -1;
+    cache->adopted = 0;
+    cache->lastView = -1;
+    cache->clock = 0;
+    
+    cache->stats.hits = 0;
+    cache->stats.misses = 0;
+    cache->stats.evictions = 0;
+    cache->stats.waits = 0;
+    
+    for (int i = 0; i < SCENE_VIEWS_MAX; ++i)
+    {
+        cache->neighbours[i] = 0;
+        cache->entries[i].state = kViewCacheEmpty;
+        cache->entries[i].bytes = 0;
+        cache->entries[i].lastUsed = 0;
+    }
+    
+    return TextureLoader_Init(&cache->loader);
+}
+
+void ViewCache_Shutdown(ViewCache* cache)
+{
+    TextureLoader_Shutdown(&cache->loader);
+    ViewCache_Clear(cache);
+}
+
+void ViewCache_Build(ViewCache* cache, SceneSystem* scene, short viewWidth, short viewHeight)
+{
+    if (cache->loading != -1)
+    {
+        /* an empty request supersedes the decode in flight */
+        TextureBatch empty;
+        TextureBatch_Init(&empty);
+        TextureLoader_Request(&cache->loader, &empty);
+        cache->loading = -1;
+        cache->adopted = 0;
+    }
+    
+    ViewCache_Clear(cache);
+    
+    cache->viewCount = scene->viewCount;
+    cache->lastView = -1;
+    
+    for (int i = 0; i < scene->viewCount; ++i)
+    {
+        const SceneView* view = scene->views + i;
+        cache->neighbours[i] = 0;
+        
+        Frustum frustum;
+        Frustum_Init(&frustum, view->fov, view->near, view->far);
+        frustum.position = view->position;
+        
+        Vec3 dir = Quat_MultVec3(&view->rotation, Vec3_Create(0.0f, 0.0f, -1.0f));
+        frustum.target = Vec3_Add(view->position, dir);
+        frustum.orientation = Vec3_Create(0.0f, 0.0f, 1.0f);
+        
+        Frustum_UpdateTransform(&frustum, viewWidth, viewHeight);
+        
+        for (int j = 0; j < scene->actorCount; ++j)
+        {
+            if (scene->actorDead[j] || scene->actorTypes[j] != kActorViewTrigger || String_IsEmpty(scene->actorViewNames[j]))
+                continue;
+            
+            const SceneView* next = SceneSystem_FindView(scene, scene->actorViewNames[j]);
+            
+            if (next && next != view && Frustum_AabbVisible(&frustum, scene->actorBounds[j]))
+                cache->neighbours[i] |= 1u << (next - scene->views);
+        }
+    }
+}
+
+int ViewCache_Take(ViewCache* cache, const SceneSystem* scene, const SceneView* view, TextureBatch* out)
+{
+    int index = (int)(view - scene->views);
+    ViewCacheEntry* entry = cache->entries + index;
+    
+    if (entry->state != kViewCacheReady)
+    {
+        ++cache->stats.misses;
+        return 0;
+    }
+    
+    *out = entry->batch;
+    
+    cache->used -= entry->bytes;
+    entry->bytes = 0;
+    entry->state = kViewCacheEmpty;
+    
+    ++cache->stats.hits;
+    return 1;
+}
+
+int ViewCache_Adopt(ViewCache* cache, const SceneSystem* scene, const SceneView* view)
+{
+    int index = (int)(view - scene->views);
+    
+    if (cache->loading != index || cache->entries[index].state != kViewCacheLoading)
+        return 0;
+    
+    cache->adopted = 1;
+    
+    ++cache->stats.waits;
+    ++cache->stats.hits;
+    return 1;
+}
+
+int ViewCache_PollAdopted(ViewCache* cache, TextureBatch* out, int block)
+{
+    if (!cache->adopted || !TextureLoader_Poll(&cache->loader, out, block))
+        return 0;
+    
+    cache->entries[cache->loading].state = kViewCacheEmpty;
+    cache->loading = -1;
+    cache->adopted = 0;
+    return 1;
+}
+
+void ViewCache_Release(ViewCache* cache)
+{
+    cache->adopted = 0;
+}
+
+const ViewCacheStats* ViewCache_Stats(const ViewCache* cache)
+{
+    return &cache->stats;
+}
+
+void ViewCache_Update(ViewCache* cache, Engine* engine)
+{
+    SceneSystem* scene = &engine->sceneSystem;
+    int current = engine->currentView ? (int)(engine->currentView - scene->views) : -1;
+    
+    if (current != cache->lastView)
+    {
+        cache->lastView = current;
+        ++cache->clock;
+        
+        for (int i = 0; i < cache->viewCount; ++i)
+        {
+            ViewCacheEntry* entry = cache->entries + i;
+            
+            if (entry->state == kViewCacheEvicted)
+                entry->state = kViewCacheEmpty;
+            
+            /* neighbours of the view shown are the most recently useful */
+            if (current >= 0 && ((cache->neighbours[current] >> i) & 1))
+                entry->lastUsed = cache->clock;
+        }
+        
+        ViewCache_Trim(cache, current);
+    }
+    
+    TextureBatch batch;
+    
+    if (cache->loading != -1 && !cache->adopted && TextureLoader_Poll(&cache->loader, &batch, 0))
+    {
+        ViewCacheEntry* entry = cache->entries + cache->loading;
+        cache->loading = -1;
+        
+        size_t bytes = 0;
+        for (int i = 0; i < batch.count; ++i)
+        {
+            if (batch.loaded[i])
+                bytes += batch.textures[i].dataLength;
+        }
+        
+        entry->batch = batch;
+        entry->bytes = bytes;
+        entry->lastUsed = cache->clock;
+        entry->state = kViewCacheReady;
+        cache->used += bytes;
+        
+        ViewCache_Trim(cache, current);
+    }
+    
+    /* without a thread the loader decodes on request, which prefetching would make a hitch */
+    if (cache->loading != -1 || current < 0 || cache->used >= cache->budget || !cache->loader.running)
+        return;
+    
+    int pending = engine->pendingView ? (int)(engine->pendingView - scene->views) : -1;
+    
+    for (int i = 0; i < cache->viewCount; ++i)
+    {
+        if (i == current || i == pending)
+            continue;
+        
+        if (!((cache->neighbours[current] >> i) & 1) || cache->entries[i].state != kViewCacheEmpty)
+            continue;
+        
+        Engine_ViewPlates(engine, scene->views + i, &batch);
+        TextureLoader_Request(&cache->loader, &batch);
+        
+        cache->entries[i].state = kViewCacheLoading;
+        cache->loading = i;
+        break;
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef VIEW_CACHE_H
+#define VIEW_CACHE_H
+
+#include <stdint.h>
+#include "scene_system.h"
+#include "texture_loader.h"
+
+/*
+ Prefetches the plates of views that can follow the current one.
+ 
+ A view can follow another when one of its ViewTriggers is inside the other's frustum.
+ Neighbours of the current view are decoded one at a time on a loader thread
+ and kept in RAM, so changing to them only costs the upload.
+ Least recently used plates are evicted to stay within the budget.
+ */
+
+#if SCENE_VIEWS_MAX > 32
+#error view cache neighbour masks hold 32 views
+#endif
+
+typedef enum
+{
+    kViewCacheEmpty = 0,
+    kViewCacheLoading,
+    kViewCacheReady,
+    
+    /* didn't fit in the budget, not retried until the current view changes */
+    kViewCacheEvicted,
+} ViewCacheState;
+
+typedef struct
+{
+    ViewCacheState state;
+    TextureBatch batch;
+    size_t bytes;
+    unsigned int lastUsed;
+} ViewCacheEntry;
+
+typedef struct
+{
+    int hits;
+    int misses;
+    int evictions;
+    
+    /* hits on the view still being prefetched, shown once its decode lands */
+    int waits;
+} ViewCacheStats;
+
+typedef struct
+{
+    TextureLoader loader;
+    
+    /* bytes of decoded plates to keep */
+    size_t budget;
+    size_t used;
+    
+    int viewCount;
+    
+    /* bit j of neighbours[i] is set when view j can follow view i */
+    uint32_t neighbours[SCENE_VIEWS_MAX];
+    ViewCacheEntry entries[SCENE_VIEWS_MAX];
+    
+    /* view being decoded, -1 when idle */
+    int loading;
+    
+    /* the decode in flight was adopted by the engine, it is handed over rather than kept */
+    int adopted;
+    int lastView;
+    unsigned int clock;
+    
+    ViewCacheStats stats;
+} ViewCache;
+
+struct Engine;
+
+extern int ViewCache_Init(ViewCache* cache, size_t budget);
+/* joins the loader thread, dropping any decode in flight */
+extern void ViewCache_Shutdown(ViewCache* cache);
+
+/* drops cached plates and builds view adjacency from a newly loaded scene */
+extern void ViewCache_Build(ViewCache* cache, SceneSystem* scene, short viewWidth, short viewHeight);
+
+/* takes a view's decoded plates if they are cached, the caller owns the texture data */
+extern int ViewCache_Take(ViewCache* cache, const SceneSystem* scene, const SceneView* view, TextureBatch* out);
+
+/* claims the decode in flight if it is for the view, so it isn't started over.
+ Its plates come from ViewCache_PollAdopted */
+extern int ViewCache_Adopt(ViewCache* cache, const SceneSystem* scene, const SceneView* view);
+/* takes the adopted plates once decoded, as TextureLoader_Poll */
+extern int ViewCache_PollAdopted(ViewCache* cache, TextureBatch* out, int block);
+/* gives up the adopted decode, it is cached as a prefetch when it lands */
+extern void ViewCache_Release(ViewCache* cache);
+
+extern const ViewCacheStats* ViewCache_Stats(const ViewCache* cache);
+
+/* collects finished decodes and starts the next neighbour of the current view */
+extern void ViewCache_Update(ViewCache* cache, struct Engine* engine);
+
+#endif
@@ -76,6 +76,10 @@ int NavSolver_Init(NavSolver* nav)
 {
     nav->pool = NULL;
     nav->closed = NULL;
+    nav->heap = NULL;
+    nav->polyNodes = NULL;
+    nav->heapCount = 0;
+    nav->nextOrder = 0;
     
     return 1;
 }
@@ -88,23 +92,120 @@ void NavSolver_Shutdown(NavSolver* nav)
     if (nav->closed)
         stb_sb_free(nav->closed);
     
+    if (nav->heap)
+        stb_sb_free(nav->heap);
+    
+    if (nav->polyNodes)
+        stb_sb_free(nav->polyNodes);
+    
     nav->pool = NULL;
     nav->closed = NULL;
+    nav->heap = NULL;
+    nav->polyNodes = NULL;
 }
 
 void NavSolver_Prepare(NavSolver* nav,
                        const NavMesh* mesh)
 {
-    stb_sb_free(nav->pool);
-    stb_sb_free(nav->closed);
-    
-    nav->pool = NULL;
-    nav->closed = NULL;
+    NavSolver_Shutdown(nav);
     
     stb_sb_add(nav->pool, mesh->polyCount);
     stb_sb_add(nav->closed, mesh->polyCount);
+    stb_sb_add(nav->heap, mesh->polyCount);
+    stb_sb_add(nav->polyNodes, mesh->polyCount);
 }
 
+static int NavSolver_HeapLess(const NavSolver* nav, int a, int b)
+{
+    const struct NavSearchNode* na = nav->pool + nav->heap[a];
+    const struct NavSearchNode* nb = nav->pool + nav->heap[b];
+    
+    if (na->cost != nb->cost)
+        return na->cost < nb->cost;
+    
+    return na->order < nb->order;
+}
+
+static void NavSolver_HeapSwap(NavSolver* nav, int a, int b)
+{
+    int temp = nav->heap[a];
+    nav->heap[a] = nav->heap[b];
+    nav->heap[b] = temp;
+    
+    nav->pool[nav->heap[a]].heapIndex = a;
+    nav->pool[nav->heap[b]].heapIndex = b;
+}
+
+static void NavSolver_HeapUp(NavSolver* nav, int i)
+{
+    while (i > 0)
+    {
+        int parent = (i - 1) / 2;
+        
+        if (!NavSolver_HeapLess(nav, i, parent))
+            break;
+        
+        NavSolver_HeapSwap(nav, i, parent);
+        i = parent;
+    }
+}
+
+static void NavSolver_HeapDown(NavSolver* nav, int i)
+{
+    while (1)
+    {
+        int smallest = i;
+        int left = i * 2 + 1;
+        int right = left + 1;
+        
+        if (left < nav->heapCount && NavSolver_HeapLess(nav, left, smallest))
+            smallest = left;
+        
+        if (right < nav->heapCount && NavSolver_HeapLess(nav, right, smallest))
+            smallest = right;
+        
+        if (smallest == i)
+            break;
+        
+        NavSolver_HeapSwap(nav, i, smallest);
+        i = smallest;
+    }
+}
+
+static void NavSolver_HeapPush(NavSolver* nav, int node)
+{
+    int i = nav->heapCount++;
+    nav->heap[i] = node;
+    nav->pool[node].heapIndex = i;
+    
+    NavSolver_HeapUp(nav, i);
+}
+
+static int NavSolver_HeapPop(NavSolver* nav)
+{
+    int node = nav->heap[0];
+    nav->pool[node].heapIndex = -1;
+    
+    --nav->heapCount;
+    
+    if (nav->heapCount > 0)
+    {
+        nav->heap[0] = nav->heap[nav->heapCount];
+        nav->pool[nav->heap[0]].heapIndex = 0;
+        NavSolver_HeapDown(nav, 0);
+    }
+    
+    return node;
+}
+
+/* after a node's cost or order changes, in either direction */
+static void NavSolver_HeapUpdate(NavSolver* nav, int node)
+{
+    int i = nav->pool[node].heapIndex;
+    
+    NavSolver_HeapUp(nav, i);
+    NavSolver_HeapDown(nav, nav->pool[node].heapIndex);
+}
 
 /* A* path finding */
 int NavSolver_Solve(NavSolver* nav,
@@ -126,22 +227,28 @@ int NavSolver_Solve(NavSolver* nav,
     // reset count to 0
     stb__sbn(nav->pool) = 0;
     memset(nav->closed, 0, sizeof(char) * stb__sbn(nav->closed));
+    memset(nav->polyNodes, 0xFF, sizeof(int) * stb__sbn(nav->polyNodes));
     
     assert(stb__sbn(nav->closed) == mesh->polyCount);
     
+    nav->heapCount = 0;
+    nav->nextOrder = 0;
+    
     struct NavSearchNode* first = stb_sb_add(nav->pool, 1);
-    first->next = -1;
     first->parent = -1;
     first->polyIndex = startPoly->index;
     first->edgeIndex = -1;
     first->cost = 0.0f;
-
-    nav->head = 0;
+    first->order = nav->nextOrder++;
     
-    while (nav->head != -1)
+    NavSolver_HeapPush(nav, 0);
+    nav->polyNodes[startPoly->index] = 0;
+    
+    while (nav->heapCount > 0)
     {
-        // pull the first (lowest cost) node from the list
-        struct NavSearchNode* currentNode = nav->pool + nav->head;
+        // pull the lowest cost node from the heap
+        int currentIndex = NavSolver_HeapPop(nav);
+        struct NavSearchNode* currentNode = nav->pool + currentIndex;
         
         Vec3 currentPoint = startPoint;
         if (currentNode->edgeIndex != -1)
@@ -151,8 +258,7 @@ int NavSolver_Solve(NavSolver* nav,
         }
         
         // move from open list to closed
-        nav->head = currentNode->next;
-        currentNode->next = -1;
+        nav->polyNodes[currentNode->polyIndex] = -1;
         nav->closed[currentNode->polyIndex] = 1;
 
         // we found target!
@@ -200,108 +306,38 @@ int NavSolver_Solve(NavSolver* nav,
             if (nav->closed[neighbor->index] == 1)
                 continue; // this node has already been evaluated
             
-            // find the node if it is already in the open list
-            struct NavSearchNode* toInsert = NULL;
+            // find the node if it is already in the open list, otherwise allocate from the pool
+            int toInsertIndex = nav->polyNodes[neighbor->index];
+            int isOpen = toInsertIndex != -1;
             
-            if (nav->head != -1)
+            if (!isOpen)
             {
-                struct NavSearchNode* node = nav->pool + nav->head;
-                struct NavSearchNode* previous = NULL;
+                toInsertIndex = stb__sbn(nav->pool);
+                stb_sb_add(nav->pool, 1);
+                nav->polyNodes[neighbor->index] = toInsertIndex;
                 
-                while (node)
-                {
-                    if (node->polyIndex == neighbor->index)
-                    {
-                        toInsert = node;
-                        
-                        if (previous)
-                        {
-                            previous->next = toInsert->next;
-                        }
-                        else
-                        {
-                            nav->head = toInsert->next;
-                        }
-                        break;
-                    }
-                    
-                    previous = node;
-                    
-                    if (node->next != -1)
-                    {
-                        node = nav->pool + node->next;
-                    }
-                    else
-                    {
-                        node = NULL;
-                    }
-                }
+                /* adding can move the pool */
+                currentNode = nav->pool + currentIndex;
             }
-
-            // if we didn't find a slot, allocate from the pool
-            if (!toInsert)
-                toInsert = stb_sb_add(nav->pool, 1);
+            
+            struct NavSearchNode* toInsert = nav->pool + toInsertIndex;
             
             Vec3 edgeCenter = Vec3_Lerp(mesh->vertices[edge->vertices[0]], mesh->vertices[edge->vertices[1]], 0.5f);
             
             float heuristic = Vec3_Dist(edgeCenter, endPoint) * 1.5f;
+            
+            /* an open node always takes the latest cost and goes behind its equals, as in the sorted list this replaced */
             toInsert->cost = currentNode->cost + Vec3_Dist(edgeCenter, currentPoint) + heuristic;
+            toInsert->order = nav->nextOrder++;
 
             toInsert->polyIndex = neighbor->index;
             toInsert->edgeIndex = currentPoly->edgeStart + i;
-            toInsert->parent = (int)(currentNode - nav->pool);
-            toInsert->next = -1;
+            toInsert->parent = currentIndex;
 
-            int toInsertIndex = (int)(toInsert - nav->pool);
-
-            // sorted insertion
-            if (nav->head == -1)
-            {
-                nav->head = toInsertIndex;
-            }
+            if (isOpen)
+                NavSolver_HeapUpdate(nav, toInsertIndex);
             else
-            {
-                struct NavSearchNode* node = nav->pool + nav->head;
-                struct NavSearchNode* previous = NULL;
-                
-                int inserted = 0;
-                
-                while (node)
-                {
-                    if (toInsert->cost < node->cost)
-                    {
-                        toInsert->next = (int)(node - nav->pool);
-                        
-                        if (previous)
-                        {
-                            previous->next = toInsertIndex;
-                        }
-                        else
-                        {
-                            nav->head = toInsertIndex;
-                        }
-                        inserted = 1;
-                        break;
-                    }
-                    
-                    previous = node;
-                    
-                    if (node->next != -1)
-                    {
-                        node = nav->pool + node->next;
-                    }
-                    else
-                    {
-                        node = NULL;
-                    }
-                }
-                
-                if (!inserted)
-                {
-                    assert(previous);
-                    previous->next = toInsertIndex;
-                }
-            }
+                NavSolver_HeapPush(nav, toInsertIndex);
         }
     }
 
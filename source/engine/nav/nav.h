@@ -36,17 +36,27 @@ struct NavSearchNode
     short edgeIndex;
     float cost;
     
+    /* breaks cost ties, first in first out */
+    unsigned int order;
+    
     // since the pool address is not stable, we need to use indicies
-    int next;
+    int heapIndex;
     int parent;
 };
 
 typedef struct
 {
-    int head;
     struct NavSearchNode* pool;
     char* closed;
     
+    /* open list, a binary heap of pool indices ordered by cost */
+    int heapCount;
+    int* heap;
+    
+    /* pool index of each poly's open node, -1 if it has none */
+    int* polyNodes;
+    
+    unsigned int nextOrder;
 } NavSolver;
 
 extern int NavSolver_Init(NavSolver* nav);
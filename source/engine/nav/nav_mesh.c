@@ -15,6 +15,10 @@ int NavMesh_Init(NavMesh* mesh,
     mesh->polyCount = polyCount;
     mesh->edgeCount = edgeCount;
     
+    mesh->bvhNodeCount = 0;
+    mesh->bvhNodes = NULL;
+    mesh->bvhPolys = NULL;
+    
     mesh->vertices = malloc(sizeof(Vec3) * vertexCount);
     if (!mesh->vertices)
         return 0;
@@ -44,6 +48,14 @@ void NavMesh_Shutdown(NavMesh* mesh)
         free(mesh->polys);
     if (mesh->edges)
         free(mesh->edges);
+    if (mesh->bvhNodes)
+        free(mesh->bvhNodes);
+    if (mesh->bvhPolys)
+        free(mesh->bvhPolys);
+    
+    mesh->bvhNodeCount = 0;
+    mesh->bvhNodes = NULL;
+    mesh->bvhPolys = NULL;
 }
 
 NavPoly* NavMesh_GetPolyNeighbor(const NavMesh* mesh,
@@ -61,60 +73,160 @@ NavPoly* NavMesh_GetPolyNeighbor(const NavMesh* mesh,
     return mesh->polys + edge->neighborIndex;
 }
 
+/* keeps the poly if the ray hits it nearer than min. Ties go to the lower index, as when every poly was tested in order */
+static void NavMesh_RayPoly(const NavMesh* mesh, NavPoly* poly, Ray3 ray, float* min, NavPoly** result)
+{
+    float t;
+    
+    if (!Plane_IntersectRay(poly->plane, ray, &t))
+        return;
+    
+    if (t < 0.0f || t > *min)
+        return;
+    
+    if (t == *min && *result && (*result)->index < poly->index)
+        return;
+    
+    Vec3 intersection = Ray3_Slide(ray, t);
+    
+    const NavEdge* originEdge = mesh->edges + poly->edgeStart;
+    Vec3 origin = mesh->vertices[originEdge->vertices[0]];
+    
+    // get vector in polygon
+    Vec3 rightVec = Vec3_Sub(mesh->vertices[originEdge->vertices[1]], origin);
+    rightVec = Vec3_Norm(rightVec);
+    
+    // get up vector
+    Vec3 upVec = Vec3_Norm(Vec3_Cross(rightVec, poly->plane.normal));
+    
+    // transform intersection into vector space
+    Vec2 intersection2;
+    intersection2.x = Vec3_Dot(Vec3_Sub(intersection, origin), rightVec);
+    intersection2.y = Vec3_Dot(Vec3_Sub(intersection, origin), upVec);
+    
+    // project polygon edge points into face local vector space
+    
+    assert(poly->edgeCount <= NAV_POLY_EDGES_MAX);
+    
+    Vec2 verts[NAV_POLY_EDGES_MAX];
+    for (int j = 0; j < poly->edgeCount; ++j)
+    {
+        const NavEdge* edge = mesh->edges + poly->edgeStart + j;
+        
+        Vec3 pa = Vec3_Sub(mesh->vertices[edge->vertices[0]], origin);
+        
+        verts[j].x = Vec3_Dot(pa, rightVec);
+        verts[j].y = Vec3_Dot(pa, upVec);
+    }
+    
+    if (Geo_PointInPoly(poly->edgeCount, verts, intersection2))
+    {
+        *min = t;
+        *result = poly;
+    }
+}
+
+/* slab test. Misses boxes behind the ray or entered beyond max, otherwise t is where the ray enters */
+static int NavMesh_RayBox(AABB b, Ray3 ray, float max, float* t)
+{
+    float tmin = 0.0f;
+    float tmax = max;
+    
+    for (int i = 0; i < 3; ++i)
+    {
+        float origin = Vec3_Get(ray.origin, i);
+        float dir = Vec3_Get(ray.dir, i);
+        float lo = Vec3_Get(b.min, i);
+        float hi = Vec3_Get(b.max, i);
+        
+        if (dir == 0.0f)
+        {
+            if (origin < lo || origin > hi)
+                return 0;
+            
+            continue;
+        }
+        
+        float t1 = (lo - origin) / dir;
+        float t2 = (hi - origin) / dir;
+        
+        tmin = MAX(tmin, MIN(t1, t2));
+        tmax = MIN(tmax, MAX(t1, t2));
+        
+        if (tmax < tmin)
+            return 0;
+    }
+    
+    *t = tmin;
+    return 1;
+}
+
 NavPoly* NavMesh_Raycast(const NavMesh* mesh, Ray3 ray, float* r)
 {
     float min = HUGE_VALF;
     NavPoly* result = NULL;
-    float t;
     
-    for (int i = 0; i < mesh->polyCount; ++i)
+    if (!mesh->bvhNodes)
+    {
+        for (int i = 0; i < mesh->polyCount; ++i)
+            NavMesh_RayPoly(mesh, mesh->polys + i, ray, &min, &result);
+    }
+    else
     {
-        NavPoly* poly = mesh->polys + i;
+        /* nodes to visit and where the ray enters them, nearest on top */
+        int stack[NAV_BVH_DEPTH_MAX];
+        float stackT[NAV_BVH_DEPTH_MAX];
+        int stackCount = 0;
+        
+        float t;
+        if (NavMesh_RayBox(mesh->bvhNodes[0].bounds, ray, min, &t))
+        {
+            stack[0] = 0;
+            stackT[0] = t;
+            stackCount = 1;
+        }
         
-        if (Plane_IntersectRay(poly->plane, ray, &t))
+        while (stackCount > 0)
         {
-            if (t < 0.0f)
+            --stackCount;
+            
+            /* a nearer hit may have been found since it was pushed */
+            if (stackT[stackCount] > min)
+                continue;
+            
+            const NavBvhNode* node = mesh->bvhNodes + stack[stackCount];
+            
+            if (node->count > 0)
             {
+                for (int i = node->first; i < node->first + node->count; ++i)
+                    NavMesh_RayPoly(mesh, mesh->polys + mesh->bvhPolys[i], ray, &min, &result);
+                
                 continue;
             }
             
-            if (t < min)
+            float ta;
+            float tb;
+            int hitA = NavMesh_RayBox(mesh->bvhNodes[node->first].bounds, ray, min, &ta);
+            int hitB = NavMesh_RayBox(mesh->bvhNodes[node->first + 1].bounds, ray, min, &tb);
+            
+            /* far child first so the near one is visited next */
+            if (hitA && hitB && ta < tb)
             {
-                Vec3 intersection = Ray3_Slide(ray, t);
-                
-                const NavEdge* originEdge = mesh->edges + poly->edgeStart;
-                Vec3 origin = mesh->vertices[originEdge->vertices[0]];
-                
-                // get vector in polygon
-                Vec3 rightVec = Vec3_Sub(mesh->vertices[originEdge->vertices[1]], origin);
-                rightVec = Vec3_Norm(rightVec);
-                
-                // get up vector
-                Vec3 upVec = Vec3_Norm(Vec3_Cross(rightVec, poly->plane.normal));
-                
-                // transform intersection into vector space
-                Vec2 intersection2;
-                intersection2.x = Vec3_Dot(Vec3_Sub(intersection, origin), rightVec);
-                intersection2.y = Vec3_Dot(Vec3_Sub(intersection, origin), upVec);
-                
-                // project polygon edge points into face local vector space
-                
-                Vec2 verts[poly->edgeCount];
-                for (int j = 0; j < poly->edgeCount; ++j)
-                {
-                    const NavEdge* edge = mesh->edges + poly->edgeStart + j;
-                                        
-                    Vec3 pa = Vec3_Sub(mesh->vertices[edge->vertices[0]], origin);
-
-                    verts[j].x = Vec3_Dot(pa, rightVec);
-                    verts[j].y = Vec3_Dot(pa, upVec);
-                }
-                
-                if (Geo_PointInPoly(poly->edgeCount, verts, intersection2))
-                {
-                    min = t;
-                    result = poly;
-                }
+                stack[stackCount] = node->first + 1;
+                stackT[stackCount++] = tb;
+                hitB = 0;
+            }
+            
+            if (hitA)
+            {
+                stack[stackCount] = node->first;
+                stackT[stackCount++] = ta;
+            }
+            
+            if (hitB)
+            {
+                stack[stackCount] = node->first + 1;
+                stackT[stackCount++] = tb;
             }
         }
     }
@@ -154,6 +266,159 @@ int NavMesh_LineEdgeCast(const NavMesh* mesh,
     return 0;
 }
 
+/* sort key for building, twice the center of the poly's bounds on axis */
+static float NavMesh_PolyKey(const AABB* polyBounds, unsigned short poly, int axis)
+{
+    return Vec3_Get(polyBounds[poly].min, axis) + Vec3_Get(polyBounds[poly].max, axis);
+}
+
+/* partially orders polys so none before k has a larger key and none after has a smaller one */
+static void NavMesh_SelectPolys(unsigned short* polys, int count, int k, const AABB* polyBounds, int axis)
+{
+    int lo = 0;
+    int hi = count - 1;
+    
+    while (lo < hi)
+    {
+        float pivot = NavMesh_PolyKey(polyBounds, polys[(lo + hi) / 2], axis);
+        int i = lo;
+        int j = hi;
+        
+        while (i <= j)
+        {
+            while (NavMesh_PolyKey(polyBounds, polys[i], axis) < pivot) ++i;
+            while (NavMesh_PolyKey(polyBounds, polys[j], axis) > pivot) --j;
+            
+            if (i <= j)
+            {
+                unsigned short temp = polys[i];
+                polys[i] = polys[j];
+                polys[j] = temp;
+                ++i;
+                --j;
+            }
+        }
+        
+        if (k <= j)
+            hi = j;
+        else if (k >= i)
+            lo = i;
+        else
+            break;
+    }
+}
+
+static void NavMesh_BuildNode(NavMesh* mesh, const AABB* polyBounds, int nodeIndex, int first, int count)
+{
+    NavBvhNode* node = mesh->bvhNodes + nodeIndex;
+    
+    AABB bounds = polyBounds[mesh->bvhPolys[first]];
+    Vec3 keyMin = Vec3_Add(bounds.min, bounds.max);
+    Vec3 keyMax = keyMin;
+    
+    for (int i = first + 1; i < first + count; ++i)
+    {
+        AABB b = polyBounds[mesh->bvhPolys[i]];
+        bounds.min = Vec3_Create(MIN(bounds.min.x, b.min.x), MIN(bounds.min.y, b.min.y), MIN(bounds.min.z, b.min.z));
+        bounds.max = Vec3_Create(MAX(bounds.max.x, b.max.x), MAX(bounds.max.y, b.max.y), MAX(bounds.max.z, b.max.z));
+        
+        Vec3 key = Vec3_Add(b.min, b.max);
+        keyMin = Vec3_Create(MIN(keyMin.x, key.x), MIN(keyMin.y, key.y), MIN(keyMin.z, key.z));
+        keyMax = Vec3_Create(MAX(keyMax.x, key.x), MAX(keyMax.y, key.y), MAX(keyMax.z, key.z));
+    }
+    
+    node->bounds = bounds;
+    
+    if (count <= NAV_BVH_LEAF_MAX)
+    {
+        node->first = first;
+        node->count = count;
+        return;
+    }
+    
+    /* split the longest spread of centers at the median */
+    Vec3 spread = Vec3_Sub(keyMax, keyMin);
+    int axis = 0;
+    
+    if (spread.y > Vec3_Get(spread, axis)) axis = 1;
+    if (spread.z > Vec3_Get(spread, axis)) axis = 2;
+    
+    int half = count / 2;
+    NavMesh_SelectPolys(mesh->bvhPolys + first, count, half, polyBounds, axis);
+    
+    int child = mesh->bvhNodeCount;
+    mesh->bvhNodeCount += 2;
+    
+    node->first = child;
+    node->count = 0;
+    
+    NavMesh_BuildNode(mesh, polyBounds, child, first, half);
+    NavMesh_BuildNode(mesh, polyBounds, child + 1, first + half, count - half);
+}
+
+int NavMesh_BuildBvh(NavMesh* mesh)
+{
+    if (mesh->bvhNodes)
+        free(mesh->bvhNodes);
+    if (mesh->bvhPolys)
+        free(mesh->bvhPolys);
+    
+    mesh->bvhNodeCount = 0;
+    mesh->bvhNodes = NULL;
+    mesh->bvhPolys = NULL;
+    
+    if (mesh->polyCount == 0)
+        return 1;
+    
+    AABB* polyBounds = malloc(sizeof(AABB) * mesh->polyCount);
+    mesh->bvhNodes = malloc(sizeof(NavBvhNode) * mesh->polyCount * 2);
+    mesh->bvhPolys = malloc(sizeof(unsigned short) * mesh->polyCount);
+    
+    if (!polyBounds || !mesh->bvhNodes || !mesh->bvhPolys)
+    {
+        free(polyBounds);
+        free(mesh->bvhNodes);
+        free(mesh->bvhPolys);
+        mesh->bvhNodes = NULL;
+        mesh->bvhPolys = NULL;
+        return 0;
+    }
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        const NavPoly* poly = mesh->polys + i;
+        const NavEdge* edge = mesh->edges + poly->edgeStart;
+        
+        Vec3 min = mesh->vertices[edge->vertices[0]];
+        Vec3 max = min;
+        
+        /* raycasts hit the poly's plane, which can sit off vertices that aren't quite coplanar */
+        float offPlane = 0.0f;
+        
+        for (int j = 0; j < poly->edgeCount; ++j)
+        {
+            for (int k = 0; k < 2; ++k)
+            {
+                Vec3 p = mesh->vertices[edge[j].vertices[k]];
+                min = Vec3_Create(MIN(min.x, p.x), MIN(min.y, p.y), MIN(min.z, p.z));
+                max = Vec3_Create(MAX(max.x, p.x), MAX(max.y, p.y), MAX(max.z, p.z));
+                
+                offPlane = MAX(offPlane, fabsf(Vec3_Dot(Vec3_Sub(p, poly->plane.point), poly->plane.normal)));
+            }
+        }
+        
+        float pad = offPlane + 0.01f;
+        polyBounds[i] = AABB_Create(Vec3_Offset(min, -pad, -pad, -pad), Vec3_Offset(max, pad, pad, pad));
+        mesh->bvhPolys[i] = i;
+    }
+    
+    mesh->bvhNodeCount = 1;
+    NavMesh_BuildNode(mesh, polyBounds, 0, 0, mesh->polyCount);
+    
+    free(polyBounds);
+    return 1;
+}
+
 static int NavMesh_FromNAV(NavMesh* mesh, FILE* file)
 {
     int vertCount = -1;
@@ -239,9 +504,19 @@ static int NavMesh_FromNAV(NavMesh* mesh, FILE* file)
                 mesh->polys[i].index = i;
                 
                 fgets(lineBuffer, LINE_BUFFER_MAX, file);
-                sscanf(lineBuffer, "%hu, %hu",
-                       &mesh->polys[i].edgeStart,
-                       &mesh->polys[i].edgeCount);
+                if (sscanf(lineBuffer, "%hu, %hu",
+                           &mesh->polys[i].edgeStart,
+                           &mesh->polys[i].edgeCount) != 2)
+                {
+                    return 0;
+                }
+                
+                if (mesh->polys[i].edgeCount < 3 ||
+                    mesh->polys[i].edgeCount > NAV_POLY_EDGES_MAX ||
+                    mesh->polys[i].edgeStart + mesh->polys[i].edgeCount > edgeCount)
+                {
+                    return 0;
+                }
                 
                 fgets(lineBuffer, LINE_BUFFER_MAX, file);
                 sscanf(lineBuffer, "%f, %f, %f",
@@ -324,6 +599,9 @@ int NavMesh_FromPath(NavMesh* mesh, const char* path)
     if (!status)
         return 0;
     
+    /* raycasts fall back to testing every poly without it */
+    NavMesh_BuildBvh(mesh);
+    
     return 1;
 }
 
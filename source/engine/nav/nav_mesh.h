@@ -27,6 +27,9 @@ typedef struct
     unsigned short vertices[2];
 } NavEdge;
 
+/* edges a poly may have. Raycasts project a poly's corners into a buffer this size */
+#define NAV_POLY_EDGES_MAX 32
+
 typedef struct
 {
     // index into mesh edges
@@ -40,6 +43,21 @@ typedef struct
     unsigned short index;
 } NavPoly;
 
+/* polys per leaf of the raycast hierarchy */
+#define NAV_BVH_LEAF_MAX 4
+
+/* raycast stack. Splits are at the median, so depth stays near log2 of the poly count */
+#define NAV_BVH_DEPTH_MAX 32
+
+typedef struct
+{
+    AABB bounds;
+    
+    /* leaves hold count polys from first in bvhPolys.
+     inner nodes have count 0 and their children at first and first + 1 */
+    int first;
+    int count;
+} NavBvhNode;
 
 typedef struct
 {
@@ -50,6 +68,11 @@ typedef struct
     Vec3* vertices;
     NavPoly* polys;
     NavEdge* edges;
+    
+    /* bounding volume hierarchy over the polys, for raycasts */
+    int bvhNodeCount;
+    NavBvhNode* bvhNodes;
+    unsigned short* bvhPolys;
 } NavMesh;
 
 extern int NavMesh_Init(NavMesh* mesh,
@@ -59,6 +82,9 @@ extern int NavMesh_Init(NavMesh* mesh,
 
 extern int NavMesh_FromPath(NavMesh* mesh, const char* path);
 
+/* builds the raycast hierarchy once vertices, edges and polys are filled. NavMesh_FromPath calls this */
+extern int NavMesh_BuildBvh(NavMesh* mesh);
+
 extern void NavMesh_Shutdown(NavMesh* mesh);
 
 
@@ -69,6 +95,7 @@ extern NavPoly* NavMesh_GetPolyNeighbor(const NavMesh* mesh,
                                         int edgeIndex);
 
 
+/* nearest poly hit in front of the ray. Tests every poly if the hierarchy isn't built */
 extern NavPoly* NavMesh_Raycast(const NavMesh* mesh, Ray3 ray, float* t);
 
 
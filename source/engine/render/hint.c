@@ -17,12 +17,20 @@ void HintBuffer_Clear(HintBuffer* buffer)
     buffer->vertCount = 0;
 }
 
+/* hints that don't fit are dropped, they're only for debugging */
+static int HintBuffer_Fits(const HintBuffer* buffer, int vertCount, int indexCount)
+{
+    return buffer->vertCount + vertCount <= HINT_VERTS_MAX && buffer->indexCount + indexCount <= HINT_VERTS_MAX;
+}
+
 void HintBuffer_PackCircle(HintBuffer* buffer,
                            float radius,
                            Vec3 position,
                            Vec3 color,
                            int slices)
 {
+    if (!HintBuffer_Fits(buffer, slices + 1, slices * 2))
+        return;
     
     /* starting item */
     
@@ -57,7 +65,9 @@ void HintBuffer_PackLine(HintBuffer* buffer,
                          const Vec3 end,
                          const Vec3 color)
 {
-
+    if (!HintBuffer_Fits(buffer, 2, 2))
+        return;
+    
     buffer->verts[buffer->vertCount].pos = start;
     buffer->verts[buffer->vertCount].color = color;
     ++buffer->vertCount;
@@ -76,6 +86,8 @@ void HintBuffer_PackAABB(HintBuffer* buffer,
                          AABB aabb,
                          Vec3 color)
 {
+    if (!HintBuffer_Fits(buffer, 8, 16))
+        return;
     
     buffer->verts[buffer->vertCount].pos = Vec3_Create(aabb.min.x, aabb.min.y, aabb.min.z);
     buffer->verts[buffer->vertCount].color = color;
@@ -167,6 +179,9 @@ void Hintbuffer_PackSkel(HintBuffer* buffer,
     }
      */
     
+    if (!HintBuffer_Fits(buffer, skel->attachPointCount * 2, skel->attachPointCount * 2))
+        return;
+    
     int i;
     for (i = 0; i < skel->attachPointCount; ++i)
     {
@@ -194,6 +209,9 @@ void HintBuffer_PackPath(HintBuffer* buffer,
                          const NavPath* path,
                          Vec3 color)
 {
+    if (!HintBuffer_Fits(buffer, path->nodeCount + 1, path->nodeCount * 2))
+        return;
+    
     buffer->verts[buffer->vertCount].pos = path->nodes[0].position;
     buffer->verts[buffer->vertCount].color = color;
     ++buffer->vertCount;
@@ -223,6 +241,9 @@ void HintBuffer_PackNav(HintBuffer* buffer,
         {
             const NavEdge* edge = mesh->edges + poly->edgeStart + j;
             
+            if (!HintBuffer_Fits(buffer, 2, 2))
+                return;
+            
             Vec3 va = mesh->vertices[edge->vertices[0]];
             Vec3 vb = mesh->vertices[edge->vertices[1]];
             
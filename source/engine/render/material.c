@@ -7,6 +7,7 @@ void Material_Init(Material* material)
     material->albedoMap = -1;
     material->normalMap = -1;
     material->specularMap = -1;
+    material->glossMap = -1;
 }
 
 void Material_Copy(Material* dest, const Material* source)
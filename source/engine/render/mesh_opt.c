@@ -0,0 +1,337 @@
+
+#include "mesh_opt.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* scoring constants from the paper */
+#define MESH_OPT_DECAY_POWER 1.5f
+#define MESH_OPT_LAST_TRI_SCORE 0.75f
+#define MESH_OPT_VALENCE_SCALE 2.0f
+#define MESH_OPT_VALENCE_POWER 0.5f
+#define MESH_OPT_VALENCE_TABLE 32
+
+static float g_cacheScores[MESH_OPT_CACHE_SIZE];
+static float g_valenceScores[MESH_OPT_VALENCE_TABLE];
+static int g_scoresReady = 0;
+
+static void MeshOpt_InitScores()
+{
+    for (int i = 0; i < MESH_OPT_CACHE_SIZE; ++i)
+    {
+        if (i < 3)
+        {
+            /* the last triangle's verts are scored flat, so its neighbours aren't favored by winding */
+            g_cacheScores[i] = MESH_OPT_LAST_TRI_SCORE;
+        }
+        else
+        {
+            float scaler = 1.0f - (i - 3) / (float)(MESH_OPT_CACHE_SIZE - 3);
+            g_cacheScores[i] = powf(scaler, MESH_OPT_DECAY_POWER);
+        }
+    }
+
+    g_valenceScores[0] = 0.0f;
+    for (int i = 1; i < MESH_OPT_VALENCE_TABLE; ++i)
+        g_valenceScores[i] = MESH_OPT_VALENCE_SCALE * powf((float)i, -MESH_OPT_VALENCE_POWER);
+
+    g_scoresReady = 1;
+}
+
+static float MeshOpt_VertexScore(int cachePosition, unsigned int remaining)
+{
+    /* no triangles left to use it */
+    if (remaining == 0)
+        return -1.0f;
+
+    float score = (cachePosition >= 0) ? g_cacheScores[cachePosition] : 0.0f;
+
+    /* low valence verts are finished first, to avoid leaving lone triangles behind */
+    if (remaining < MESH_OPT_VALENCE_TABLE)
+        score += g_valenceScores[remaining];
+    else
+        score += MESH_OPT_VALENCE_SCALE * powf((float)remaining, -MESH_OPT_VALENCE_POWER);
+
+    return score;
+}
+
+int MeshOpt_OrderTriangles(unsigned int* indices, unsigned int indexCount, unsigned int vertCount)
+{
+    unsigned int triCount = indexCount / 3;
+
+    if (triCount < 2)
+        return 1;
+
+    if (!g_scoresReady)
+        MeshOpt_InitScores();
+
+    /* triangles using each vert, live ones are kept at the front of each vert's range */
+    unsigned int* adjacencyStart = calloc(vertCount + 1, sizeof(unsigned int));
+    unsigned int* remaining = calloc(vertCount, sizeof(unsigned int));
+    unsigned int* adjacency = malloc(sizeof(unsigned int) * triCount * 3);
+    int* cachePositions = malloc(sizeof(int) * vertCount);
+    float* vertScores = malloc(sizeof(float) * vertCount);
+    float* triScores = malloc(sizeof(float) * triCount);
+    unsigned char* triAdded = calloc(triCount, 1);
+    unsigned int* ordered = malloc(sizeof(unsigned int) * triCount * 3);
+
+    int status = 0;
+
+    if (!adjacencyStart || !remaining || !adjacency || !cachePositions ||
+        !vertScores || !triScores || !triAdded || !ordered)
+        goto cleanup;
+
+    for (unsigned int i = 0; i < triCount * 3; ++i)
+        ++remaining[indices[i]];
+
+    for (unsigned int v = 0; v < vertCount; ++v)
+        adjacencyStart[v + 1] = adjacencyStart[v] + remaining[v];
+
+    memset(remaining, 0, sizeof(unsigned int) * vertCount);
+
+    for (unsigned int t = 0; t < triCount; ++t)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            unsigned int v = indices[t * 3 + k];
+            adjacency[adjacencyStart[v] + remaining[v]++] = t;
+        }
+    }
+
+    for (unsigned int v = 0; v < vertCount; ++v)
+    {
+        cachePositions[v] = -1;
+        vertScores[v] = MeshOpt_VertexScore(-1, remaining[v]);
+    }
+
+    int bestTri = -1;
+    float bestScore = -1.0f;
+
+    for (unsigned int t = 0; t < triCount; ++t)
+    {
+        const unsigned int* tri = indices + t * 3;
+        triScores[t] = vertScores[tri[0]] + vertScores[tri[1]] + vertScores[tri[2]];
+
+        if (triScores[t] > bestScore)
+        {
+            bestScore = triScores[t];
+            bestTri = t;
+        }
+    }
+
+    /* modelled LRU cache, with room for the 3 verts pushed by each triangle */
+    unsigned int cache[MESH_OPT_CACHE_SIZE + 3];
+    int cacheCount = 0;
+
+    /* fallback scan position when nothing in the cache has triangles left */
+    unsigned int scanTri = 0;
+
+    for (unsigned int outTri = 0; outTri < triCount; ++outTri)
+    {
+        if (bestTri < 0)
+        {
+            while (triAdded[scanTri])
+                ++scanTri;
+
+            bestTri = scanTri;
+        }
+
+        const unsigned int* tri = indices + bestTri * 3;
+
+        ordered[outTri * 3 + 0] = tri[0];
+        ordered[outTri * 3 + 1] = tri[1];
+        ordered[outTri * 3 + 2] = tri[2];
+        triAdded[bestTri] = 1;
+
+        /* take the triangle out of each vert's live range */
+        for (int k = 0; k < 3; ++k)
+        {
+            unsigned int v = tri[k];
+            unsigned int* list = adjacency + adjacencyStart[v];
+
+            for (unsigned int j = 0; j < remaining[v]; ++j)
+            {
+                if (list[j] == bestTri)
+                {
+                    list[j] = list[remaining[v] - 1];
+                    break;
+                }
+            }
+
+            --remaining[v];
+        }
+
+        /* move the triangle's verts to the front */
+        unsigned int newCache[MESH_OPT_CACHE_SIZE + 3];
+        int newCount = 0;
+
+        for (int k = 0; k < 3; ++k)
+            newCache[newCount++] = tri[k];
+
+        for (int j = 0; j < cacheCount; ++j)
+        {
+            unsigned int v = cache[j];
+
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                newCache[newCount++] = v;
+        }
+
+        /* verts falling out of the modelled cache lose their position score */
+        for (int j = MESH_OPT_CACHE_SIZE; j < newCount; ++j)
+        {
+            unsigned int v = newCache[j];
+            cachePositions[v] = -1;
+            vertScores[v] = MeshOpt_VertexScore(-1, remaining[v]);
+        }
+
+        cacheCount = newCount < MESH_OPT_CACHE_SIZE ? newCount : MESH_OPT_CACHE_SIZE;
+        memcpy(cache, newCache, sizeof(unsigned int) * cacheCount);
+
+        for (int j = 0; j < cacheCount; ++j)
+        {
+            unsigned int v = cache[j];
+            cachePositions[v] = j;
+            vertScores[v] = MeshOpt_VertexScore(j, remaining[v]);
+        }
+
+        /* only triangles touching the cache changed score */
+        bestTri = -1;
+        bestScore = -1.0f;
+
+        for (int j = 0; j < cacheCount; ++j)
+        {
+            unsigned int v = cache[j];
+            const unsigned int* list = adjacency + adjacencyStart[v];
+
+            for (unsigned int n = 0; n < remaining[v]; ++n)
+            {
+                unsigned int t = list[n];
+                const unsigned int* other = indices + t * 3;
+
+                triScores[t] = vertScores[other[0]] + vertScores[other[1]] + vertScores[other[2]];
+
+                if (triScores[t] > bestScore)
+                {
+                    bestScore = triScores[t];
+                    bestTri = t;
+                }
+            }
+        }
+    }
+
+    memcpy(indices, ordered, sizeof(unsigned int) * triCount * 3);
+    status = 1;
+
+cleanup:
+    free(adjacencyStart);
+    free(remaining);
+    free(adjacency);
+    free(cachePositions);
+    free(vertScores);
+    free(triScores);
+    free(triAdded);
+    free(ordered);
+
+    return status;
+}
+
+void MeshOpt_OrderVertices(unsigned int* indices, unsigned int indexCount, unsigned int vertCount, unsigned int* remap)
+{
+    for (unsigned int v = 0; v < vertCount; ++v)
+        remap[v] = ~0u;
+
+    unsigned int next = 0;
+
+    for (unsigned int i = 0; i < indexCount; ++i)
+    {
+        unsigned int v = indices[i];
+
+        if (remap[v] == ~0u)
+            remap[v] = next++;
+
+        indices[i] = remap[v];
+    }
+
+    for (unsigned int v = 0; v < vertCount; ++v)
+    {
+        if (remap[v] == ~0u)
+            remap[v] = next++;
+    }
+}
+
+int MeshOpt_Remap(void* verts, unsigned int vertCount, size_t vertSize, const unsigned int* remap)
+{
+    unsigned char* source = malloc(vertSize * vertCount);
+
+    if (!source)
+        return 0;
+
+    memcpy(source, verts, vertSize * vertCount);
+
+    unsigned char* dest = verts;
+    for (unsigned int v = 0; v < vertCount; ++v)
+        memcpy(dest + remap[v] * vertSize, source + v * vertSize, vertSize);
+
+    free(source);
+    return 1;
+}
+
+int MeshOpt_Optimize(unsigned int* indices, unsigned int indexCount, void* verts, unsigned int vertCount, size_t vertSize)
+{
+    if (!MeshOpt_OrderTriangles(indices, indexCount, vertCount))
+        return 0;
+
+    unsigned int* remap = malloc(sizeof(unsigned int) * vertCount);
+    if (!remap)
+        return 0;
+
+    MeshOpt_OrderVertices(indices, indexCount, vertCount, remap);
+    int status = MeshOpt_Remap(verts, vertCount, vertSize, remap);
+
+    free(remap);
+    return status;
+}
+
+int MeshOpt_IndexSize(unsigned int vertCount)
+{
+    return (vertCount <= 0x10000) ? 2 : 4;
+}
+
+short MeshOpt_PackSnorm16(float x)
+{
+    return (short)roundf(fminf(fmaxf(x, -1.0f), 1.0f) * 32767.0f);
+}
+
+float MeshOpt_ACMR(const unsigned int* indices, unsigned int indexCount, unsigned int vertCount, int cacheSize)
+{
+    unsigned int triCount = indexCount / 3;
+
+    if (triCount == 0)
+        return 0.0f;
+
+    /* FIFO, as most hardware behaves. each vert remembers when it entered */
+    unsigned int* entered = malloc(sizeof(unsigned int) * vertCount);
+
+    if (!entered)
+        return 0.0f;
+
+    for (unsigned int v = 0; v < vertCount; ++v)
+        entered[v] = 0;
+
+    unsigned int misses = 0;
+
+    for (unsigned int i = 0; i < indexCount; ++i)
+    {
+        unsigned int v = indices[i];
+
+        /* entered holds miss number + 1, 0 is never cached */
+        if (entered[v] == 0 || misses - (entered[v] - 1) > (unsigned int)cacheSize)
+        {
+            entered[v] = misses + 1;
+            ++misses;
+        }
+    }
+
+    free(entered);
+    return misses / (float)triCount;
+}
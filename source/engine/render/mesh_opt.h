@@ -0,0 +1,43 @@
+#ifndef MESH_OPT_H
+#define MESH_OPT_H
+
+#include <stddef.h>
+
+/*
+ Index buffer reordering and vertex quantizing shared by StaticMesh and SkelSkin.
+
+ Triangles are ordered for the post transform vertex cache using
+ Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+ https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+
+ Vertices are then renumbered in first use order so fetches walk the
+ vertex buffer forwards.
+ */
+
+/* modelled cache size used for scoring */
+#define MESH_OPT_CACHE_SIZE 32
+
+/* reorders triangles in place. returns 0 if out of memory, leaving indices untouched */
+extern int MeshOpt_OrderTriangles(unsigned int* indices, unsigned int indexCount, unsigned int vertCount);
+
+/* renumbers indices in first use order and fills remap[old] = new.
+ Unreferenced vertices go last. The caller moves its own vertex data with MeshOpt_Remap */
+extern void MeshOpt_OrderVertices(unsigned int* indices, unsigned int indexCount, unsigned int vertCount, unsigned int* remap);
+
+/* permutes an array of vertCount elements of vertSize bytes. returns 0 if out of memory */
+extern int MeshOpt_Remap(void* verts, unsigned int vertCount, size_t vertSize, const unsigned int* remap);
+
+/* orders triangles then verts, moving vertCount verts of vertSize bytes to match.
+ returns 0 if out of memory, which may leave the triangles ordered but not the verts */
+extern int MeshOpt_Optimize(unsigned int* indices, unsigned int indexCount, void* verts, unsigned int vertCount, size_t vertSize);
+
+/* bytes per index on the GPU for vertCount verts, 2 or 4 */
+extern int MeshOpt_IndexSize(unsigned int vertCount);
+
+/* [-1, 1] to a short, as GL normalizes signed shorts */
+extern short MeshOpt_PackSnorm16(float x);
+
+/* average cache miss ratio, vertex shader runs per triangle, for a FIFO cache of cacheSize */
+extern float MeshOpt_ACMR(const unsigned int* indices, unsigned int indexCount, unsigned int vertCount, int cacheSize);
+
+#endif
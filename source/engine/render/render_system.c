@@ -18,6 +18,10 @@ int RenderSystem_Init(RenderSystem* system,
         system->viewportHeight = renderHeight;
                 
         system->scaleFactor = 1.0f;
+        
+        system->cullStats.tested = 0;
+        system->cullStats.culled = 0;
+        system->cullStats.visible = 0;
                 
         system->renderer = renderer;
         system->renderer->init(system->renderer);
@@ -25,6 +29,8 @@ int RenderSystem_Init(RenderSystem* system,
         system->renderer->prepareHintBuffer(renderer, &engine->renderSystem.hintBuffer);
         system->renderer->prepareGuiBuffer(renderer, &engine->guiSystem.buffer);
         
+        TextureLoader_Init(&system->textureLoader);
+        
         return 1;
     }
     
@@ -33,11 +39,24 @@ int RenderSystem_Init(RenderSystem* system,
 
 void RenderSystem_Shutdown(RenderSystem* system, struct Engine* engine)
 {
+    TextureLoader_Shutdown(&system->textureLoader);
+    
     system->renderer->shutdown(system->renderer);
     system->renderer->cleanupGuiBuffer(system->renderer, &engine->guiSystem.buffer);
 }
 
 
+static int RenderSystem_FinishTexture(RenderSystem* system, Texture* tex)
+{
+    if (tex->width > system->renderer->limits.maxTextureSize)
+    {
+        printf("invalid texture size\n");
+        return 0;
+    }
+    
+    return system->renderer->uploadTexture(system->renderer, tex);
+}
+
 int RenderSystem_LoadTexture(RenderSystem* system, int texture, TextureFlags flags, const char* path)
 {
     Texture* tex = system->textures + texture;
@@ -54,13 +73,21 @@ int RenderSystem_LoadTexture(RenderSystem* system, int texture, TextureFlags fla
     
     if (Texture_FromPath(tex, flags, fullPath))
     {
-        if (tex->width > system->renderer->limits.maxTextureSize)
-        {
-            printf("invalid texture size\n");
-            return 0;
-        }
-        
-        return system->renderer->uploadTexture(system->renderer, tex);
+        return RenderSystem_FinishTexture(system, tex);
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+int RenderSystem_LoadTextureFile(RenderSystem* system, int texture, TextureFlags flags, FILE* file, const char* extension)
+{
+    Texture* tex = system->textures + texture;
+    
+    if (Texture_FromFile(tex, flags, file, extension))
+    {
+        return RenderSystem_FinishTexture(system, tex);
     }
     else
     {
@@ -68,6 +95,27 @@ int RenderSystem_LoadTexture(RenderSystem* system, int texture, TextureFlags fla
     }
 }
 
+int RenderSystem_UploadTexture(RenderSystem* system, int texture, Texture* decoded)
+{
+    Texture* tex = system->textures + texture;
+    
+    if (decoded->width > system->renderer->limits.maxTextureSize)
+    {
+        printf("invalid texture size\n");
+        Texture_Shutdown(decoded);
+        return 0;
+    }
+    
+    /* the renderer replaces the old GPU texture in place */
+    unsigned int gpuId = tex->gpuId;
+    Texture_Shutdown(tex);
+    
+    *tex = *decoded;
+    tex->gpuId = gpuId;
+    
+    return system->renderer->uploadTexture(system->renderer, tex);
+}
+
 int RenderSystem_LoadStaticModel(RenderSystem* system, int modelIndex, const char* path)
 {
     StaticModel* model = system->models + modelIndex;
@@ -92,6 +140,20 @@ int RenderSystem_LoadStaticModel(RenderSystem* system, int modelIndex, const cha
     }
 }
 
+int RenderSystem_LoadStaticModelMemory(RenderSystem* system, int modelIndex, const void* data, size_t size, const char* extension)
+{
+    StaticModel* model = system->models + modelIndex;
+    
+    if (StaticModel_FromMemory(model, data, size, extension))
+    {
+        return system->renderer->uploadMesh(system->renderer, &model->mesh);
+    }
+    else
+    {
+        return 0;
+    }
+}
+
 int RenderSystem_LoadAnim(RenderSystem* system, int animIndex, const char* path)
 {
     SkelAnim* anim = system->anims + animIndex;
@@ -115,6 +177,22 @@ int RenderSystem_LoadAnim(RenderSystem* system, int animIndex, const char* path)
     }
 }
 
+int RenderSystem_LoadAnimMemory(RenderSystem* system, int animIndex, const void* data, size_t size, const char* extension)
+{
+    return SkelAnim_FromMemory(system->anims + animIndex, data, size, extension);
+}
+
+static int RenderSystem_FinishSkelModel(RenderSystem* system, SkelModel* model)
+{
+    if (model->skel.jointCount > system->renderer->limits.maxSkelJoints)
+    {
+        printf("invalid skeleton size\n");
+        return 0;
+    }
+    
+    return system->renderer->uploadSkelSkin(system->renderer, &model->skin);
+}
+
 int RenderSystem_LoadSkelModel(RenderSystem* system, int modelIndex, const char* path)
 {
     SkelModel* model = system->skelModels + modelIndex;
@@ -131,13 +209,7 @@ int RenderSystem_LoadSkelModel(RenderSystem* system, int modelIndex, const char*
     
     if (SkelModel_FromPath(model, fullPath))
     {
-        if (model->skel.jointCount > system->renderer->limits.maxSkelJoints)
-        {
-            printf("invalid skeleton size\n");
-            return 0;
-        }
-        
-        return system->renderer->uploadSkelSkin(system->renderer, &model->skin);
+        return RenderSystem_FinishSkelModel(system, model);
     }
     else
     {
@@ -145,26 +217,84 @@ int RenderSystem_LoadSkelModel(RenderSystem* system, int modelIndex, const char*
     }
 }
 
+int RenderSystem_LoadSkelModelMemory(RenderSystem* system, int modelIndex, const void* data, size_t size, const char* extension)
+{
+    SkelModel* model = system->skelModels + modelIndex;
+    
+    if (SkelModel_FromMemory(model, data, size, extension))
+    {
+        return RenderSystem_FinishSkelModel(system, model);
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+static int RenderSystem_ActorVisible(const Frustum* cam, const SceneSystem* scene, int index)
+{
+    Sphere bounds;
+    
+    if (scene->actorRenderTypes[index] == kActorRenderStaticModel)
+    {
+        bounds = scene->actorStaticModels[index].mesh.bounds;
+    }
+    else
+    {
+        bounds = scene->actorSkelModels[index].skin.bounds;
+        bounds.radius *= RENDER_SYSTEM_SKEL_BOUNDS_SCALE;
+    }
+    
+    /* no bounds were fit, never cull */
+    if (bounds.radius <= 0.0f)
+        return 1;
+    
+    /* world matrix is rigid so the radius is unchanged */
+    bounds.origin = Mat4_MultVec3(scene->actorMatrices + index, bounds.origin);
+    return Frustum_SphereVisible(cam, bounds);
+}
+
 static void RenderSystem_Cull(Renderer* renderer,
                               const Frustum* cam,
                               const Engine* engine,
-                              RenderList* renderList)
+                              RenderQueue* queue,
+                              RenderCullStats* stats)
 {
-    for (int i = 0; i < SCENE_ACTORS_MAX; ++i)
+    stats->tested = 0;
+    stats->culled = 0;
+    stats->visible = 0;
+    
+    float invDepthRange = 1.0f / cam->far;
+    const SceneSystem* scene = &engine->sceneSystem;
+    
+    for (int j = 0; j < scene->liveCount; ++j)
     {
-        const Actor* actor = engine->sceneSystem.actors + i;
+        int i = scene->liveActors[j];
+        ActorRenderType renderType = scene->actorRenderTypes[i];
+        
+        if (renderType == kActorRenderNone) continue;
+        
+        ++stats->tested;
+        
+        if (!RenderSystem_ActorVisible(cam, scene, i))
+        {
+            ++stats->culled;
+            continue;
+        }
+        
+        ++stats->visible;
         
-        if (actor->dead) continue;
+        float depth = Vec3_Dist(cam->position, scene->actorPositions[i]) * invDepthRange;
         
-        if (actor->renderType == kActorRenderStaticModel)
+        if (renderType == kActorRenderStaticModel)
         {
-            renderList->staticActors[renderList->staticActorCount] = i;
-            ++renderList->staticActorCount;
+            const StaticModel* model = scene->actorStaticModels + i;
+            RenderQueue_Push(queue, RenderKey_Create(kRenderProgramStaticLit, &model->material, model->mesh.vaoGpuId, depth), i);
         }
-        else if (actor->renderType == kActorRenderSkelModel)
+        else if (renderType == kActorRenderSkelModel)
         {
-            renderList->skelActors[renderList->skelActorCount] = i;
-            ++renderList->skelActorCount;
+            const SkelModel* model = scene->actorSkelModels + i;
+            RenderQueue_Push(queue, RenderKey_Create(kRenderProgramSkelLit, &model->material, model->skin.vaoGpuId, depth), i);
         }
     }
 }
@@ -173,11 +303,11 @@ void RenderSystem_Render(RenderSystem* system,
                          const Frustum* cam,
                          const struct Engine* engine)
 {
-    RenderList list;
-    list.skelActorCount = 0;
-    list.staticActorCount = 0;
+    RenderQueue* queue = &system->renderQueue;
+    RenderQueue_Clear(queue);
     
-    RenderSystem_Cull(system->renderer, cam, engine, &list);
+    RenderSystem_Cull(system->renderer, cam, engine, queue, &system->cullStats);
+    RenderQueue_Sort(queue);
     
-    system->renderer->render(system->renderer, cam, engine, &list);
+    system->renderer->render(system->renderer, cam, engine, queue);
 }
@@ -4,6 +4,7 @@
 
 #include "renderer.h"
 #include "texture.h"
+#include "texture_loader.h"
 #include "skel_model.h"
 #include "static_model.h"
 #include "hint.h"
@@ -15,6 +16,16 @@
 #define RENDER_SYSTEM_MAX_ANIMS 64
 #define RENDER_SYSTEM_MAX_CUBEMAPS 8
 
+/* skinned bounds are fit in the rest pose, animation may extend past them */
+#define RENDER_SYSTEM_SKEL_BOUNDS_SCALE 1.25f
+
+/* results of the last cull, reset each frame */
+typedef struct
+{
+    int tested;
+    int culled;
+    int visible;
+} RenderCullStats;
 
 
 typedef struct RenderSystem
@@ -26,6 +37,9 @@ typedef struct RenderSystem
     
     float scaleFactor;
     
+    RenderCullStats cullStats;
+    RenderQueue renderQueue;
+    
     Renderer* renderer;
     
     BgBuffer bgBuffer;
@@ -37,6 +51,8 @@ typedef struct RenderSystem
     
     Texture textures[RENDER_SYSTEM_MAX_TEXTURES];
     SkelAnim anims[RENDER_SYSTEM_MAX_ANIMS];
+    
+    TextureLoader textureLoader;
         
 } RenderSystem;
 
@@ -53,6 +69,18 @@ extern void RenderSystem_Shutdown(RenderSystem* system, struct Engine* engine);
 /* upload NULL for path to unload - replace operations are safetly handled */
 extern int RenderSystem_LoadTexture(RenderSystem* system, int texture, TextureFlags flags, const char* path);
 
+/* load from an open stream (see AssetPack). extension selects the loader */
+extern int RenderSystem_LoadTextureFile(RenderSystem* system, int texture, TextureFlags flags, FILE* file, const char* extension);
+
+/* load from memory that stays put until the asset is unloaded, such as an AssetPack mapping.
+ Binary meshes and anims are used in place, see StaticModel_FromMemory */
+extern int RenderSystem_LoadStaticModelMemory(RenderSystem* system, int model, const void* data, size_t size, const char* extension);
+extern int RenderSystem_LoadAnimMemory(RenderSystem* system, int anim, const void* data, size_t size, const char* extension);
+extern int RenderSystem_LoadSkelModelMemory(RenderSystem* system, int model, const void* data, size_t size, const char* extension);
+
+/* uploads a texture decoded elsewhere (see TextureLoader) into a slot, taking its data */
+extern int RenderSystem_UploadTexture(RenderSystem* system, int texture, Texture* decoded);
+
 extern int RenderSystem_LoadStaticModel(RenderSystem* system, int model, const char* path);
 extern int RenderSystem_LoadAnim(RenderSystem* system, int anim, const char* path);
 
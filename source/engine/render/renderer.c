@@ -1,3 +1,93 @@
 
 #include "renderer.h"
+#include <string.h>
 
+#define RENDER_KEY_MAP_BITS 7
+#define RENDER_KEY_MAP_MASK 0x7F
+
+static RenderKey RenderKey_Map(int map)
+{
+    /* -1 (no map) becomes 0 */
+    return (RenderKey)((map + 1) & RENDER_KEY_MAP_MASK);
+}
+
+RenderKey RenderKey_Create(RenderProgram program,
+                           const Material* material,
+                           unsigned int meshGpuId,
+                           float depth)
+{
+    RenderKey materialBits = RenderKey_Map(material->albedoMap);
+    materialBits = (materialBits << RENDER_KEY_MAP_BITS) | RenderKey_Map(material->normalMap);
+    materialBits = (materialBits << RENDER_KEY_MAP_BITS) | RenderKey_Map(material->specularMap);
+    materialBits = (materialBits << RENDER_KEY_MAP_BITS) | RenderKey_Map(material->glossMap);
+    
+    RenderKey depthBits = (RenderKey)(CLAMP(depth, 0.0f, 1.0f) * 0xFFFF);
+    
+    return ((RenderKey)program << RENDER_KEY_PROGRAM_SHIFT) |
+        (materialBits << RENDER_KEY_MATERIAL_SHIFT) |
+        ((RenderKey)(meshGpuId & 0xFFFF) << RENDER_KEY_MESH_SHIFT) |
+        (depthBits << RENDER_KEY_DEPTH_SHIFT);
+}
+
+void RenderQueue_Clear(RenderQueue* queue)
+{
+    queue->count = 0;
+}
+
+void RenderQueue_Push(RenderQueue* queue, RenderKey key, int actor)
+{
+    if (queue->count >= SCENE_ACTORS_MAX)
+        return;
+    
+    RenderItem* item = queue->items + queue->count;
+    item->key = key;
+    item->actor = actor;
+    ++queue->count;
+}
+
+/* LSD radix sort, one byte per pass. Passes where every key shares the byte are skipped,
+ which is most of them since scenes only use a handful of programs and materials. */
+void RenderQueue_Sort(RenderQueue* queue)
+{
+    if (queue->count < 2)
+        return;
+    
+    RenderItem temp[SCENE_ACTORS_MAX];
+    
+    RenderItem* source = queue->items;
+    RenderItem* dest = temp;
+    
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        int offsets[256];
+        memset(offsets, 0, sizeof(offsets));
+        
+        for (int i = 0; i < queue->count; ++i)
+            ++offsets[(source[i].key >> shift) & 0xFF];
+        
+        if (offsets[(source[0].key >> shift) & 0xFF] == queue->count)
+            continue;
+        
+        int total = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            int count = offsets[i];
+            offsets[i] = total;
+            total += count;
+        }
+        
+        for (int i = 0; i < queue->count; ++i)
+        {
+            int bucket = (source[i].key >> shift) & 0xFF;
+            dest[offsets[bucket]] = source[i];
+            ++offsets[bucket];
+        }
+        
+        RenderItem* swap = source;
+        source = dest;
+        dest = swap;
+    }
+    
+    if (source != queue->items)
+        memcpy(queue->items, source, sizeof(RenderItem) * queue->count);
+}
@@ -9,6 +9,7 @@
 #include "gui_buffer.h"
 #include "hint.h"
 #include "scene_system.h"
+#include <stdint.h>
 
 #define RENDER_SYSTEM_LIGHTS_MAX 32
 
@@ -28,22 +29,73 @@ struct RenderSystem;
 struct Engine;
 
 
-/* Render list allows culling, preprocessing, and sorting before rendering. */
+/* Render queue allows culling, preprocessing, and sorting before rendering.
+ Each item carries a sort key packing the state it needs, most expensive to change first:
+ 
+ | program (4) | material (28) | mesh (16) | depth (16) |
+ 
+ After sorting, items that share a program, textures, or VAO are adjacent
+ so the renderer only needs to change state when the key changes. */
+
+typedef enum
+{
+    kRenderProgramSkelLit = 0,
+    kRenderProgramStaticLit,
+    kRenderProgramCount,
+} RenderProgram;
+
+typedef uint64_t RenderKey;
+
+#define RENDER_KEY_PROGRAM_SHIFT 60
+#define RENDER_KEY_MATERIAL_SHIFT 32
+#define RENDER_KEY_MESH_SHIFT 16
+#define RENDER_KEY_DEPTH_SHIFT 0
+
+#define RenderKey_Program(key) ((int)((key) >> RENDER_KEY_PROGRAM_SHIFT))
+#define RenderKey_Material(key) (((key) >> RENDER_KEY_MATERIAL_SHIFT) & 0xFFFFFFF)
+#define RenderKey_Mesh(key) (((key) >> RENDER_KEY_MESH_SHIFT) & 0xFFFF)
 
 typedef struct
 {
-    int skelActors[SCENE_ACTORS_MAX];
-    int skelActorCount;
-    
-    int staticActors[SCENE_ACTORS_MAX];
-    int staticActorCount;
+    RenderKey key;
+    int actor;
+} RenderItem;
+
+typedef struct
+{
+    RenderItem items[SCENE_ACTORS_MAX];
+    int count;
+} RenderQueue;
+
+/* depth is normalized 0 (near) to 1 (far) */
+extern RenderKey RenderKey_Create(RenderProgram program,
+                                  const Material* material,
+                                  unsigned int meshGpuId,
+                                  float depth);
+
+extern void RenderQueue_Clear(RenderQueue* queue);
+extern void RenderQueue_Push(RenderQueue* queue, RenderKey key, int actor);
+
+/* radix sort by key */
+extern void RenderQueue_Sort(RenderQueue* queue);
+
+/* reset by the renderer each frame */
+typedef struct
+{
+    int drawCalls;
+    int bindsAvoided;
     
-} RenderList;
+    /* vertex shader runs spent skinning into the skin cache */
+    int skinnedVerts;
+} RendererStats;
 
 typedef struct
 {
     unsigned short maxTextureSize;
     unsigned short maxSkelJoints;
+    
+    /* DXT compressed textures can be uploaded */
+    int textureDxt;
 } RendererLimits;
 
 typedef struct
@@ -72,7 +124,7 @@ typedef struct Renderer
     void (*render)(struct Renderer* renderer,
                    const Frustum* cam,
                    const struct Engine* engine,
-                   const RenderList* renderList);
+                   const RenderQueue* renderQueue);
     
     int (*uploadTexture)(struct Renderer* renderer, Texture* texture);
 
@@ -94,8 +146,18 @@ typedef struct Renderer
     void (*flushLoad)(struct Renderer* renderer);
     
     RendererLimits limits;
+    RendererStats stats;
 
     int debug;
+    
+    /* skin each skeleton once per frame with transform feedback
+     and share the result between the shadow and lit passes */
+    int cacheSkinning;
+    
+    /* upload meshes as StaticMeshPackedVert and SkelSkinPackedVert to save bandwidth.
+     Shaders are compiled for one layout, so this must be set before init, see -packverts in main_sdl.c */
+    int packVerts;
+    
     void* context;
     
 } Renderer;
@@ -22,21 +22,14 @@ int Skel_Init(Skel* skel, short jointCount, short attachPointCount)
     skel->attachPointCount = attachPointCount;
     
     skel->joints = malloc(sizeof(SkelJoint) * jointCount);
-    if (!skel->joints)
-        return 0;
-    
     skel->renderJointRotations = malloc(sizeof(Quat) * jointCount);
-    if (!skel->renderJointRotations)
-    {
-        free(skel->joints);
-        return 0;
-    }
-    
     skel->renderJointOrigins = malloc(sizeof(Vec3) * jointCount);
-    if (!skel->renderJointRotations)
+    
+    /* left zeroed, so a failed init is safe to shut down */
+    if (!skel->joints || !skel->renderJointRotations || !skel->renderJointOrigins)
     {
-        free(skel->joints);
-        free(skel->renderJointRotations);
+        Skel_Shutdown(skel);
+        memset(skel, 0, sizeof(Skel));
         return 0;
     }
     
@@ -93,6 +86,12 @@ int Skel_Copy(Skel* dest, const Skel* source)
     dest->origin = source->origin;
     dest->rotation = source->rotation;
     dest->offset = source->offset;
+    
+    /* rebuilt on first pose */
+    dest->poseOrder = NULL;
+    dest->poseLevels = NULL;
+    dest->poseLevelCount = 0;
+    dest->scratch = NULL;
     return 1;
 }
 
@@ -106,37 +105,175 @@ void Skel_Shutdown(Skel* skel)
     
     if (skel->renderJointRotations)
         free(skel->renderJointRotations);
+    
+    free(skel->poseOrder);
+    free(skel->poseLevels);
+    free(skel->scratch);
 }
 
-/* posing transforms the world joints by the current local joint configuration */
-void Skel_Pose(Skel* skel)
+static int Skel_BuildPoseOrder(Skel* skel)
 {
-    assert(skel);
+    short* depths = malloc(sizeof(short) * skel->jointCount);
+    skel->poseOrder = malloc(sizeof(short) * skel->jointCount);
+    skel->poseLevels = calloc(skel->jointCount + 1, sizeof(short));
     
-    Vec3 worldOrigin = Quat_MultVec3(&skel->rotation, Vec3_Add(skel->origin, skel->offset));
+    if (!depths || !skel->poseOrder || !skel->poseLevels)
+    {
+        free(depths);
+        free(skel->poseOrder);
+        free(skel->poseLevels);
+        skel->poseOrder = NULL;
+        skel->poseLevels = NULL;
+        return 0;
+    }
+    
+    int levelCount = 0;
     
     for (int i = 0; i < skel->jointCount; ++i)
     {
-        SkelJoint* joint = skel->joints + i;
+        short depth = 0;
         
-        if (joint->parent < 0)
-        {
-            joint->modelHead = worldOrigin;
-            joint->modelTail =  Vec3_Add(worldOrigin, joint->tail);
-            joint->modelRotation = Quat_Mult(skel->rotation, joint->rotation);
-        }
-        else
+        for (int j = skel->joints[i].parent; j >= 0 && depth < skel->jointCount - 1; j = skel->joints[j].parent)
+            ++depth;
+        
+        depths[i] = depth;
+        levelCount = MAX(levelCount, depth + 1);
+        ++skel->poseLevels[depth + 1];
+    }
+    
+    for (int level = 0; level < levelCount; ++level)
+        skel->poseLevels[level + 1] += skel->poseLevels[level];
+    
+    /* counting sort, keeping file order within a level */
+    for (int i = 0; i < skel->jointCount; ++i)
+        skel->poseOrder[skel->poseLevels[depths[i]]++] = i;
+    
+    /* the sort advanced each start to the following level's start */
+    for (int level = levelCount; level > 0; --level)
+        skel->poseLevels[level] = skel->poseLevels[level - 1];
+    
+    skel->poseLevels[0] = 0;
+    skel->poseLevelCount = levelCount;
+    
+    free(depths);
+    return 1;
+}
+
+float* Skel_Scratch(Skel* skel)
+{
+    if (skel->scratch)
+        return skel->scratch;
+    
+    if (!skel->poseOrder && !Skel_BuildPoseOrder(skel))
+        return NULL;
+    
+    skel->scratch = malloc(sizeof(float) * SKEL_SCRATCH_ARRAYS * VEC_SOA_PAD(skel->jointCount));
+    return skel->scratch;
+}
+
+static void Skel_PoseJoint(Skel* skel, int i, Vec3 worldOrigin)
+{
+    SkelJoint* joint = skel->joints + i;
+    
+    if (joint->parent < 0)
+    {
+        joint->modelHead = worldOrigin;
+        joint->modelTail =  Vec3_Add(worldOrigin, joint->tail);
+        joint->modelRotation = Quat_Mult(skel->rotation, joint->rotation);
+    }
+    else
+    {
+        const SkelJoint* parent = &skel->joints[joint->parent];
+        
+        joint->modelHead = parent->modelTail;
+        joint->modelRotation = Quat_Mult(parent->modelRotation, joint->rotation);
+        joint->modelTail = Vec3_Add(Quat_MultVec3(&joint->modelRotation, joint->tail), parent->modelTail);
+    }
+    
+    skel->renderJointOrigins[i] = joint->modelHead;
+    skel->renderJointRotations[i] = joint->modelRotation;
+}
+
+/* poses joints whose parents are all posed, a vector of lanes at a time */
+static void Skel_PoseBatch(Skel* skel, const short* indices, int count)
+{
+    int stride = VEC_SOA_PAD(skel->jointCount);
+    
+    QuatSoA parentRotations = QuatSoA_Arrays(skel->scratch, stride);
+    QuatSoA rotations = QuatSoA_Arrays(skel->scratch + stride * 4, stride);
+    Vec3SoA tails = Vec3SoA_Arrays(skel->scratch + stride * 8, stride);
+    Vec3SoA parentTails = Vec3SoA_Arrays(skel->scratch + stride * 11, stride);
+    
+    for (int k = 0; k < VEC_SOA_PAD(count); ++k)
+    {
+        /* padding lanes get harmless values */
+        if (k >= count)
         {
-            const SkelJoint* parent = &skel->joints[joint->parent];
-            
-            joint->modelHead = parent->modelTail;
-            joint->modelRotation = Quat_Mult(parent->modelRotation, joint->rotation);
-            joint->modelTail = Vec3_Add(Quat_MultVec3(&joint->modelRotation, joint->tail), parent->modelTail);
+            QuatSoA_Set(parentRotations, k, Quat_Identity);
+            QuatSoA_Set(rotations, k, Quat_Identity);
+            Vec3SoA_Set(tails, k, Vec3_Zero);
+            Vec3SoA_Set(parentTails, k, Vec3_Zero);
+            continue;
         }
         
+        const SkelJoint* joint = skel->joints + indices[k];
+        const SkelJoint* parent = skel->joints + joint->parent;
+        
+        QuatSoA_Set(parentRotations, k, parent->modelRotation);
+        QuatSoA_Set(rotations, k, joint->rotation);
+        Vec3SoA_Set(tails, k, joint->tail);
+        Vec3SoA_Set(parentTails, k, parent->modelTail);
+    }
+    
+    QuatSoA_Mult(rotations, parentRotations, rotations, count);
+    QuatSoA_Transform(tails, rotations, tails, parentTails, count);
+    
+    for (int k = 0; k < count; ++k)
+    {
+        int i = indices[k];
+        SkelJoint* joint = skel->joints + i;
+        
+        joint->modelHead = Vec3SoA_Get(parentTails, k);
+        joint->modelRotation = QuatSoA_Get(rotations, k);
+        joint->modelTail = Vec3SoA_Get(tails, k);
+        
         skel->renderJointOrigins[i] = joint->modelHead;
         skel->renderJointRotations[i] = joint->modelRotation;
     }
+}
+
+/* posing transforms the world joints by the current local joint configuration */
+void Skel_Pose(Skel* skel)
+{
+    assert(skel);
+    
+    Vec3 worldOrigin = Quat_MultVec3(&skel->rotation, Vec3_Add(skel->origin, skel->offset));
+    
+    if (!Skel_Scratch(skel))
+    {
+        /* parents come before children in file order */
+        for (int i = 0; i < skel->jointCount; ++i)
+            Skel_PoseJoint(skel, i, worldOrigin);
+    }
+    else
+    {
+        for (int level = 0; level < skel->poseLevelCount; ++level)
+        {
+            const short* indices = skel->poseOrder + skel->poseLevels[level];
+            int count = skel->poseLevels[level + 1] - skel->poseLevels[level];
+            
+            /* roots, and levels too small to fill a vector */
+            if (level == 0 || count < VEC_SOA_WIDTH / 2)
+            {
+                for (int k = 0; k < count; ++k)
+                    Skel_PoseJoint(skel, indices[k], worldOrigin);
+            }
+            else
+            {
+                Skel_PoseBatch(skel, indices, count);
+            }
+        }
+    }
     
     for (int i = 0; i < skel->attachPointCount; ++i)
     {
@@ -3,10 +3,14 @@
 #define SKEL_H
 
 #include "vec_math.h"
+#include "vec_soa.h"
 
 #define SKEL_JOINT_NAME_MAX 64
 #define SKEL_ATTACH_POINTS_MAX 8
 
+/* arrays in the scratch buffer, see Skel_Scratch */
+#define SKEL_SCRATCH_ARRAYS 14
+
 /* 
  In a skeleton file, only joint heads and tails are stored. This means that whatever the pose matrix is, is considered the identity.
  Bone rotations from the 3d editor to not come into play. All animations store rotations relative to pose positions.
@@ -74,6 +78,14 @@ typedef struct
     /* number of joints in skeleton */
     short jointCount;
     short attachPointCount;
+    
+    /* joints grouped by depth, so each level can be posed as a batch.
+     poseLevels holds poseLevelCount + 1 offsets into poseOrder. Built on first use */
+    short* poseOrder;
+    short* poseLevels;
+    short poseLevelCount;
+    
+    float* scratch;
 } Skel;
 
 extern int Skel_Init(Skel* skel, short jointCount, short attachPointCount);
@@ -92,6 +104,10 @@ extern short Skel_AddAttachPoint(Skel* skel,
                                  int joint,
                                  const char* name);
 
+/* SKEL_SCRATCH_ARRAYS arrays of VEC_SOA_PAD(jointCount) floats, for batched joint math.
+ Allocated with the pose order on first use. NULL if allocation fails */
+extern float* Skel_Scratch(Skel* skel);
+
 /* updates world joints from local */
 extern void Skel_Pose(Skel* skel);
 
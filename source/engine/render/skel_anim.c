@@ -2,6 +2,7 @@
 #include "skel_anim.h"
 #include <string.h>
 #include <assert.h>
+#include <stdint.h>
 #include "utils.h"
 
 // \[([-+]?[0-9]*\.[0-9]+|[0-9]+), ([-+]?[0-9]*\.[0-9]+|[0-9]+), (0.000000)\]
@@ -17,24 +18,24 @@ int SkelAnim_Init(SkelAnim* anim,
     anim->jointCount = jointCount;
     anim->frameCount = frameCount;
     anim->markerCount = markerCount;
+    
+    anim->tracks = NULL;
+    anim->keys = NULL;
+    anim->keyFrames = NULL;
+    anim->keyCount = 0;
+    anim->mapped = 0;
         
+    anim->markers = NULL;
+    
     if (anim->markerCount > 0)
-    {
         anim->markers = malloc(sizeof(SkelAnimMarker) * markerCount);
-    }
-    else
-    {
-        anim->markers = NULL;
-    }
     
     anim->frames = malloc(sizeof(SkelAnimFrame) * frameCount);
-    if (!anim->frames)
-        return 0;
-    
     anim->frameData = malloc(sizeof(SkelAnimJoint) * jointCount * frameCount);
-    if (!anim->frameData)
+    
+    if ((anim->markerCount > 0 && !anim->markers) || !anim->frames || !anim->frameData)
     {
-        free(anim->frames);
+        SkelAnim_Shutdown(anim);
         return 0;
     }
     
@@ -57,6 +58,284 @@ void SkelAnim_Shutdown(SkelAnim* anim)
     
     if (anim->markers)
         free(anim->markers);
+    
+    if (!anim->mapped)
+    {
+        free(anim->tracks);
+        free(anim->keys);
+        free(anim->keyFrames);
+    }
+    
+    anim->mapped = 0;
+    anim->frames = NULL;
+    anim->frameData = NULL;
+    anim->markers = NULL;
+    anim->tracks = NULL;
+    anim->keys = NULL;
+    anim->keyFrames = NULL;
+}
+
+int SkelAnim_InitTracks(SkelAnim* anim, unsigned int keyCount)
+{
+    if (!anim->mapped)
+    {
+        free(anim->tracks);
+        free(anim->keys);
+        free(anim->keyFrames);
+    }
+    
+    anim->mapped = 0;
+    anim->keyCount = keyCount;
+    anim->tracks = malloc(sizeof(SkelAnimTrack) * anim->jointCount);
+    anim->keys = malloc(sizeof(SkelAnimKey) * keyCount);
+    anim->keyFrames = malloc(sizeof(unsigned short) * keyCount);
+    
+    /* SkelAnim_JointRotation reads tracks whenever they are set, so none of them may be left behind */
+    if (!anim->tracks || !anim->keys || !anim->keyFrames)
+    {
+        free(anim->tracks);
+        free(anim->keys);
+        free(anim->keyFrames);
+        
+        anim->tracks = NULL;
+        anim->keys = NULL;
+        anim->keyFrames = NULL;
+        anim->keyCount = 0;
+        return 0;
+    }
+    
+    free(anim->frameData);
+    anim->frameData = NULL;
+    
+    return 1;
+}
+
+#define SKEL_ANIM_KEY_RANGE 0.70710678f
+#define SKEL_ANIM_KEY_MAX 32767.0f
+
+SkelAnimKey SkelAnimKey_Encode(Quat q)
+{
+    q = Quat_Norm(q);
+    float* c = &q.x;
+    
+    int largest = 0;
+    for (int i = 1; i < 4; ++i)
+    {
+        if (fabsf(c[i]) > fabsf(c[largest]))
+            largest = i;
+    }
+    
+    /* q and -q are the same rotation, so the dropped component can always be positive */
+    float sign = (c[largest] < 0.0f) ? -1.0f : 1.0f;
+    
+    SkelAnimKey key;
+    int k = 0;
+    
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+        
+        float t = (c[i] * sign / SKEL_ANIM_KEY_RANGE) * 0.5f + 0.5f;
+        key.c[k++] = (unsigned short)roundf(CLAMP(t, 0.0f, 1.0f) * SKEL_ANIM_KEY_MAX);
+    }
+    
+    key.c[0] |= (largest & 1) << 15;
+    key.c[1] |= (largest >> 1) << 15;
+    
+    return key;
+}
+
+Quat SkelAnimKey_Decode(SkelAnimKey key)
+{
+    int largest = (key.c[0] >> 15) | ((key.c[1] >> 15) << 1);
+    
+    Quat q;
+    float* c = &q.x;
+    
+    float sumSq = 0.0f;
+    int k = 0;
+    
+    for (int i = 0; i < 4; ++i)
+    {
+        if (i == largest)
+            continue;
+        
+        float t = (key.c[k++] & 0x7FFF) / SKEL_ANIM_KEY_MAX;
+        c[i] = (t * 2.0f - 1.0f) * SKEL_ANIM_KEY_RANGE;
+        sumSq += c[i] * c[i];
+    }
+    
+    c[largest] = sqrtf(MAX(1.0f - sumSq, 0.0f));
+    return q;
+}
+
+/* Quat_Slerp takes the long way around when the signs disagree */
+static Quat SkelAnim_Slerp(Quat from, Quat to, float t)
+{
+    if (Quat_Dot(from, to) < 0.0f)
+        to = Quat_Scale(to, -1.0f);
+    
+    return Quat_Slerp(from, to, t);
+}
+
+/* each track's key frames must rise strictly and stay below frameCount, or slerping between keys divides by zero */
+static int SkelAnim_ValidTracks(const SkelAnim* anim, const SkelAnimTrack* tracks, const unsigned short* keyFrames)
+{
+    for (int i = 0; i < anim->jointCount; ++i)
+    {
+        const SkelAnimTrack* track = tracks + i;
+        
+        for (unsigned int k = 0; k < track->keyCount; ++k)
+        {
+            unsigned short keyFrame = keyFrames[track->firstKey + k];
+            
+            if (keyFrame >= anim->frameCount || (k > 0 && keyFrame <= keyFrames[track->firstKey + k - 1]))
+                return 0;
+        }
+    }
+    
+    return 1;
+}
+
+Quat SkelAnim_JointRotation(const SkelAnim* anim, int frame, int joint)
+{
+    if (!anim->tracks)
+        return anim->frameData[frame * anim->jointCount + joint].rotation;
+    
+    const SkelAnimTrack* track = anim->tracks + joint;
+    const SkelAnimKey* keys = anim->keys + track->firstKey;
+    const unsigned short* keyFrames = anim->keyFrames + track->firstKey;
+    
+    if (track->keyCount == 1 || frame <= keyFrames[0])
+        return SkelAnimKey_Decode(keys[0]);
+    
+    /* last key at or before frame */
+    unsigned int low = 0;
+    unsigned int high = track->keyCount - 1;
+    
+    while (low < high)
+    {
+        unsigned int mid = (low + high + 1) / 2;
+        
+        if (keyFrames[mid] <= frame)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+    
+    if (low == track->keyCount - 1 || keyFrames[low] == frame)
+        return SkelAnimKey_Decode(keys[low]);
+    
+    assert(keyFrames[low + 1] > keyFrames[low]);
+    float t = (frame - keyFrames[low]) / (float)(keyFrames[low + 1] - keyFrames[low]);
+    return SkelAnim_Slerp(SkelAnimKey_Decode(keys[low]), SkelAnimKey_Decode(keys[low + 1]), t);
+}
+
+/* true if slerping the keys at first and last reproduces every frame between within maxError */
+static int SkelAnim_SpanFits(const SkelAnim* anim, int joint, int first, int last, float maxError)
+{
+    Quat from = SkelAnimKey_Decode(SkelAnimKey_Encode(anim->frameData[first * anim->jointCount + joint].rotation));
+    Quat to = SkelAnimKey_Decode(SkelAnimKey_Encode(anim->frameData[last * anim->jointCount + joint].rotation));
+    
+    for (int f = first + 1; f < last; ++f)
+    {
+        Quat q = SkelAnim_Slerp(from, to, (f - first) / (float)(last - first));
+        
+        if (Quat_Angle(q, anim->frameData[f * anim->jointCount + joint].rotation) > maxError)
+            return 0;
+    }
+    
+    return 1;
+}
+
+int SkelAnim_Compress(SkelAnim* anim, float maxErrorDegrees)
+{
+    if (anim->tracks || !anim->frameData || anim->frameCount < 1)
+        return 0;
+    
+    float maxError = DEG_TO_RAD(maxErrorDegrees);
+    
+    /* worst case every frame is a key */
+    SkelAnimTrack* tracks = malloc(sizeof(SkelAnimTrack) * anim->jointCount);
+    SkelAnimKey* keys = malloc(sizeof(SkelAnimKey) * anim->jointCount * anim->frameCount);
+    unsigned short* keyFrames = malloc(sizeof(unsigned short) * anim->jointCount * anim->frameCount);
+    
+    if (!tracks || !keys || !keyFrames)
+    {
+        free(tracks);
+        free(keys);
+        free(keyFrames);
+        return 0;
+    }
+    
+    unsigned int keyCount = 0;
+    
+    for (int j = 0; j < anim->jointCount; ++j)
+    {
+        SkelAnimTrack* track = tracks + j;
+        track->firstKey = keyCount;
+        
+        SkelAnimKey first = SkelAnimKey_Encode(anim->frameData[j].rotation);
+        int constant = 1;
+        
+        for (int f = 1; f < anim->frameCount && constant; ++f)
+        {
+            const Quat q = anim->frameData[f * anim->jointCount + j].rotation;
+            SkelAnimKey key = SkelAnimKey_Encode(q);
+            
+            if (maxError > 0.0f)
+                constant = Quat_Angle(SkelAnimKey_Decode(first), q) <= maxError;
+            else
+                constant = memcmp(&first, &key, sizeof(SkelAnimKey)) == 0;
+        }
+        
+        keys[keyCount] = first;
+        keyFrames[keyCount] = 0;
+        ++keyCount;
+        
+        if (!constant)
+        {
+            int start = 0;
+            
+            while (start < anim->frameCount - 1)
+            {
+                int end = start + 1;
+                
+                if (maxError > 0.0f)
+                {
+                    while (end + 1 < anim->frameCount && SkelAnim_SpanFits(anim, j, start, end + 1, maxError))
+                        ++end;
+                }
+                
+                keys[keyCount] = SkelAnimKey_Encode(anim->frameData[end * anim->jointCount + j].rotation);
+                keyFrames[keyCount] = end;
+                ++keyCount;
+                
+                start = end;
+            }
+        }
+        
+        track->keyCount = keyCount - track->firstKey;
+    }
+    
+    if (!SkelAnim_ValidTracks(anim, tracks, keyFrames) || !SkelAnim_InitTracks(anim, keyCount))
+    {
+        free(tracks);
+        free(keys);
+        free(keyFrames);
+        return 0;
+    }
+    
+    memcpy(anim->tracks, tracks, sizeof(SkelAnimTrack) * anim->jointCount);
+    memcpy(anim->keys, keys, sizeof(SkelAnimKey) * keyCount);
+    memcpy(anim->keyFrames, keyFrames, sizeof(unsigned short) * keyCount);
+    
+    free(tracks);
+    free(keys);
+    free(keyFrames);
+    
+    return 1;
 }
 
 static int SkelAnim_FromSKANIM(SkelAnim* anim, FILE* file)
@@ -64,9 +343,9 @@ static int SkelAnim_FromSKANIM(SkelAnim* anim, FILE* file)
     char lineBuffer[LINE_BUFFER_MAX];
     int readInfo = 0;
     
-    short jointCount = -1;
-    short frameCount = -1;
-    short markerCount = -1;
+    int jointCount = -1;
+    int frameCount = -1;
+    int markerCount = -1;
     int version = -1;
     
     anim->framesPerSecond = 30;
@@ -116,7 +395,11 @@ static int SkelAnim_FromSKANIM(SkelAnim* anim, FILE* file)
                 assert(frameCount != -1);
                 assert(markerCount != -1);
                 
-                SkelAnim_Init(anim, jointCount, frameCount, markerCount);
+                /* counts are 16 bit, and compressed key frames index frames in 16 bits */
+                if (jointCount > 0xFFFF || frameCount > 0xFFFF || markerCount > 0xFFFF ||
+                    !SkelAnim_Init(anim, jointCount, frameCount, markerCount))
+                    return 0;
+                
                 readInfo = 1;
             }
             
@@ -175,18 +458,257 @@ static int SkelAnim_FromSKANIM(SkelAnim* anim, FILE* file)
     return 1;
 }
 
-int SkelAnim_FromPath(SkelAnim* anim, const char* path)
+static void SkelAnim_ReadLittleWords(void* data, size_t count)
 {
-    FILE* file = fopen(path, "r");
+    if (!End_IsBig())
+        return;
     
-    if (!file) { return 0; }
+    uint32_t* words = data;
+    for (size_t i = 0; i < count; ++i)
+        words[i] = End_Swap32(words[i]);
+}
+
+/* data is the file in memory, if it is there */
+static int SkelAnim_ReadTracks(SkelAnim* anim, FILE* file, long fileSize, const void* data)
+{
+    int32_t keyCount;
+    
+    if (fread(&keyCount, sizeof(int32_t), 1, file) != 1)
+        return 0;
+    
+    keyCount = End_ReadLittle32(keyCount);
     
-    int status = 0;
+    if (keyCount < anim->jointCount)
+        return 0;
+    
+    /* the tracks and keys must be in the file before they are allocated */
+    long start = ftell(file);
+    int64_t blockSize = (int64_t)anim->jointCount * 8 + (int64_t)keyCount * (sizeof(unsigned short) + sizeof(SkelAnimKey));
+    
+    if (start < 0 || blockSize > fileSize - start)
+        return 0;
+    
+    /* in memory the blocks are used where they lie. The tracks are two words per joint,
+     so the 16 bit key blocks after them are aligned whenever the tracks are */
+    const SkelAnimTrack* mappedTracks = End_LittleInPlace(data, start, sizeof(uint32_t));
+    
+    if (mappedTracks)
+    {
+        for (int i = 0; i < anim->jointCount; ++i)
+        {
+            const SkelAnimTrack* track = mappedTracks + i;
+            
+            if (track->keyCount < 1 || track->keyCount > (unsigned int)keyCount ||
+                track->firstKey > (unsigned int)keyCount - track->keyCount)
+                return 0;
+        }
+        
+        const unsigned short* mappedKeyFrames = (const unsigned short*)(mappedTracks + anim->jointCount);
+        
+        if (!SkelAnim_ValidTracks(anim, mappedTracks, mappedKeyFrames))
+            return 0;
+        
+        free(anim->frameData);
+        anim->frameData = NULL;
+        
+        /* the memory is read only, and nothing writes a loaded anim's keys */
+        anim->keyCount = keyCount;
+        anim->tracks = (SkelAnimTrack*)mappedTracks;
+        anim->keyFrames = (unsigned short*)mappedKeyFrames;
+        anim->keys = (SkelAnimKey*)(mappedKeyFrames + keyCount);
+        anim->mapped = 1;
+        
+        return fseek(file, start + (long)blockSize, SEEK_SET) == 0;
+    }
+    
+    if (!SkelAnim_InitTracks(anim, keyCount))
+        return 0;
+    
+    for (int i = 0; i < anim->jointCount; ++i)
+    {
+        int32_t track[2];
+        
+        if (fread(track, sizeof(track), 1, file) != 1)
+            return 0;
+        
+        SkelAnim_ReadLittleWords(track, 2);
+        
+        if (track[1] < 1 || track[0] < 0 || track[0] > keyCount - track[1])
+            return 0;
+        
+        anim->tracks[i].firstKey = track[0];
+        anim->tracks[i].keyCount = track[1];
+    }
+    
+    /* keys are all 16 bit words */
+    if (fread(anim->keyFrames, sizeof(unsigned short), keyCount, file) != keyCount ||
+        fread(anim->keys, sizeof(SkelAnimKey), keyCount, file) != keyCount)
+        return 0;
+    
+    if (End_IsBig())
+    {
+        for (int i = 0; i < keyCount; ++i)
+        {
+            anim->keyFrames[i] = End_Swap16(anim->keyFrames[i]);
+            
+            for (int j = 0; j < 3; ++j)
+                anim->keys[i].c[j] = End_Swap16(anim->keys[i].c[j]);
+        }
+    }
+    
+    return SkelAnim_ValidTracks(anim, anim->tracks, anim->keyFrames);
+}
+
+/* binary skanim, written by tools/skanimconvert. see SKEL_ANIM_BINARY_VERSION.
+ data is the file in memory, if it is there */
+static int SkelAnim_FromBSKANIM(SkelAnim* anim, FILE* file, const void* data)
+{
+    char magic[4];
+    int32_t header[5];
+    
+    if (fread(magic, sizeof(magic), 1, file) != 1 || memcmp(magic, SKEL_ANIM_BINARY_MAGIC, 4) != 0)
+        return 0;
+    
+    if (fread(header, sizeof(header), 1, file) != 1)
+        return 0;
+    
+    SkelAnim_ReadLittleWords(header, 5);
+    
+    int version = header[0];
+    
+    if (version < 1 || version > SKEL_ANIM_BINARY_VERSION)
+        return 0;
+    
+    int jointCount = header[1];
+    int frameCount = header[2];
+    int markerCount = header[4];
+    
+    /* key frames are 16 bit, and joints play onto a Skel, which counts them in a short */
+    if (frameCount < 1 || frameCount > 0xFFFF ||
+        jointCount < 1 || jointCount > 0x7FFF ||
+        markerCount < 0 || markerCount > 0xFFFF)
+        return 0;
+    
+    /* every block but the keys is sized by the header, so a corrupt count fails here before it is allocated.
+     SkelAnim_ReadTracks checks the keys the same way */
+    int64_t blockSize = (int64_t)frameCount * sizeof(Vec3) + (int64_t)markerCount * (SKEL_ANIM_MARKER_NAME_MAX + 4);
+    
+    if (version == 1)
+        blockSize += (int64_t)jointCount * frameCount * sizeof(SkelAnimJoint);
+    else
+        blockSize += 4 + (int64_t)jointCount * 8;
+    
+    long start = ftell(file);
+    
+    if (start < 0 || fseek(file, 0, SEEK_END) != 0)
+        return 0;
+    
+    long fileSize = ftell(file);
+    
+    if (fseek(file, start, SEEK_SET) != 0 || blockSize > fileSize - start)
+        return 0;
+    
+    if (!SkelAnim_Init(anim, jointCount, frameCount, markerCount))
+        return 0;
+    
+    anim->framesPerSecond = header[3];
+    
+    Vec3* rootOffsets = malloc(sizeof(Vec3) * frameCount);
+    
+    if (!rootOffsets || fread(rootOffsets, sizeof(Vec3), frameCount, file) != frameCount)
+    {
+        free(rootOffsets);
+        SkelAnim_Shutdown(anim);
+        return 0;
+    }
+    
+    SkelAnim_ReadLittleWords(rootOffsets, frameCount * 3);
+    
+    for (int i = 0; i < frameCount; ++i)
+        anim->frames[i].rootOffset = rootOffsets[i];
+    
+    free(rootOffsets);
     
-    if (strcmp(Filepath_Extension(path), "skanim") == 0)
+    if (version == 1)
     {
-        status = SkelAnim_FromSKANIM(anim, file);
+        /* SkelAnimJoint is a bare quaternion, so the joint block reads straight into place */
+        size_t jointTotal = (size_t)jointCount * frameCount;
+        
+        if (fread(anim->frameData, sizeof(SkelAnimJoint), jointTotal, file) != jointTotal)
+        {
+            SkelAnim_Shutdown(anim);
+            return 0;
+        }
+        
+        SkelAnim_ReadLittleWords(anim->frameData, jointTotal * 4);
+    }
+    else if (!SkelAnim_ReadTracks(anim, file, fileSize, data))
+    {
+        SkelAnim_Shutdown(anim);
+        return 0;
+    }
+    
+    for (int i = 0; i < markerCount; ++i)
+    {
+        SkelAnimMarker* marker = anim->markers + i;
+        int32_t frame;
+        
+        if (fread(marker->name, SKEL_ANIM_MARKER_NAME_MAX, 1, file) != 1 ||
+            fread(&frame, sizeof(int32_t), 1, file) != 1)
+        {
+            SkelAnim_Shutdown(anim);
+            return 0;
+        }
+        
+        marker->name[SKEL_ANIM_MARKER_NAME_MAX - 1] = '\0';
+        marker->frame = End_ReadLittle32(frame);
+        
+        if (marker->frame >= 0 && marker->frame < frameCount)
+            anim->frames[marker->frame].markerIndex = i;
+    }
+    
+    return 1;
+}
+
+static int SkelAnim_FromStream(SkelAnim* anim, FILE* file, const char* extension, const void* data)
+{
+    if (strcmp(extension, "skanim") == 0)
+    {
+        return SkelAnim_FromSKANIM(anim, file);
     }
+    else if (strcmp(extension, "bskanim") == 0)
+    {
+        return SkelAnim_FromBSKANIM(anim, file, data);
+    }
+    
+    return 0;
+}
+
+int SkelAnim_FromFile(SkelAnim* anim, FILE* file, const char* extension)
+{
+    return SkelAnim_FromStream(anim, file, extension, NULL);
+}
+
+int SkelAnim_FromMemory(SkelAnim* anim, const void* data, size_t size, const char* extension)
+{
+    FILE* file = File_OpenMemory(data, size);
+    
+    if (!file)
+        return 0;
+    
+    int status = SkelAnim_FromStream(anim, file, extension, data);
+    
+    fclose(file);
+    return status;
+}
+
+int SkelAnim_FromPath(SkelAnim* anim, const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    
+    if (!file) { return 0; }
+    
+    int status = SkelAnim_FromFile(anim, file, Filepath_Extension(path));
     
     fclose(file);
     
@@ -242,7 +764,7 @@ static void SkelAnimator_ReplaceAnim(SkelAnimator* animator,
     animator->subFrame = 0;
     
     for (int i = 0; i < animator->skel->jointCount; ++i)
-        animator->skel->joints[i].rotation = anim->frameData[i].rotation;
+        animator->skel->joints[i].rotation = SkelAnim_JointRotation(anim, 0, i);
 }
 
 int SkelAnimator_SetAnim(SkelAnimator* animator,
@@ -288,6 +810,53 @@ void SkelAnimator_RestartAnim(SkelAnimator* animator)
     animator->subFrame = 0;
 }
 
+/* slerps joint rotations from one pose to another, in batches through the skel's scratch arrays */
+static void SkelAnimator_Blend(Skel* skel,
+                               const SkelAnim* fromAnim,
+                               int fromFrame,
+                               const SkelAnim* toAnim,
+                               int toFrame,
+                               float t,
+                               int jointCount)
+{
+    float* scratch = Skel_Scratch(skel);
+    
+    if (!scratch)
+    {
+        for (int i = 0; i < jointCount; ++i)
+        {
+            const Quat from = SkelAnim_JointRotation(fromAnim, fromFrame, i);
+            const Quat to = SkelAnim_JointRotation(toAnim, toFrame, i);
+            skel->joints[i].rotation = SkelAnim_Slerp(from, to, t);
+        }
+        
+        return;
+    }
+    
+    int stride = VEC_SOA_PAD(skel->jointCount);
+    QuatSoA from = QuatSoA_Arrays(scratch, stride);
+    QuatSoA to = QuatSoA_Arrays(scratch + stride * 4, stride);
+    
+    for (int i = 0; i < VEC_SOA_PAD(jointCount); ++i)
+    {
+        if (i < jointCount)
+        {
+            QuatSoA_Set(from, i, SkelAnim_JointRotation(fromAnim, fromFrame, i));
+            QuatSoA_Set(to, i, SkelAnim_JointRotation(toAnim, toFrame, i));
+        }
+        else
+        {
+            QuatSoA_Set(from, i, Quat_Identity);
+            QuatSoA_Set(to, i, Quat_Identity);
+        }
+    }
+    
+    QuatSoA_Slerp(from, from, to, t, jointCount);
+    
+    for (int i = 0; i < jointCount; ++i)
+        skel->joints[i].rotation = QuatSoA_Get(from, i);
+}
+
 static void SkelAnimator_TickAnim(SkelAnimator* animator, Skel* skel, SkelAnimatorInfo* frameInfo)
 {
     const SkelAnim* anim = animator->anim;
@@ -300,9 +869,6 @@ static void SkelAnimator_TickAnim(SkelAnimator* animator, Skel* skel, SkelAnimat
     int currentIndex = animator->frame;
     int nextIndex = (currentIndex + 1) % anim->frameCount;
 
-    size_t currentDataStart = currentIndex * anim->jointCount;
-    const size_t nextDataStart = nextIndex * anim->jointCount;
-
     const SkelAnimFrame* current = anim->frames + currentIndex;
     const SkelAnimFrame* next = anim->frames + nextIndex;
 
@@ -310,12 +876,7 @@ static void SkelAnimator_TickAnim(SkelAnimator* animator, Skel* skel, SkelAnimat
     {
         float interp = animator->subFrame / (float)frameLength;
 
-        for (int i = 0; i < skel->jointCount; ++i)
-        {
-            const Quat from = anim->frameData[currentDataStart + i].rotation;
-            const Quat to = anim->frameData[nextDataStart + i].rotation;
-            skel->joints[i].rotation = Quat_Slerp(from, to, interp);
-        }
+        SkelAnimator_Blend(skel, anim, currentIndex, anim, nextIndex, interp, skel->jointCount);
         
         skel->offset = Vec3_Lerp(current->rootOffset, next->rootOffset, interp);
     }
@@ -323,7 +884,7 @@ static void SkelAnimator_TickAnim(SkelAnimator* animator, Skel* skel, SkelAnimat
     {
         // no interploation necessary 1 to 1 frame count
         for (int i = 0; i < skel->jointCount; ++i)
-            skel->joints[i].rotation = anim->frameData[currentDataStart + i].rotation;
+            skel->joints[i].rotation = SkelAnim_JointRotation(anim, currentIndex, i);
         
         skel->offset = current->rootOffset;
     }
@@ -372,17 +933,9 @@ SkelAnimatorInfo SkelAnimator_Tick(SkelAnimator* animator)
 
         float interp = animator->transitionFrame / (float)animator->transitionFrameCount;
         
-        size_t previousDataStart = animator->frame * currentAnim->jointCount;
-        size_t nextDataStart = animator->targetStartFrame * currentAnim->jointCount;
-        
         int maxJoints = MIN(skel->jointCount, MIN(animator->anim->jointCount, animator->targetAnim->jointCount));
         
-        for (int i = 0; i < maxJoints; ++i)
-        {
-            Quat from = currentAnim->frameData[previousDataStart + i].rotation;
-            Quat to = targetAnim->frameData[nextDataStart + i].rotation;
-            skel->joints[i].rotation = Quat_Slerp(from, to, interp);
-        }
+        SkelAnimator_Blend(skel, currentAnim, animator->frame, targetAnim, animator->targetStartFrame, interp, maxJoints);
         
         // lerp offset as well
         Vec3 currentOffset = currentAnim->frames[animator->frame].rootOffset;
@@ -2,12 +2,30 @@
 #ifndef SKEL_ANIM_H
 #define SKEL_ANIM_H
 
+#include <stdio.h>
 #include "skel.h"
 #include "vec_math.h"
 
 
 #define SKEL_ANIM_MARKER_NAME_MAX 64
 
+/*
+ .bskanim, little endian:
+ char magic[4]
+ int32 version, jointCount, frameCount, framesPerSecond, markerCount
+ Vec3 rootOffset[frameCount]
+ version 1:
+    Quat rotation[frameCount][jointCount] - x, y, z, w
+ version 2, compressed:
+    int32 keyCount
+    { int32 firstKey, keyCount; } tracks[jointCount]
+    uint16 keyFrames[keyCount]
+    uint16 keys[keyCount][3] - see SkelAnimKey
+ { char name[SKEL_ANIM_MARKER_NAME_MAX]; int32 frame; } markers[markerCount]
+ */
+#define SKEL_ANIM_BINARY_MAGIC "BSKA"
+#define SKEL_ANIM_BINARY_VERSION 2
+
 typedef struct
 {
     char name[SKEL_ANIM_MARKER_NAME_MAX];
@@ -19,6 +37,23 @@ typedef struct
     Quat rotation;
 } SkelAnimJoint;
 
+/*
+ Smallest three quaternion, 6 bytes instead of 16.
+ The largest component is dropped and rebuilt from the unit length, the other three
+ are 15 bits each across [-1/sqrt(2), 1/sqrt(2)]. The dropped index is in the top bits of c[0] and c[1].
+ */
+typedef struct
+{
+    unsigned short c[3];
+} SkelAnimKey;
+
+/* one joint's keys. A single key is a constant track, frames between keys are slerped */
+typedef struct
+{
+    unsigned int firstKey;
+    unsigned int keyCount;
+} SkelAnimTrack;
+
 
 typedef struct
 {
@@ -48,6 +83,16 @@ typedef struct
     SkelAnimFrame* frames;
     SkelAnimJoint* frameData;
     SkelAnimMarker* markers;
+    
+    /* compressed rotations, used instead of frameData when tracks is set.
+     read rotations with SkelAnim_JointRotation to handle either */
+    SkelAnimTrack* tracks;
+    SkelAnimKey* keys;
+    unsigned short* keyFrames;
+    unsigned int keyCount;
+    
+    /* tracks, keys and keyFrames point into read only memory the anim doesn't own (see SkelAnim_FromMemory) */
+    int mapped;
         
 } SkelAnim;
 
@@ -58,8 +103,28 @@ extern int SkelAnim_Init(SkelAnim* anim,
 extern void SkelAnim_Shutdown(SkelAnim* anim);
 
 extern int SkelAnim_FromPath(SkelAnim* anim, const char* path);
+extern int SkelAnim_FromFile(SkelAnim* anim, FILE* file, const char* extension);
+
+/* data must outlive the anim, as in an AssetPack mapping. Version 2 .bskanim tracks
+ and keys are used in place on little endian hosts, everything else is copied */
+extern int SkelAnim_FromMemory(SkelAnim* anim, const void* data, size_t size, const char* extension);
+
 extern int SkelAnim_FindMarker(SkelAnim* anim, const char* markerName);
 
+/* allocates compressed tracks for keyCount keys and frees frameData */
+extern int SkelAnim_InitTracks(SkelAnim* anim, unsigned int keyCount);
+
+/*
+ replaces frameData with compressed tracks. Tracks whose frames all quantize to one key are stored once.
+ When maxErrorDegrees > 0, keys are also dropped wherever slerping their neighbours stays within that error.
+ */
+extern int SkelAnim_Compress(SkelAnim* anim, float maxErrorDegrees);
+
+extern Quat SkelAnim_JointRotation(const SkelAnim* anim, int frame, int joint);
+
+extern SkelAnimKey SkelAnimKey_Encode(Quat q);
+extern Quat SkelAnimKey_Decode(SkelAnimKey key);
+
 #define SkelAnim_RandomFrame(anim) (rand() % ((anim)->frameCount))
 
 
@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <string.h>
 #include <limits.h>
+#include <stdint.h>
 #include "utils.h"
 
 static int SkelModel_FromSKMESH(SkelModel* model, FILE* file)
@@ -205,31 +206,301 @@ error:
     return 0;
 }
 
-int SkelModel_FromPath(SkelModel* model, const char* path)
+static uint32_t SkelModel_ReadWord(FILE* file)
+{
+    uint32_t x = 0;
+    fread(&x, sizeof(uint32_t), 1, file);
+    return End_ReadLittle32(x);
+}
+
+static float SkelModel_ReadFloat(FILE* file)
+{
+    uint32_t x = SkelModel_ReadWord(file);
+    float f;
+    memcpy(&f, &x, sizeof(float));
+    return f;
+}
+
+static Vec3 SkelModel_ReadVec3(FILE* file)
+{
+    Vec3 v;
+    v.x = SkelModel_ReadFloat(file);
+    v.y = SkelModel_ReadFloat(file);
+    v.z = SkelModel_ReadFloat(file);
+    return v;
+}
+
+static void SkelSkinVert_SwapLittle(SkelSkinVert* vert)
 {
-    FILE* file = fopen(path, "r");
+    /* normal, tangent and weights are all floats */
+    uint32_t* words = (uint32_t*)vert;
+    for (int i = 0; i < 6; ++i)
+        words[i] = End_Swap32(words[i]);
     
-    if (!file)
+    words = (uint32_t*)vert->weights;
+    for (int i = 0; i < SKEL_WEIGHTS_PER_VERT * 4; ++i)
+        words[i] = End_Swap32(words[i]);
+    
+    vert->uv.u = End_Swap16(vert->uv.u);
+    vert->uv.v = End_Swap16(vert->uv.v);
+    
+    for (int i = 0; i < SKEL_WEIGHTS_PER_VERT; ++i)
+        vert->weightJoints[i] = End_Swap16(vert->weightJoints[i]);
+}
+
+/* reads after a short or failed fread return 0, so checking once after a run of reads catches every one */
+static int SkelModel_ReadFailed(FILE* file)
+{
+    return feof(file) || ferror(file);
+}
+
+/* binary skmesh, written by tools/skmeshconvert. see SKEL_MODEL_BINARY_VERSION.
+ data is the file in memory, if it is there */
+static int SkelModel_FromBSKMESH(SkelModel* model, FILE* file, const void* data)
+{
+    char magic[4];
+    
+    if (fread(magic, sizeof(magic), 1, file) != 1 || memcmp(magic, SKEL_MODEL_BINARY_MAGIC, 4) != 0)
+        return 0;
+    
+    /* version 1 has no indices, the skin is welded after loading */
+    int version = SkelModel_ReadWord(file);
+    if (version < 1 || version > SKEL_MODEL_BINARY_VERSION)
+        return 0;
+    
+    int vertCount = SkelModel_ReadWord(file);
+    int weightCount = SkelModel_ReadWord(file);
+    int jointCount = SkelModel_ReadWord(file);
+    int attachPointCount = SkelModel_ReadWord(file);
+    
+    if (SkelModel_ReadFailed(file))
+        return 0;
+    
+    /* Skel_Init takes shorts */
+    if (vertCount < 1 || weightCount < 0 ||
+        jointCount < 1 || jointCount > SHRT_MAX ||
+        attachPointCount < 0 || attachPointCount > SKEL_ATTACH_POINTS_MAX)
+        return 0;
+    
+    /* the verts must be in the file before they are allocated */
+    long vertsOffset = SKEL_MODEL_BINARY_VERTS_OFFSET(jointCount, attachPointCount);
+    long start = ftell(file);
+    
+    if (start < 0 || fseek(file, 0, SEEK_END) != 0)
         return 0;
     
+    long fileSize = ftell(file);
+    
+    if (fseek(file, start, SEEK_SET) != 0 || fileSize < vertsOffset ||
+        vertCount > (fileSize - vertsOffset) / SKEL_MODEL_BINARY_VERT_SIZE)
+        return 0;
+    
+    if (!Skel_Init(&model->skel, jointCount, attachPointCount))
+        return 0;
+    
+    /* skin pointers are null until SkelSkin_Init, so shutting it down early is safe */
+    model->skin.verts = NULL;
+    model->skin.indices = NULL;
+    model->skin.mapped = 0;
+    
+    model->skel.origin = SkelModel_ReadVec3(file);
+    
+    model->material.type = SkelModel_ReadWord(file);
+    model->material.albedoMap = SkelModel_ReadWord(file);
+    model->material.normalMap = SkelModel_ReadWord(file);
+    model->material.specularMap = SkelModel_ReadWord(file);
+    model->material.glossMap = SkelModel_ReadWord(file);
+    
+    for (int i = 0; i < jointCount; ++i)
+    {
+        SkelJoint* joint = model->skel.joints + i;
+        
+        if (fread(joint->name, SKEL_JOINT_NAME_MAX, 1, file) != 1)
+            goto error;
+        
+        joint->name[SKEL_JOINT_NAME_MAX - 1] = '\0';
+        joint->parent = SkelModel_ReadWord(file);
+        joint->tail = SkelModel_ReadVec3(file);
+        joint->rotation = Quat_Identity;
+        
+        if (joint->parent < -1 || joint->parent >= jointCount)
+            goto error;
+    }
+    
+    for (int i = 0; i < attachPointCount; ++i)
+    {
+        SkelAttachPoint* attachPoint = model->skel.attachPoints + i;
+        
+        if (fread(attachPoint->name, SKEL_JOINT_NAME_MAX, 1, file) != 1)
+            goto error;
+        
+        attachPoint->name[SKEL_JOINT_NAME_MAX - 1] = '\0';
+        attachPoint->joint = SkelModel_ReadWord(file);
+        attachPoint->offset = SkelModel_ReadVec3(file);
+        attachPoint->rotation.x = SkelModel_ReadFloat(file);
+        attachPoint->rotation.y = SkelModel_ReadFloat(file);
+        attachPoint->rotation.z = SkelModel_ReadFloat(file);
+        attachPoint->rotation.w = SkelModel_ReadFloat(file);
+        
+        if (attachPoint->joint < 0 || attachPoint->joint >= jointCount)
+            goto error;
+    }
+    
+    if (SkelModel_ReadFailed(file))
+        goto error;
+    
+    /* the vertex block is aligned and laid out exactly as SkelSkinVert */
+    if (ftell(file) > vertsOffset || fseek(file, vertsOffset, SEEK_SET) != 0)
+        goto error;
+    
+    /* in memory, version 2 blocks are used where they lie. The indices follow 84 byte
+     verts and a count, so they are aligned whenever the verts are */
+    const SkelSkinVert* mappedVerts = version >= 2 ? End_LittleInPlace(data, vertsOffset, sizeof(float)) : NULL;
+    
+    if (mappedVerts)
+    {
+        if (!SkelSkin_Init(&model->skin, 0, weightCount) ||
+            fseek(file, (long)vertCount * SKEL_MODEL_BINARY_VERT_SIZE, SEEK_CUR) != 0)
+            goto error;
+        
+        /* the memory is read only, and nothing writes a loaded skin's verts */
+        model->skin.vertCount = vertCount;
+        model->skin.verts = (SkelSkinVert*)mappedVerts;
+        model->skin.mapped = 1;
+    }
+    else
+    {
+        if (!SkelSkin_Init(&model->skin, vertCount, weightCount))
+            goto error;
+        
+        if (fread(model->skin.verts, sizeof(SkelSkinVert), vertCount, file) != vertCount)
+            goto error;
+        
+        if (End_IsBig())
+        {
+            for (int i = 0; i < vertCount; ++i)
+                SkelSkinVert_SwapLittle(model->skin.verts + i);
+        }
+    }
+    
+    for (int i = 0; i < vertCount; ++i)
+    {
+        for (int j = 0; j < SKEL_WEIGHTS_PER_VERT; ++j)
+        {
+            if (model->skin.verts[i].weightJoints[j] >= jointCount)
+                goto error;
+        }
+    }
+    
+    if (version >= 2)
+    {
+        unsigned int indexCount = SkelModel_ReadWord(file);
+        long indicesStart = ftell(file);
+        
+        /* as with the verts, the indices must be in the file before they are allocated */
+        if (SkelModel_ReadFailed(file) || indicesStart < 0 ||
+            indexCount > (unsigned long)(fileSize - indicesStart) / sizeof(unsigned int))
+            goto error;
+        
+        if (indexCount > 0)
+        {
+            if (model->skin.mapped)
+            {
+                model->skin.indexCount = indexCount;
+                model->skin.indices = (unsigned int*)((const unsigned char*)data + indicesStart);
+            }
+            else
+            {
+                if (!SkelSkin_InitIndices(&model->skin, indexCount))
+                    goto error;
+                
+                if (fread(model->skin.indices, sizeof(unsigned int), indexCount, file) != indexCount)
+                    goto error;
+                
+                for (unsigned int i = 0; i < indexCount; ++i)
+                    model->skin.indices[i] = End_ReadLittle32(model->skin.indices[i]);
+            }
+            
+            for (unsigned int i = 0; i < indexCount; ++i)
+            {
+                if (model->skin.indices[i] >= (unsigned int)vertCount)
+                    goto error;
+            }
+        }
+    }
+    
+    return 1;
+    
+error:
+    SkelSkin_Shutdown(&model->skin);
+    Skel_Shutdown(&model->skel);
+    memset(&model->skel, 0, sizeof(Skel));
+    return 0;
+}
+
+static int SkelModel_FromStream(SkelModel* model, FILE* file, const char* extension, const void* data)
+{
     int status = 0;
     
-    if (strcmp(Filepath_Extension(path), "skmesh") == 0)
+    /* before loading, binary meshes carry their own material */
+    Material_Init(&model->material);
+    
+    if (strcmp(extension, "skmesh") == 0)
     {
         status = SkelModel_FromSKMESH(model, file);
     }
-    
-    fclose(file);
+    else if (strcmp(extension, "bskmesh") == 0)
+    {
+        status = SkelModel_FromBSKMESH(model, file, data);
+    }
     
     if (!status)
         return 0;
     
+    /* text meshes list every triangle corner, so shared verts would be skinned once per corner */
+    if (!model->skin.indices && SkelSkin_Weld(&model->skin))
+        SkelSkin_Optimize(&model->skin);
+    
+    /* pose at rest to fit the bounds */
+    Skel_Pose(&model->skel);
+    SkelSkin_CalcBounds(&model->skin, &model->skel);
+    
     SkelAnimator_Init(&model->animator, &model->skel);
-    Material_Init(&model->material);
     
     return 1;
 }
 
+int SkelModel_FromFile(SkelModel* model, FILE* file, const char* extension)
+{
+    return SkelModel_FromStream(model, file, extension, NULL);
+}
+
+int SkelModel_FromMemory(SkelModel* model, const void* data, size_t size, const char* extension)
+{
+    FILE* file = File_OpenMemory(data, size);
+    
+    if (!file)
+        return 0;
+    
+    int status = SkelModel_FromStream(model, file, extension, data);
+    
+    fclose(file);
+    return status;
+}
+
+int SkelModel_FromPath(SkelModel* model, const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    
+    if (!file)
+        return 0;
+    
+    int status = SkelModel_FromFile(model, file, Filepath_Extension(path));
+    
+    fclose(file);
+    return status;
+}
+
 int SkelModel_Copy(SkelModel* dest, const SkelModel* source)
 {
     if (!dest || !source)
@@ -7,6 +7,29 @@
 #include "skel_skin.h"
 #include "material.h"
 
+/*
+ .bskmesh, little endian:
+ char magic[4]
+ int32 version, vertCount, weightCount, jointCount, attachPointCount
+ Vec3 origin
+ int32 material type, albedoMap, normalMap, specularMap, glossMap
+ { char name[SKEL_JOINT_NAME_MAX]; int32 parent; Vec3 tail; } joints[jointCount]
+ { char name[SKEL_JOINT_NAME_MAX]; int32 joint; Vec3 offset; Quat rotation; } attachPoints[attachPointCount]
+ SkelSkinVert verts[vertCount] - at SKEL_MODEL_BINARY_VERTS_OFFSET
+ int32 indexCount, uint32 indices[indexCount] - version 2, verts already welded and cache ordered
+ */
+#define SKEL_MODEL_BINARY_MAGIC "BSKM"
+#define SKEL_MODEL_BINARY_VERSION 2
+#define SKEL_MODEL_BINARY_VERT_SIZE 84
+
+#define SKEL_MODEL_BINARY_VERTS_OFFSET(jointCount, attachPointCount) \
+    ((4 + 4 * 5 + 12 + 4 * 5 + \
+     (jointCount) * (SKEL_JOINT_NAME_MAX + 16) + \
+     (attachPointCount) * (SKEL_JOINT_NAME_MAX + 32) + 15) & ~15)
+
+/* the vertex block is copied straight into SkelSkinVert */
+typedef char SkelModel_VertSizeCheck[sizeof(SkelSkinVert) == SKEL_MODEL_BINARY_VERT_SIZE ? 1 : -1];
+
 /*
  
  Each frame the SkelModel selectes the last and next frame from its anim, interpolates
@@ -35,6 +58,11 @@ typedef struct
 
 extern int SkelModel_Copy(SkelModel* dest, const SkelModel* source);
 extern int SkelModel_FromPath(SkelModel* model, const char* path);
+extern int SkelModel_FromFile(SkelModel* model, FILE* file, const char* extension);
+
+/* data must outlive the model, as in an AssetPack mapping. Version 2 .bskmesh verts
+ and indices are used in place on little endian hosts, everything else is copied */
+extern int SkelModel_FromMemory(SkelModel* model, const void* data, size_t size, const char* extension);
 
 extern void SkelModel_Shutdown(SkelModel* model);
 
@@ -1,7 +1,10 @@
 
 #include "skel_skin.h"
+#include "mesh_opt.h"
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 
 int SkelSkin_Init(SkelSkin* skin, unsigned int vertCount, unsigned int weightCount)
 {
@@ -9,6 +12,9 @@ int SkelSkin_Init(SkelSkin* skin, unsigned int vertCount, unsigned int weightCou
         return 0;
     
     skin->verts = NULL;
+    skin->indices = NULL;
+    skin->indexCount = 0;
+    skin->mapped = 0;
     skin->weightCount = weightCount;
     skin->vertCount = vertCount;
     
@@ -21,13 +27,24 @@ int SkelSkin_Init(SkelSkin* skin, unsigned int vertCount, unsigned int weightCou
     
     skin->vaoGpuId = 0;
     skin->vboGpuId = 0;
+    skin->eboGpuId = 0;
     
+    skin->bounds = Sphere_Create(Vec3_Zero, 0.0f);
+    skin->packScale = 1.0f;
     skin->purgeable = 1;
     
     return 1;
 
 }
 
+int SkelSkin_InitIndices(SkelSkin* skin, unsigned int indexCount)
+{
+    skin->indexCount = indexCount;
+    skin->indices = malloc(sizeof(unsigned int) * indexCount);
+    
+    return skin->indices != NULL;
+}
+
 int SkelSkin_Copy(SkelSkin* dest, const SkelSkin* source)
 {
     assert(dest);
@@ -35,18 +52,39 @@ int SkelSkin_Copy(SkelSkin* dest, const SkelSkin* source)
     
     dest->vaoGpuId = source->vaoGpuId;
     dest->vboGpuId = source->vboGpuId;
+    dest->eboGpuId = source->eboGpuId;
     
     dest->purgeable = source->purgeable;
     
     dest->vertCount = source->vertCount;
     dest->weightCount = source->weightCount;
+    dest->bounds = source->bounds;
+    dest->packScale = source->packScale;
+    dest->indexCount = source->indexCount;
+    
+    /* the copy owns its verts, even of a mapped skin */
+    dest->verts = NULL;
+    dest->indices = NULL;
+    dest->mapped = 0;
     
     if (source->verts)
     {
         dest->verts = calloc(source->vertCount, sizeof(SkelSkinVert));
+        if (!dest->verts)
+            return 0;
+        
         memcpy(dest->verts, source->verts, sizeof(SkelSkinVert) * source->vertCount);
     }
     
+    if (source->indices)
+    {
+        dest->indices = malloc(sizeof(unsigned int) * source->indexCount);
+        if (!dest->indices)
+            return 0;
+        
+        memcpy(dest->indices, source->indices, sizeof(unsigned int) * source->indexCount);
+    }
+    
     return 1;
 }
 
@@ -56,14 +94,193 @@ void SkelSkin_Shutdown(SkelSkin* skin)
         SkelSkin_Purge(skin);
 }
 
+void SkelSkin_CalcBounds(SkelSkin* skin, const Skel* skel)
+{
+    if (!skin->verts)
+        return;
+    
+    /* centered on the model origin so the sphere is unaffected by skeleton rotation */
+    float radiusSq = 0.0f;
+    
+    for (unsigned int i = 0; i < skin->vertCount; ++i)
+    {
+        const SkelSkinVert* vert = skin->verts + i;
+        Vec3 p = Vec3_Zero;
+        
+        for (int j = 0; j < SKEL_WEIGHTS_PER_VERT; ++j)
+        {
+            const SkelJoint* joint = skel->joints + vert->weightJoints[j];
+            Vec3 offset = Quat_MultVec3(&joint->modelRotation, Vec3_FromVec4(vert->weights[j]));
+            p = Vec3_Add(p, Vec3_Scale(Vec3_Add(joint->modelHead, offset), vert->weights[j].w));
+        }
+        
+        radiusSq = MAX(radiusSq, Vec3_LengthSq(p));
+    }
+    
+    skin->bounds = Sphere_Create(Vec3_Zero, sqrtf(radiusSq));
+}
+
 void SkelSkin_Purge(SkelSkin* skin)
 {
-    if (skin->verts)
+    if (!skin->mapped)
     {
         free(skin->verts);
-        skin->verts = NULL;
+        free(skin->indices);
     }
+    
+    /* indexCount is kept for drawing */
+    skin->verts = NULL;
+    skin->indices = NULL;
+    skin->mapped = 0;
 }
 
+static uint32_t SkelSkinVert_Hash(const SkelSkinVert* vert)
+{
+    /* FNV-1a over the whole vert, padding is zeroed by every loader */
+    const unsigned char* bytes = (const unsigned char*)vert;
+    uint32_t hash = 2166136261u;
+    
+    for (size_t i = 0; i < sizeof(SkelSkinVert); ++i)
+        hash = (hash ^ bytes[i]) * 16777619u;
+    
+    return hash;
+}
 
+int SkelSkin_Weld(SkelSkin* skin)
+{
+    if (!skin->verts || skin->indices || skin->mapped)
+        return 0;
+    
+    unsigned int cornerCount = skin->vertCount;
+    
+    unsigned int tableSize = 1;
+    while (tableSize < cornerCount * 2)
+        tableSize <<= 1;
+    
+    /* open addressed, holds unique vert + 1, 0 is empty */
+    unsigned int* table = calloc(tableSize, sizeof(unsigned int));
+    unsigned int* indices = malloc(sizeof(unsigned int) * cornerCount);
+    
+    if (!table || !indices)
+    {
+        free(table);
+        free(indices);
+        return 0;
+    }
+    
+    /* unique verts are compacted to the front in place, they never overtake the corner being read */
+    unsigned int uniqueCount = 0;
+    
+    for (unsigned int i = 0; i < cornerCount; ++i)
+    {
+        const SkelSkinVert* vert = skin->verts + i;
+        unsigned int slot = SkelSkinVert_Hash(vert) & (tableSize - 1);
+        
+        while (table[slot] != 0 && memcmp(skin->verts + table[slot] - 1, vert, sizeof(SkelSkinVert)) != 0)
+            slot = (slot + 1) & (tableSize - 1);
+        
+        if (table[slot] == 0)
+        {
+            if (uniqueCount != i)
+                skin->verts[uniqueCount] = *vert;
+            
+            table[slot] = ++uniqueCount;
+        }
+        
+        indices[i] = table[slot] - 1;
+    }
+    
+    free(table);
+    
+    SkelSkinVert* verts = realloc(skin->verts, sizeof(SkelSkinVert) * uniqueCount);
+    if (verts)
+        skin->verts = verts;
+    
+    skin->vertCount = uniqueCount;
+    skin->indexCount = cornerCount;
+    skin->indices = indices;
+    
+    return 1;
+}
+
+int SkelSkin_Optimize(SkelSkin* skin)
+{
+    if (!skin->verts || !skin->indices || skin->mapped)
+        return 0;
+    
+    return MeshOpt_Optimize(skin->indices, skin->indexCount, skin->verts, skin->vertCount, sizeof(SkelSkinVert));
+}
+
+int SkelSkin_IndexSize(const SkelSkin* skin)
+{
+    return MeshOpt_IndexSize(skin->vertCount);
+}
 
+void SkelSkin_Pack(SkelSkin* skin, SkelSkinPackedVert* dest)
+{
+    if (!skin->verts)
+        return;
+    
+    float maxOffset = V_EPSILON;
+    
+    for (unsigned int i = 0; i < skin->vertCount; ++i)
+    {
+        for (int j = 0; j < SKEL_WEIGHTS_PER_VERT; ++j)
+        {
+            Vec4 w = skin->verts[i].weights[j];
+            maxOffset = MAX(maxOffset, MAX(fabsf(w.x), MAX(fabsf(w.y), fabsf(w.z))));
+        }
+    }
+    
+    skin->packScale = maxOffset / 32767.0f;
+    
+    for (unsigned int i = 0; i < skin->vertCount; ++i)
+    {
+        const SkelSkinVert* vert = skin->verts + i;
+        SkelSkinPackedVert* packed = dest + i;
+        
+        memset(packed, 0, sizeof(SkelSkinPackedVert));
+        
+        Vec2 normal = Vec3_OctEncode(vert->normal);
+        packed->normal[0] = MeshOpt_PackSnorm16(normal.x);
+        packed->normal[1] = MeshOpt_PackSnorm16(normal.y);
+        
+        Vec2 tangent = Vec3_OctEncode(vert->tangent);
+        packed->tangent[0] = MeshOpt_PackSnorm16(tangent.x);
+        packed->tangent[1] = MeshOpt_PackSnorm16(tangent.y);
+        
+        packed->uv = vert->uv;
+        
+        /* exporters don't always normalize, and unnormalized weights could round far from 255 */
+        float weightSum = 0.0f;
+        
+        for (int j = 0; j < SKEL_WEIGHTS_PER_VERT; ++j)
+            weightSum += MAX(vert->weights[j].w, 0.0f);
+        
+        float influenceScale = weightSum > V_EPSILON ? 255.0f / weightSum : 0.0f;
+        
+        int influenceSum = 0;
+        int largest = 0;
+        
+        for (int j = 0; j < SKEL_WEIGHTS_PER_VERT; ++j)
+        {
+            const Vec4* w = vert->weights + j;
+            packed->weightOffsets[j][0] = MeshOpt_PackSnorm16(w->x / maxOffset);
+            packed->weightOffsets[j][1] = MeshOpt_PackSnorm16(w->y / maxOffset);
+            packed->weightOffsets[j][2] = MeshOpt_PackSnorm16(w->z / maxOffset);
+            
+            packed->influences[j] = (unsigned char)CLAMP(roundf(MAX(w->w, 0.0f) * influenceScale), 0.0f, 255.0f);
+            influenceSum += packed->influences[j];
+            
+            if (packed->influences[j] > packed->influences[largest])
+                largest = j;
+            
+            packed->weightJoints[j] = vert->weightJoints[j];
+        }
+        
+        /* rounding error, at most half a step per weight, goes to the largest influence
+         so the vert isn't scaled. The largest is at least 255 / SKEL_WEIGHTS_PER_VERT, so it can't wrap */
+        if (influenceSum > 0)
+            packed->influences[largest] = (unsigned char)(packed->influences[largest] + 255 - influenceSum);
+    }
+}
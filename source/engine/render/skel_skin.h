@@ -2,7 +2,7 @@
 #ifndef SKEL_SKIN_H
 #define SKEL_SKIN_H
 
-#include "vec_math.h"
+#include "geo_math.h"
 #include "skel.h"
 
 
@@ -28,6 +28,25 @@ typedef struct
     unsigned short padding;
 } SkelSkinVert;
 
+/*
+ Compact GPU layout, 48 bytes instead of 84, see Renderer packVerts.
+ normal and tangent are octahedral encoded snorm16.
+ weightOffsets are snorm16 scaled by the skin's packScale, w is unused.
+ influences are unorm8 summing to 255.
+ */
+typedef struct
+{
+    short normal[2];
+    short tangent[2];
+    SkelSkinVertUv uv;
+    
+    short weightOffsets[SKEL_WEIGHTS_PER_VERT][4];
+    unsigned char influences[4];
+    
+    unsigned short weightJoints[SKEL_WEIGHTS_PER_VERT];
+    unsigned short padding;
+} SkelSkinPackedVert;
+
 
 /*
  SkelSkin transform is computationaly expensive on the CPU
@@ -42,23 +61,55 @@ typedef struct
     /* For Renderer */
     unsigned int vaoGpuId;
     unsigned int vboGpuId;
+    unsigned int eboGpuId;
 
     SkelSkinVert* verts;
     
     unsigned int vertCount;
     unsigned int weightCount;
     
+    /* triangle list into verts. 0 indexCount draws the verts in order.
+     Each vert is skinned once, however many triangles share it. Kept after purging for drawing */
+    unsigned int indexCount;
+    unsigned int* indices;
+    
+    /* weight offset = weightOffsets * packScale, set by SkelSkin_Pack */
+    float packScale;
+    
+    /* bounding sphere around the model origin in the rest pose. Kept after the verts are purged for culling. */
+    Sphere bounds;
+    
     int purgeable;
     
+    /* verts and indices point into read only memory the skin doesn't own (see SkelModel_FromMemory).
+     Purging drops them without freeing, and they can't be welded or optimized in place */
+    int mapped;
+    
 } SkelSkin;
 
 /* certain use cases may not require normals, disabling saves computation and memory */
 extern int SkelSkin_Init(SkelSkin* skin, unsigned int vertCount, unsigned int weightCount);
+extern int SkelSkin_InitIndices(SkelSkin* skin, unsigned int indexCount);
 extern int SkelSkin_Copy(SkelSkin* dest, const SkelSkin* source);
 
 extern void SkelSkin_Shutdown(SkelSkin* skin);
 
 extern void SkelSkin_Purge(SkelSkin* skin);
 
+/* fits bounds around the verts in the current pose of skel. Must be called before purging. */
+extern void SkelSkin_CalcBounds(SkelSkin* skin, const Skel* skel);
+
+/* merges identical verts of an unindexed skin and builds indices for them. Must be called before purging. */
+extern int SkelSkin_Weld(SkelSkin* skin);
+
+/* reorders triangles for the vertex cache and verts for fetch order. Must be called before purging. */
+extern int SkelSkin_Optimize(SkelSkin* skin);
+
+/* bytes per index on the GPU, 2 or 4 */
+extern int SkelSkin_IndexSize(const SkelSkin* skin);
+
+/* quantizes the verts into dest, which holds vertCount verts. Must be called before purging. */
+extern void SkelSkin_Pack(SkelSkin* skin, SkelSkinPackedVert* dest);
+
 
 #endif
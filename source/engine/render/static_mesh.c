@@ -1,6 +1,8 @@
 
 #include "static_mesh.h"
+#include "mesh_opt.h"
 #include <assert.h>
+#include <string.h>
 
 int StaticMesh_Init(StaticMesh* mesh, int vertCount, short uvChannelCount)
 {
@@ -9,9 +11,18 @@ int StaticMesh_Init(StaticMesh* mesh, int vertCount, short uvChannelCount)
     
     mesh->vaoGpuId = 0;
     mesh->vboGpuId = 0;
+    mesh->eboGpuId = 0;
+    
+    mesh->verts = NULL;
+    mesh->indices = NULL;
+    mesh->indexCount = 0;
+    mesh->mapped = 0;
 
     mesh->vertCount = vertCount;
     mesh->uvChannelCount = uvChannelCount;
+    mesh->bounds = Sphere_Create(Vec3_Zero, 0.0f);
+    mesh->packScale = Vec3_Create(1.0f, 1.0f, 1.0f);
+    mesh->packOffset = Vec3_Zero;
     
     if (uvChannelCount > STATIC_MESH_UVS)
         return 0;
@@ -28,6 +39,14 @@ int StaticMesh_Init(StaticMesh* mesh, int vertCount, short uvChannelCount)
     return 1;
 }
 
+int StaticMesh_InitIndices(StaticMesh* mesh, unsigned int indexCount)
+{
+    mesh->indexCount = indexCount;
+    mesh->indices = malloc(sizeof(unsigned int) * indexCount);
+    
+    return mesh->indices != NULL;
+}
+
 int StaticMesh_Copy(StaticMesh* dest, const StaticMesh* source)
 {
     if (!dest || !source)
@@ -35,11 +54,21 @@ int StaticMesh_Copy(StaticMesh* dest, const StaticMesh* source)
     
     dest->vaoGpuId = source->vaoGpuId;
     dest->vboGpuId = source->vboGpuId;
+    dest->eboGpuId = source->eboGpuId;
     
     dest->purgeable = source->purgeable;
     
     dest->vertCount = source->vertCount;
     dest->uvChannelCount = source->uvChannelCount;
+    dest->bounds = source->bounds;
+    dest->packScale = source->packScale;
+    dest->packOffset = source->packOffset;
+    dest->indexCount = source->indexCount;
+    
+    /* the copy owns its verts, even of a mapped mesh */
+    dest->verts = NULL;
+    dest->indices = NULL;
+    dest->mapped = 0;
     
     if (source->verts)
     {
@@ -47,7 +76,16 @@ int StaticMesh_Copy(StaticMesh* dest, const StaticMesh* source)
         if (!dest->verts)
             return 0;
         
-        memcpy(dest->verts, source->verts, sizeof(StaticMeshVert));
+        memcpy(dest->verts, source->verts, sizeof(StaticMeshVert) * dest->vertCount);
+    }
+    
+    if (source->indices)
+    {
+        dest->indices = malloc(sizeof(unsigned int) * dest->indexCount);
+        if (!dest->indices)
+            return 0;
+        
+        memcpy(dest->indices, source->indices, sizeof(unsigned int) * dest->indexCount);
     }
     
     return 1;
@@ -61,14 +99,98 @@ void StaticMesh_Shutdown(StaticMesh* mesh)
     StaticMesh_Purge(mesh);
 }
 
+void StaticMesh_CalcBounds(StaticMesh* mesh)
+{
+    if (!mesh->verts || mesh->vertCount < 1)
+        return;
+    
+    Vec3 min = mesh->verts[0].pos;
+    Vec3 max = mesh->verts[0].pos;
+    
+    for (unsigned int i = 1; i < mesh->vertCount; ++i)
+    {
+        Vec3 p = mesh->verts[i].pos;
+        min = Vec3_Create(MIN(min.x, p.x), MIN(min.y, p.y), MIN(min.z, p.z));
+        max = Vec3_Create(MAX(max.x, p.x), MAX(max.y, p.y), MAX(max.z, p.z));
+    }
+    
+    Vec3 center = AABB_Center(AABB_Create(min, max));
+    float radiusSq = 0.0f;
+    
+    for (unsigned int i = 0; i < mesh->vertCount; ++i)
+    {
+        radiusSq = MAX(radiusSq, Vec3_DistSq(center, mesh->verts[i].pos));
+    }
+    
+    mesh->bounds = Sphere_Create(center, sqrtf(radiusSq));
+}
+
 void StaticMesh_Purge(StaticMesh* mesh)
 {
-    if (mesh->verts)
+    if (!mesh->mapped)
     {
         free(mesh->verts);
-        mesh->verts = NULL;
+        free(mesh->indices);
     }
+    
+    /* indexCount is kept for drawing */
+    mesh->verts = NULL;
+    mesh->indices = NULL;
+    mesh->mapped = 0;
 }
 
+int StaticMesh_Optimize(StaticMesh* mesh)
+{
+    if (!mesh->verts || !mesh->indices || mesh->mapped)
+        return 0;
+    
+    return MeshOpt_Optimize(mesh->indices, mesh->indexCount, mesh->verts, mesh->vertCount, sizeof(StaticMeshVert));
+}
 
+int StaticMesh_IndexSize(const StaticMesh* mesh)
+{
+    return MeshOpt_IndexSize(mesh->vertCount);
+}
 
+void StaticMesh_Pack(StaticMesh* mesh, StaticMeshPackedVert* dest)
+{
+    if (!mesh->verts || mesh->vertCount < 1)
+        return;
+    
+    Vec3 min = mesh->verts[0].pos;
+    Vec3 max = mesh->verts[0].pos;
+    
+    for (unsigned int i = 1; i < mesh->vertCount; ++i)
+    {
+        Vec3 p = mesh->verts[i].pos;
+        min = Vec3_Create(MIN(min.x, p.x), MIN(min.y, p.y), MIN(min.z, p.z));
+        max = Vec3_Create(MAX(max.x, p.x), MAX(max.y, p.y), MAX(max.z, p.z));
+    }
+    
+    /* flat axes still need a non zero scale */
+    Vec3 extent = Vec3_Sub(max, min);
+    mesh->packOffset = min;
+    mesh->packScale = Vec3_Create(MAX(extent.x, V_EPSILON) / 65535.0f,
+                                  MAX(extent.y, V_EPSILON) / 65535.0f,
+                                  MAX(extent.z, V_EPSILON) / 65535.0f);
+    
+    for (unsigned int i = 0; i < mesh->vertCount; ++i)
+    {
+        const StaticMeshVert* vert = mesh->verts + i;
+        StaticMeshPackedVert* packed = dest + i;
+        
+        for (int j = 0; j < 3; ++j)
+        {
+            float t = (Vec3_Get(vert->pos, j) - Vec3_Get(mesh->packOffset, j)) / Vec3_Get(mesh->packScale, j);
+            packed->pos[j] = (unsigned short)CLAMP(roundf(t), 0.0f, 65535.0f);
+        }
+        
+        packed->padding = 0;
+        
+        Vec2 normal = Vec3_OctEncode(vert->normal);
+        packed->normal[0] = MeshOpt_PackSnorm16(normal.x);
+        packed->normal[1] = MeshOpt_PackSnorm16(normal.y);
+        
+        memcpy(packed->uv, vert->uv, sizeof(packed->uv));
+    }
+}
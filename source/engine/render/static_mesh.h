@@ -2,7 +2,7 @@
 #ifndef MESH_H
 #define MESH_H
 
-#include "vec_math.h"
+#include "geo_math.h"
 #include <stdlib.h>
 
 /* 0 is color map uvs, 1 is lightmap */
@@ -29,28 +29,73 @@ typedef struct
     StaticMeshVertUv uv[STATIC_MESH_UVS];
 } StaticMeshVert;
 
+/*
+ Compact GPU layout, 20 bytes instead of 32, see Renderer packVerts.
+ pos is unorm16 across the mesh bounds, decoded with packScale and packOffset.
+ normal is octahedral encoded snorm16.
+ */
+typedef struct
+{
+    unsigned short pos[3];
+    unsigned short padding;
+    short normal[2];
+    
+    StaticMeshVertUv uv[STATIC_MESH_UVS];
+} StaticMeshPackedVert;
+
 
 typedef struct
 {
     /* For Renderer */
     unsigned int vaoGpuId;
     unsigned int vboGpuId;
+    unsigned int eboGpuId;
     
     unsigned int vertCount;
     unsigned short uvChannelCount;
     
     StaticMeshVert* verts;
     
+    /* triangle list into verts. 0 indexCount draws the verts in order.
+     Kept 32 bit here, narrowed to 16 bit on upload when the verts fit (see StaticMesh_IndexSize) */
+    unsigned int indexCount;
+    unsigned int* indices;
+    
+    /* position = pos * packScale + packOffset, set by StaticMesh_Pack */
+    Vec3 packScale;
+    Vec3 packOffset;
+    
+    /* bounding sphere in model space. Kept after the verts are purged for culling. */
+    Sphere bounds;
+    
     /* This flag allows the texture's RAM to be deleted after uploading to VRAM. Defaults to true if static, false if dynamic. */
     int purgeable;
     
+    /* verts and indices point into read only memory the mesh doesn't own (see StaticModel_FromMemory).
+     Purging drops them without freeing, and they can't be optimized in place */
+    int mapped;
+    
 } StaticMesh;
 
 extern int StaticMesh_Init(StaticMesh* mesh, int vertCount, short uvChannelCount);
+extern int StaticMesh_InitIndices(StaticMesh* mesh, unsigned int indexCount);
 extern int StaticMesh_Copy(StaticMesh* dest, const StaticMesh* source);
 
 extern void StaticMesh_Shutdown(StaticMesh* mesh);
 
 extern void StaticMesh_Purge(StaticMesh* mesh);
 
+/* fits bounds around the verts. Must be called before purging. */
+extern void StaticMesh_CalcBounds(StaticMesh* mesh);
+
+/* reorders triangles for the vertex cache and verts for fetch order. Must be called before purging.
+ Too slow for load time, tools/meshconvert runs it and writes the result to .bmesh */
+extern int StaticMesh_Optimize(StaticMesh* mesh);
+
+/* bytes per index on the GPU, 2 or 4 */
+extern int StaticMesh_IndexSize(const StaticMesh* mesh);
+
+/* quantizes the verts into dest, which holds vertCount verts. Must be called before purging. */
+extern void StaticMesh_Pack(StaticMesh* mesh, StaticMeshPackedVert* dest);
+
 #endif
@@ -8,151 +8,476 @@
 #include "utils.h"
 
 
-/* indicies for a complete triangle */
+/*
+ OBJ is read in large chunks and tokenized in place, no per line allocation
+ or sscanf. Faces are polygons triangulated as fans, and corners sharing a
+ position/uv/normal triple are merged into one indexed vertex. Corners are
+ chained per position, so the lookup is a short walk rather than a hash.
+ */
 
+#define OBJ_CHUNK_SIZE (64 * 1024)
 
+/* position, uv, normal indices of a face corner - 0 when absent */
 typedef struct
 {
-    int v[3];
-    int uv[3];
-    int n[3];
-} ObjFaceIndexSet;
+    int v;
+    int uv;
+    int n;
+    
+    /* next unique corner with the same position, -1 ends the chain */
+    int next;
+} ObjCorner;
 
-/* Basic OBJ parser requires uvs, normals, and vertices */
-static int StaticModel_FromObj(StaticModel* model, FILE* file)
+static const double kObjPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+};
+
+static int Obj_IsSpace(char c)
 {
-    if (!model) return 0;
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char* Obj_SkipSpace(const char* c)
+{
+    while (Obj_IsSpace(*c)) ++c;
+    return c;
+}
+
+/* locale independent. significant digits past the 18th are dropped, which is far below float precision.
+ Leading zeros aren't significant, so 0.000000123456 keeps every digit */
+static const char* Obj_ParseFloat(const char* c, float* out)
+{
+    c = Obj_SkipSpace(c);
     
-    /* setup buffers */
-    char buffer[1024];
-    memset(buffer, 0x0, sizeof(buffer));
-    char textBuffer[64];
-    memset(textBuffer, 0x0, sizeof(textBuffer));
-    int err = 0;
-    
-    Vec3* vertReadBuffer = NULL;
-    Vec3* normReadBuffer = NULL;
-    Vec2* uvReadBuffer = NULL;
-    ObjFaceIndexSet* faceReadBuffer = NULL;
-
-    /* initialize with some starting values - any number would work this just
-     reduces the amount of reallocs that will be called for most model loads
-     
-     */
-    
-    int startSize = 512;
-    stb__sbmaybegrow(vertReadBuffer, startSize);
-    stb__sbmaybegrow(normReadBuffer, startSize);
-    stb__sbmaybegrow(uvReadBuffer, startSize);
-    stb__sbmaybegrow(faceReadBuffer, startSize);
+    int negative = 0;
+    if (*c == '-' || *c == '+')
+    {
+        negative = (*c == '-');
+        ++c;
+    }
     
-    while (!feof(file))
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    
+    while (*c >= '0' && *c <= '9')
     {
-        fgets(buffer, 1024, file);
-        
-        err = sscanf(buffer, "%s ", textBuffer);
-        
-        if (err == EOF)
+        if (digits < 18) { mantissa = mantissa * 10 + (*c - '0'); digits += mantissa != 0; }
+        else { ++exponent; }
+        ++c;
+    }
+    
+    if (*c == '.')
+    {
+        ++c;
+        while (*c >= '0' && *c <= '9')
         {
-            goto error;
+            if (digits < 18) { mantissa = mantissa * 10 + (*c - '0'); digits += mantissa != 0; --exponent; }
+            ++c;
         }
-        
-        if (strcmp(textBuffer, "s") == 0)
+    }
+    
+    if (*c == 'e' || *c == 'E')
+    {
+        ++c;
+        int expNegative = 0;
+        if (*c == '-' || *c == '+')
         {
-            /* smoothing groups - for noobs*/
+            expNegative = (*c == '-');
+            ++c;
         }
-        else if (strcmp(textBuffer, "v") == 0)
+        
+        /* stops growing before it can overflow, the clamp below makes the result the same */
+        int e = 0;
+        while (*c >= '0' && *c <= '9')
         {
-            /* parse vert */
-            Vec3 vert;
-            err = sscanf(buffer, "%s %f %f %f", textBuffer, &vert.x, &vert.y, &vert.z);
-            stb_sb_push(vertReadBuffer, vert);
+            if (e < 10000) e = e * 10 + (*c - '0');
+            ++c;
         }
-        else if (strcmp(textBuffer, "vt") == 0)
+        
+        exponent += expNegative ? -e : e;
+    }
+    
+    /* an 18 digit mantissa is already infinite or zero as a float past these */
+    exponent = CLAMP(exponent, -70, 70);
+    
+    double value = (double)mantissa;
+    
+    while (exponent > 18) { value *= 1e18; exponent -= 18; }
+    while (exponent < -18) { value /= 1e18; exponent += 18; }
+    
+    value = exponent < 0 ? value / kObjPow10[-exponent] : value * kObjPow10[exponent];
+    
+    *out = (float)(negative ? -value : value);
+    return c;
+}
+
+static const char* Obj_ParseInt(const char* c, int* out)
+{
+    int negative = 0;
+    if (*c == '-')
+    {
+        negative = 1;
+        ++c;
+    }
+    
+    int value = 0;
+    while (*c >= '0' && *c <= '9')
+    {
+        value = value * 10 + (*c - '0');
+        ++c;
+    }
+    
+    *out = negative ? -value : value;
+    return c;
+}
+
+/* OBJ indices start at 1, negative ones count back from the end */
+static int Obj_ResolveIndex(int index, int count)
+{
+    if (index < 0)
+        return count + index + 1;
+    
+    return index;
+}
+
+/* v, v/vt, v//vn or v/vt/vn. returns NULL at the end of the line */
+static const char* Obj_ParseCorner(const char* c, ObjCorner* corner, int vCount, int uvCount, int nCount)
+{
+    c = Obj_SkipSpace(c);
+    
+    if (*c == '\0' || *c == '#')
+        return NULL;
+    
+    corner->v = 0;
+    corner->uv = 0;
+    corner->n = 0;
+    
+    c = Obj_ParseInt(c, &corner->v);
+    
+    if (*c == '/')
+    {
+        ++c;
+        if (*c != '/')
+            c = Obj_ParseInt(c, &corner->uv);
+        
+        if (*c == '/')
         {
-            /* parse uv */
-            Vec2 uv;
-            err = sscanf(buffer, "%s %f %f", textBuffer, &uv.x, &uv.y);
-            stb_sb_push(uvReadBuffer, uv);
+            ++c;
+            c = Obj_ParseInt(c, &corner->n);
         }
-        else if (strcmp(textBuffer, "vn") == 0)
+    }
+    
+    /* skip anything malformed to the next separator */
+    while (*c != '\0' && !Obj_IsSpace(*c))
+        ++c;
+    
+    corner->v = Obj_ResolveIndex(corner->v, vCount);
+    corner->uv = Obj_ResolveIndex(corner->uv, uvCount);
+    corner->n = Obj_ResolveIndex(corner->n, nCount);
+    return c;
+}
+
+/* Basic OBJ parser requires vertices, uvs and normals are optional */
+static int StaticModel_FromObj(StaticModel* model, FILE* file)
+{
+    if (!model) return 0;
+    
+    Vec3* positions = NULL;
+    Vec3* normals = NULL;
+    Vec2* uvs = NULL;
+    
+    /* unique corners in first use order, and a triangle list indexing them */
+    ObjCorner* corners = NULL;
+    unsigned int* indices = NULL;
+    
+    /* first corner using each position */
+    int* positionCorners = NULL;
+    
+    char* chunk = malloc(OBJ_CHUNK_SIZE + 1);
+    
+    if (!chunk)
+        return 0;
+    
+    size_t carried = 0;
+    int done = 0;
+    int status = 1;
+    
+    while (!done && status)
+    {
+        size_t read = fread(chunk + carried, 1, OBJ_CHUNK_SIZE - carried, file);
+        size_t length = carried + read;
+        
+        if (read == 0)
         {
-            /* parse normal */
-            Vec3 norm;
-            err = sscanf(buffer, "%s %f %f %f", textBuffer, &norm.x, &norm.y, &norm.z);
-            stb_sb_push(normReadBuffer, norm);
+            /* flush a last line with no newline */
+            done = 1;
+            if (length == 0)
+                break;
+            
+            chunk[length++] = '\n';
         }
-        else if (strcmp(textBuffer, "f") == 0)
+        
+        char* lineStart = chunk;
+        char* end = chunk + length;
+        
+        for (;;)
         {
-            /* one for each tri */
-            ObjFaceIndexSet face;
-            err = sscanf(buffer,
-                         "%s %d/%d/%d %d/%d/%d %d/%d/%d",
-                         textBuffer,
-                         &face.v[0],
-                         &face.uv[0],
-                         &face.n[0],
-                         &face.v[1],
-                         &face.uv[1],
-                         &face.n[1],
-                         &face.v[2],
-                         &face.uv[2],
-                         &face.n[2]);
+            char* newline = memchr(lineStart, '\n', end - lineStart);
             
-            stb_sb_push(faceReadBuffer, face);
+            if (!newline)
+                break;
+            
+            *newline = '\0';
+            const char* c = Obj_SkipSpace(lineStart);
+            lineStart = newline + 1;
+            
+            if (c[0] == 'v' && Obj_IsSpace(c[1]))
+            {
+                stb_sb_push(positionCorners, -1);
+                
+                Vec3* p = stb_sb_add(positions, 1);
+                c = Obj_ParseFloat(c + 1, &p->x);
+                c = Obj_ParseFloat(c, &p->y);
+                c = Obj_ParseFloat(c, &p->z);
+            }
+            else if (c[0] == 'v' && c[1] == 't' && Obj_IsSpace(c[2]))
+            {
+                Vec2* uv = stb_sb_add(uvs, 1);
+                c = Obj_ParseFloat(c + 2, &uv->x);
+                c = Obj_ParseFloat(c, &uv->y);
+            }
+            else if (c[0] == 'v' && c[1] == 'n' && Obj_IsSpace(c[2]))
+            {
+                Vec3* n = stb_sb_add(normals, 1);
+                c = Obj_ParseFloat(c + 2, &n->x);
+                c = Obj_ParseFloat(c, &n->y);
+                c = Obj_ParseFloat(c, &n->z);
+            }
+            else if (c[0] == 'f' && Obj_IsSpace(c[1]))
+            {
+                int vCount = stb_sb_count(positions);
+                int uvCount = stb_sb_count(uvs);
+                int nCount = stb_sb_count(normals);
+                
+                int faceCorners = 0;
+                int first = -1;
+                int previous = -1;
+                ObjCorner corner;
+                
+                c += 1;
+                while ((c = Obj_ParseCorner(c, &corner, vCount, uvCount, nCount)))
+                {
+                    if (corner.v < 1 || corner.v > vCount ||
+                        corner.uv < 0 || corner.uv > uvCount ||
+                        corner.n < 0 || corner.n > nCount)
+                    {
+                        printf("obj face index out of range\n");
+                        status = 0;
+                        break;
+                    }
+                    
+                    int* link = positionCorners + (corner.v - 1);
+                    
+                    while (*link != -1 &&
+                           (corners[*link].uv != corner.uv || corners[*link].n != corner.n))
+                    {
+                        link = &corners[*link].next;
+                    }
+                    
+                    if (*link == -1)
+                    {
+                        corner.next = -1;
+                        *link = stb_sb_count(corners);
+                        stb_sb_push(corners, corner);
+                    }
+                    
+                    int index = *link;
+                    
+                    if (faceCorners == 0)
+                    {
+                        first = index;
+                    }
+                    else if (faceCorners >= 2)
+                    {
+                        unsigned int* tri = stb_sb_add(indices, 3);
+                        tri[0] = first;
+                        tri[1] = previous;
+                        tri[2] = index;
+                    }
+                    
+                    previous = index;
+                    ++faceCorners;
+                }
+            }
+            /* comments, groups, materials and smoothing are ignored */
         }
         
-        if (err == EOF)
+        /* move the partial line to the front for the next read */
+        carried = end - lineStart;
+        
+        if (carried >= OBJ_CHUNK_SIZE)
         {
-            goto error;
+            printf("obj line too long\n");
+            status = 0;
         }
         
-        textBuffer[0] = ' ';
+        memmove(chunk, lineStart, carried);
     }
     
-    int faceCount = stb_sb_count(faceReadBuffer);
-    
-    /* 3 verts in a tri */
-    StaticMesh_Init(&model->mesh, faceCount * 3, 1);
+    int indexCount = stb_sb_count(indices);
+    int vertCount = stb_sb_count(corners);
     
-    for (int i = 0; i < faceCount; ++i)
+    if (status && indexCount > 0 &&
+        StaticMesh_Init(&model->mesh, vertCount, 1) &&
+        StaticMesh_InitIndices(&model->mesh, indexCount))
     {
-        const ObjFaceIndexSet* indexSet = faceReadBuffer + i;
+        memcpy(model->mesh.indices, indices, sizeof(unsigned int) * indexCount);
         
-        int vertIndex = i * 3;
-        for (int j = 0; j < 3; ++j)
+        for (int i = 0; i < vertCount; ++i)
         {
-            StaticMeshVert* vert = model->mesh.verts + (vertIndex + j);
+            const ObjCorner* corner = corners + i;
+            StaticMeshVert* vert = model->mesh.verts + i;
             
-            /* oddly OBJ indicies start at 1 so we must subtract 1 from each */
-            vert->pos = vertReadBuffer[indexSet->v[j] - 1];
-            vert->normal = normReadBuffer[indexSet->n[j] - 1];
+            vert->pos = positions[corner->v - 1];
+            vert->normal = corner->n ? normals[corner->n - 1] : Vec3_Zero;
+            
+            Vec2 tempUv = corner->uv ? uvs[corner->uv - 1] : Vec2_Zero;
             
-            Vec2 tempUv = uvReadBuffer[indexSet->uv[j] - 1];
-
             /* Store uvs in normalized 16 bit shorts */
             vert->uv[0].u = USHRT_MAX * tempUv.x;
             vert->uv[0].v = USHRT_MAX * tempUv.y;
         }
     }
+    else
+    {
+        status = 0;
+    }
+    
+    free(chunk);
+    
+    stb_sb_free(positions);
+    stb_sb_free(normals);
+    stb_sb_free(uvs);
+    stb_sb_free(corners);
+    stb_sb_free(indices);
+    stb_sb_free(positionCorners);
+    
+    return status;
+}
+
+typedef char StaticModel_VertSizeCheck[sizeof(StaticMeshVert) == STATIC_MODEL_BINARY_VERT_SIZE ? 1 : -1];
+
+static int StaticModel_ReadWord(FILE* file, uint32_t* x)
+{
+    if (fread(x, sizeof(uint32_t), 1, file) != 1)
+        return 0;
+    
+    *x = End_ReadLittle32(*x);
+    return 1;
+}
+
+/* version 2, written by tools/meshconvert. data is the file in memory, if it is there */
+static int StaticModel_FromBMesh2(StaticModel* model, FILE* file, const void* data)
+{
+    uint32_t vertCount, uvChannelCount, indexCount;
+    
+    if (!StaticModel_ReadWord(file, &vertCount) ||
+        !StaticModel_ReadWord(file, &uvChannelCount) ||
+        !StaticModel_ReadWord(file, &indexCount))
+        return 0;
+    
+    if (vertCount < 1 || uvChannelCount > STATIC_MESH_UVS || indexCount % 3 != 0)
+        return 0;
+    
+    /* the counts must describe the rest of the file before anything is allocated */
+    long start = ftell(file);
+    
+    if (start < 0 || fseek(file, 0, SEEK_END) != 0)
+        return 0;
+    
+    long remaining = ftell(file) - start;
+    
+    if (fseek(file, start, SEEK_SET) != 0 ||
+        remaining != (long)vertCount * STATIC_MODEL_BINARY_VERT_SIZE + (long)indexCount * 4)
+        return 0;
+    
+    /* in memory the blocks are used where they lie. The indices follow 32 byte verts,
+     so they are aligned whenever the verts are */
+    const StaticMeshVert* mappedVerts = End_LittleInPlace(data, start, sizeof(float));
+    
+    if (mappedVerts)
+    {
+        const unsigned int* mappedIndices = (const unsigned int*)(mappedVerts + vertCount);
+        
+        for (uint32_t i = 0; i < indexCount; ++i)
+        {
+            if (mappedIndices[i] >= vertCount)
+                return 0;
+        }
+        
+        if (!StaticMesh_Init(&model->mesh, 0, uvChannelCount))
+            return 0;
+        
+        /* the memory is read only, and nothing writes a loaded mesh's verts */
+        model->mesh.vertCount = vertCount;
+        model->mesh.verts = (StaticMeshVert*)mappedVerts;
+        model->mesh.indexCount = indexCount;
+        model->mesh.indices = indexCount > 0 ? (unsigned int*)mappedIndices : NULL;
+        model->mesh.mapped = 1;
+        return 1;
+    }
+    
+    if (!StaticMesh_Init(&model->mesh, vertCount, uvChannelCount))
+        goto error;
+    
+    if (fread(model->mesh.verts, sizeof(StaticMeshVert), vertCount, file) != vertCount)
+        goto error;
+    
+    if (End_IsBig())
+    {
+        for (uint32_t i = 0; i < vertCount; ++i)
+        {
+            uint32_t* words = (uint32_t*)&model->mesh.verts[i];
+            
+            /* pos and normal are floats */
+            for (int j = 0; j < 6; ++j)
+                words[j] = End_Swap32(words[j]);
+            
+            for (int j = 0; j < STATIC_MESH_UVS; ++j)
+            {
+                model->mesh.verts[i].uv[j].u = End_Swap16(model->mesh.verts[i].uv[j].u);
+                model->mesh.verts[i].uv[j].v = End_Swap16(model->mesh.verts[i].uv[j].v);
+            }
+        }
+    }
     
-    stb_sb_free(vertReadBuffer);
-    stb_sb_free(normReadBuffer);
-    stb_sb_free(uvReadBuffer);
-    stb_sb_free(faceReadBuffer);
+    if (indexCount > 0)
+    {
+        if (!StaticMesh_InitIndices(&model->mesh, indexCount))
+            goto error;
         
+        if (fread(model->mesh.indices, sizeof(unsigned int), indexCount, file) != indexCount)
+            goto error;
+        
+        for (uint32_t i = 0; i < indexCount; ++i)
+        {
+            model->mesh.indices[i] = End_ReadLittle32(model->mesh.indices[i]);
+            
+            if (model->mesh.indices[i] >= vertCount)
+                goto error;
+        }
+    }
+    
     return 1;
     
 error:
-    stb_sb_free(vertReadBuffer);
-    stb_sb_free(normReadBuffer);
-    stb_sb_free(uvReadBuffer);
-    stb_sb_free(faceReadBuffer);
-    
+    StaticMesh_Shutdown(&model->mesh);
     return 0;
 }
 
-static int StaticModel_FromBMesh(StaticModel* mesh, FILE* file)
+static int StaticModel_FromBMesh(StaticModel* mesh, FILE* file, const void* data)
 {
     int32_t version;
     int32_t vertCount;
@@ -160,7 +485,11 @@ static int StaticModel_FromBMesh(StaticModel* mesh, FILE* file)
     fread(&version, sizeof(int32_t), 1, file);
     version = End_ReadLittle32(version);
     
-    if (version != 1)
+    if (version == 2)
+    {
+        return StaticModel_FromBMesh2(mesh, file, data);
+    }
+    else if (version != 1)
     {
         return 0;
     }
@@ -293,37 +622,62 @@ static int StaticModel_FromMesh(StaticModel* mesh, FILE* file)
     return 1;
 }
 
-int StaticModel_FromPath(StaticModel* model, const char* path)
+static int StaticModel_FromStream(StaticModel* model, FILE* file, const char* extension, const void* data)
 {
-    FILE* file = fopen(path, "r");
-    
-    if (!file) return 0;
-    
     int status = 0;
         
-    if (strcmp(Filepath_Extension(path), "obj") == 0)
+    if (strcmp(extension, "obj") == 0)
     {
         status = StaticModel_FromObj(model, file);
     }
-    else if (strcmp(Filepath_Extension(path), "mesh") == 0)
+    else if (strcmp(extension, "mesh") == 0)
     {
         status = StaticModel_FromMesh(model, file);
     }
-    else if (strcmp(Filepath_Extension(path), "bmesh") == 0)
+    else if (strcmp(extension, "bmesh") == 0)
     {
-        status = StaticModel_FromBMesh(model, file);
+        status = StaticModel_FromBMesh(model, file, data);
     }
     
-    fclose(file);
-    
     if (!status)
         return 0;
     
+    StaticMesh_CalcBounds(&model->mesh);
     Material_Init(&model->material);
     
     return 1;
 }
 
+int StaticModel_FromFile(StaticModel* model, FILE* file, const char* extension)
+{
+    return StaticModel_FromStream(model, file, extension, NULL);
+}
+
+int StaticModel_FromMemory(StaticModel* model, const void* data, size_t size, const char* extension)
+{
+    FILE* file = File_OpenMemory(data, size);
+    
+    if (!file)
+        return 0;
+    
+    int status = StaticModel_FromStream(model, file, extension, data);
+    
+    fclose(file);
+    return status;
+}
+
+int StaticModel_FromPath(StaticModel* model, const char* path)
+{
+    FILE* file = fopen(path, "r");
+    
+    if (!file) return 0;
+    
+    int status = StaticModel_FromFile(model, file, Filepath_Extension(path));
+    
+    fclose(file);
+    return status;
+}
+
 int StaticModel_Copy(StaticModel* dest, const StaticModel* source)
 {
     if (!dest || !source)
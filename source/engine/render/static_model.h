@@ -2,9 +2,21 @@
 #ifndef STATIC_MODEL_H
 #define STATIC_MODEL_H
 
+#include <stdio.h>
 #include "static_mesh.h"
 #include "material.h"
 
+/*
+ .bmesh, little endian:
+ int32 version, vertCount, uvChannelCount
+ int32 indexCount - version 2
+ { Vec3 pos; Vec3 normal; Vec2 uv0; Vec2 uv1; } verts[vertCount] - version 1
+ StaticMeshVert verts[vertCount] - version 2
+ uint32 indices[indexCount] - version 2, cache ordered by tools/meshconvert
+ */
+#define STATIC_MODEL_BINARY_VERSION 2
+#define STATIC_MODEL_BINARY_VERT_SIZE 32
+
 typedef struct
 {
     StaticMesh mesh;
@@ -12,6 +24,12 @@ typedef struct
 } StaticModel;
 
 extern int StaticModel_FromPath(StaticModel* model, const char* path);
+extern int StaticModel_FromFile(StaticModel* model, FILE* file, const char* extension);
+
+/* data must outlive the model, as in an AssetPack mapping. Version 2 .bmesh verts
+ and indices are used in place on little endian hosts, everything else is copied */
+extern int StaticModel_FromMemory(StaticModel* model, const void* data, size_t size, const char* extension);
+
 extern int StaticModel_Copy(StaticModel* dest, const StaticModel* source);
 
 extern void StaticModel_Shutdown(StaticModel* model);
@@ -93,9 +93,12 @@ enum
     FOURCC_DXT1 = 0x31545844,
     FOURCC_DXT3 = 0x33545844,
     FOURCC_DXT5 = 0x35545844,
+    FOURCC_ATI1 = 0x31495441,
+    FOURCC_BC4U = 0x55344342,
     
     DDPF_FOURCC = 0x4, // for compressed
     DDPF_RGB = 0x40, // for uncompressed
+    DDPF_LUMINANCE = 0x20000, // single channel, uncompressed
     
     DDSCAPS2_CUBEMAP = 0x200,
     DDSCAPS2_CUBEMAP_XP = 0x400,
@@ -197,6 +200,30 @@ int Texture_FromDds(Texture* texture, FILE* file)
             texture->format = kTextureFormatDxt5;
             blockSize = 16;
         }
+        else if (compressFormat == FOURCC_ATI1 || compressFormat == FOURCC_BC4U)
+        {
+            texture->format = kTextureFormatBc4;
+            blockSize = 8;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    else if (flags & DDPF_LUMINANCE)
+    {
+        if (bitCount == 8)
+        {
+            texture->format = kTextureFormatGray;
+        }
+        else if (bitCount == 16)
+        {
+            texture->format = kTextureFormatGray16;
+        }
+        else
+        {
+            return 0;
+        }
     }
     else if (flags & DDPF_RGB)
     {
@@ -241,6 +268,10 @@ int Texture_FromDds(Texture* texture, FILE* file)
     {
         texture->subimageCount = End_ReadLittle32(header.mipMapCount);
         
+        /* count is only written when there are mips */
+        if (texture->subimageCount == 0)
+            texture->subimageCount = 1;
+        
         if (texture->subimageCount >= TEXTURE_SUBIMAGE_MAX)
             return 0;
         
@@ -251,7 +282,12 @@ int Texture_FromDds(Texture* texture, FILE* file)
         
         for (int i = 0; i < texture->subimageCount; ++i)
         {
-            size_t mipLength = ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+            size_t mipLength;
+            
+            if (blockSize > 0)
+                mipLength = ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+            else
+                mipLength = bitCount * width * height / 8;
             
             texture->subimageInfo[i].length = mipLength;
             texture->subimageInfo[i].offset = texture->dataLength;
@@ -398,22 +434,18 @@ static int Texture_FromPvr(Texture* texture, FILE* file)
     return 1;
 }
 
-int Texture_FromPath(Texture* texture, TextureFlags flags, const char* path)
+int Texture_FromFile(Texture* texture, TextureFlags flags, FILE* file, const char* extension)
 {
-    FILE* file = fopen(path, "rb");
-    
-    if (!file) { return 0; }
-    
     int status = 0;
     
     if (!Texture_Init(texture, flags))
         return 0;
     
-    if (strcmp(Filepath_Extension(path), "dds") == 0)
+    if (strcmp(extension, "dds") == 0)
     {
         status = Texture_FromDds(texture, file);
     }
-    else if (strcmp(Filepath_Extension(path), "pvr") == 0)
+    else if (strcmp(extension, "pvr") == 0)
     {
         status = Texture_FromPvr(texture, file);
     }
@@ -422,20 +454,48 @@ int Texture_FromPath(Texture* texture, TextureFlags flags, const char* path)
         status = Texture_FromImage(texture, file);
     }
     
-    fclose(file);
-    
     if (!status)
         return 0;
         
     return 1;
 }
 
+int Texture_FromPath(Texture* texture, TextureFlags flags, const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    
+    if (!file) { return 0; }
+    
+    int status = Texture_FromFile(texture, flags, file, Filepath_Extension(path));
+    
+    fclose(file);
+    return status;
+}
+
 void Texture_Shutdown(Texture* texture)
 {
     if (texture)
         Texture_Purge(texture);
 }
 
+int Texture_IsCompressed(TextureFormat format)
+{
+    switch (format)
+    {
+        case kTextureFormatDxt1:
+        case kTextureFormatDxt3:
+        case kTextureFormatDxt5:
+        case kTextureFormatBc4:
+        case kTextureFormatPvr2:
+        case kTextureFormatPvr2a:
+        case kTextureFormatPvr4:
+        case kTextureFormatPvr4a:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
 void Texture_Purge(Texture* texture)
 {
     if (texture->data)
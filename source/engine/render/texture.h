@@ -2,6 +2,7 @@
 #define TEXTURE_H
 
 #include <stddef.h>
+#include <stdio.h>
 
 
 /*
@@ -67,6 +68,8 @@ typedef enum
     kTextureFormatPvr2a, /* alpha variation */
     kTextureFormatPvr4,
     kTextureFormatPvr4a,  /* alpha variation */
+    kTextureFormatBc4, /* single channel, 4 bits per texel */
+    kTextureFormatGray16,
     kTextureFormatUnknown,
 } TextureFormat;
 
@@ -116,9 +119,14 @@ typedef struct
 } Texture;
 
 extern int Texture_FromPath(Texture* texture, TextureFlags flags, const char* path);
+/* extension selects the decoder, as with the path */
+extern int Texture_FromFile(Texture* texture, TextureFlags flags, FILE* file, const char* extension);
 extern void Texture_Shutdown(Texture* texture);
 
 extern void Texture_Purge(Texture* texture);
 
+/* block compressed formats are uploaded as is */
+extern int Texture_IsCompressed(TextureFormat format);
+
 
 #endif
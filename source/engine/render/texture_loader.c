@@ -0,0 +1,179 @@
+#include "texture_loader.h"
+#include <string.h>
+
+static void TextureBatch_Free(TextureBatch* batch)
+{
+    for (int i = 0; i < batch->count; ++i)
+    {
+        if (batch->loaded[i])
+            Texture_Shutdown(batch->textures + i);
+    }
+}
+
+static void* TextureLoader_Run(void* arg)
+{
+    TextureLoader* loader = arg;
+    TextureBatch* batch = &loader->working;
+    
+    Mutex_Lock(&loader->mutex);
+    
+    while (loader->running)
+    {
+        if (!loader->hasPending)
+        {
+            Cond_Wait(&loader->cond, &loader->mutex);
+            continue;
+        }
+        
+        *batch = loader->pending;
+        loader->hasPending = 0;
+        
+        Mutex_Unlock(&loader->mutex);
+        
+        for (int i = 0; i < batch->count; ++i)
+            batch->loaded[i] = Texture_FromPath(batch->textures + i, batch->flags[i], batch->paths[i]);
+        
+        Mutex_Lock(&loader->mutex);
+        
+        if (batch->tag != loader->tag)
+        {
+            /* superseded while decoding */
+            TextureBatch_Free(batch);
+            continue;
+        }
+        
+        if (loader->hasReady)
+            TextureBatch_Free(&loader->ready);
+        
+        loader->ready = *batch;
+        loader->hasReady = 1;
+        loader->finished = batch->tag;
+        Cond_Broadcast(&loader->cond);
+    }
+    
+    Mutex_Unlock(&loader->mutex);
+    return NULL;
+}
+
+int TextureLoader_Init(TextureLoader* loader)
+{
+    Mutex_Init(&loader->mutex);
+    Cond_Init(&loader->cond);
+    
+    loader->tag = 0;
+    loader->finished = 0;
+    loader->hasPending = 0;
+    loader->hasReady = 0;
+    loader->running = 1;
+    
+    if (!Thread_Start(&loader->thread, TextureLoader_Run, loader))
+    {
+        printf("failed to start texture loader\n");
+        loader->running = 0;
+        return 0;
+    }
+    
+    return 1;
+}
+
+void TextureLoader_Shutdown(TextureLoader* loader)
+{
+    Mutex_Lock(&loader->mutex);
+    
+    int running = loader->running;
+    loader->running = 0;
+    Cond_Broadcast(&loader->cond);
+    
+    Mutex_Unlock(&loader->mutex);
+    
+    if (running)
+        Thread_Join(&loader->thread);
+    
+    if (loader->hasReady)
+        TextureBatch_Free(&loader->ready);
+    
+    Cond_Shutdown(&loader->cond);
+    Mutex_Shutdown(&loader->mutex);
+}
+
+void TextureBatch_Init(TextureBatch* batch)
+{
+    batch->count = 0;
+    batch->tag = 0;
+}
+
+int TextureBatch_Add(TextureBatch* batch, int slot, TextureFlags flags, const char* path)
+{
+    if (batch->count >= TEXTURE_LOADER_BATCH_MAX)
+        return 0;
+    
+    int i = batch->count;
+    batch->slots[i] = slot;
+    batch->flags[i] = flags;
+    batch->loaded[i] = 0;
+    strncpy(batch->paths[i], path, MAX_OS_PATH - 1);
+    batch->paths[i][MAX_OS_PATH - 1] = '\0';
+    
+    ++batch->count;
+    return 1;
+}
+
+unsigned int TextureLoader_Request(TextureLoader* loader, const TextureBatch* batch)
+{
+    Mutex_Lock(&loader->mutex);
+    
+    unsigned int tag = ++loader->tag;
+    
+    /* anything finished belongs to an older request */
+    if (loader->hasReady)
+    {
+        TextureBatch_Free(&loader->ready);
+        loader->hasReady = 0;
+    }
+    
+    if (!loader->running)
+    {
+        /* no thread, decode here rather than never */
+        loader->ready = *batch;
+        loader->ready.tag = tag;
+        
+        for (int i = 0; i < loader->ready.count; ++i)
+            loader->ready.loaded[i] = Texture_FromPath(loader->ready.textures + i, loader->ready.flags[i], loader->ready.paths[i]);
+        
+        loader->hasReady = 1;
+        loader->finished = tag;
+        Mutex_Unlock(&loader->mutex);
+        return tag;
+    }
+    
+    loader->pending = *batch;
+    loader->pending.tag = tag;
+    loader->hasPending = 1;
+    
+    Cond_Broadcast(&loader->cond);
+    Mutex_Unlock(&loader->mutex);
+    
+    return tag;
+}
+
+int TextureLoader_Poll(TextureLoader* loader, TextureBatch* out, int block)
+{
+    Mutex_Lock(&loader->mutex);
+    
+    if (block)
+    {
+        while (loader->running && !loader->hasReady && loader->finished != loader->tag)
+            Cond_Wait(&loader->cond, &loader->mutex);
+    }
+    
+    int ready = loader->hasReady;
+    
+    if (ready)
+    {
+        *out = loader->ready;
+        loader->hasReady = 0;
+    }
+    
+    Mutex_Unlock(&loader->mutex);
+    return ready;
+}
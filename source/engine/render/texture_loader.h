@@ -0,0 +1,71 @@
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include "texture.h"
+#include "thread.h"
+#include "utils.h"
+
+/*
+ Decodes textures on a background thread.
+ 
+ Files are read and decoded off the main thread and handed back as pixel buffers,
+ the caller uploads them on the GL thread. Only the newest batch matters,
+ a request replaces any batch which hasn't finished.
+ */
+
+#define TEXTURE_LOADER_BATCH_MAX 4
+
+typedef struct
+{
+    int count;
+    
+    /* RenderSystem texture slot each entry is destined for */
+    int slots[TEXTURE_LOADER_BATCH_MAX];
+    TextureFlags flags[TEXTURE_LOADER_BATCH_MAX];
+    char paths[TEXTURE_LOADER_BATCH_MAX][MAX_OS_PATH];
+    
+    /* filled by the loader */
+    Texture textures[TEXTURE_LOADER_BATCH_MAX];
+    int loaded[TEXTURE_LOADER_BATCH_MAX];
+    
+    unsigned int tag;
+} TextureBatch;
+
+typedef struct
+{
+    Thread thread;
+    Mutex mutex;
+    Cond cond;
+    
+    int running;
+    
+    /* tag of the newest request, and of the newest decoded */
+    unsigned int tag;
+    unsigned int finished;
+    
+    int hasPending;
+    TextureBatch pending;
+    
+    int hasReady;
+    TextureBatch ready;
+    
+    /* the batch the thread is decoding. Several paths, so kept off the thread stack */
+    TextureBatch working;
+} TextureLoader;
+
+extern int TextureLoader_Init(TextureLoader* loader);
+extern void TextureLoader_Shutdown(TextureLoader* loader);
+
+extern void TextureBatch_Init(TextureBatch* batch);
+extern int TextureBatch_Add(TextureBatch* batch, int slot, TextureFlags flags, const char* path);
+
+/* queues a batch, replacing any not yet finished. Returns the tag of the request.
+ If the thread failed to start the batch is decoded here, so Poll still returns it */
+extern unsigned int TextureLoader_Request(TextureLoader* loader, const TextureBatch* batch);
+
+/* takes the newest batch once decoded.
+ When block is set waits for it, otherwise returns 0 if it isn't ready.
+ The caller owns the texture data of a returned batch. */
+extern int TextureLoader_Poll(TextureLoader* loader, TextureBatch* out, int block);
+
+#endif
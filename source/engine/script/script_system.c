@@ -100,7 +100,7 @@ static ScriptState ScriptCommand_Path(ScriptArg* args, int argCount, void* conte
     if (waypoint)
     {
         Actor* player = SceneSystem_Player(&g_engine.sceneSystem);
-        Actor_StartPath(player, waypoint->position);
+        Actor_StartPath(player, *waypoint->position);
     }
     
     return kScriptStateRun;
@@ -110,7 +110,7 @@ static ScriptState ScriptCommand_WaitPath(ScriptArg* args, int argCount, void* c
 {
     Actor* player = SceneSystem_Player(&g_engine.sceneSystem);
 
-    if (player->onPath)
+    if (*player->onPath)
     {
         ScriptSystem* system = context;
         system->yieldPath = 1;
@@ -185,7 +185,7 @@ void ScriptSystem_Update(ScriptSystem* system)
     {
         Actor* player = SceneSystem_Player(&g_engine.sceneSystem);
 
-        if (!player->onPath)
+        if (!*player->onPath)
         {
             system->interpreter.state = kScriptStateRun;
             system->yieldPath = 0;
@@ -56,6 +56,7 @@ int Snd_Init(Snd* snd,
     if (!snd->data.p)
         return 0;
     
+    snd->ownsData = 1;
     snd->format = kSndFormatRaw;
     return 1;
 
@@ -63,10 +64,12 @@ int Snd_Init(Snd* snd,
 
 void Snd_Shutdown(Snd* snd)
 {
-    if (snd->data.p)
+    if (snd->data.p && snd->ownsData)
     {
         free(snd->data.p);
     }
+    
+    snd->data.p = NULL;
 }
 
 void Snd_GenRand(Snd* snd, float amp)
@@ -202,6 +205,56 @@ int Snd_FromWAV(Snd* snd, FILE* file)
     return 1;
 }
 
+static int Snd_FromWAVMemory(Snd* snd, const unsigned char* data, size_t length)
+{
+    WavHeader header;
+    WavChunkFormat format;
+    WavDataChunk dataChunk;
+    
+    size_t headerLength = sizeof(WavHeader) + sizeof(WavChunkFormat) + sizeof(WavDataChunk);
+    
+    if (length < headerLength)
+        return 0;
+    
+    memcpy(&header, data, sizeof(WavHeader));
+    memcpy(&format, data + sizeof(WavHeader), sizeof(WavChunkFormat));
+    memcpy(&dataChunk, data + sizeof(WavHeader) + sizeof(WavChunkFormat), sizeof(WavDataChunk));
+    
+    assert(format.compressionCode == 1);
+    
+    if (format.bitsPerSample != 8 && format.bitsPerSample != 16 && format.bitsPerSample != 32)
+    {
+        printf("invalid bit depth\n");
+        return 0;
+    }
+    
+    if (dataChunk.chunkSize > length - headerLength)
+        return 0;
+    
+    memset(snd, 0x0, sizeof(Snd));
+    
+    snd->format = kSndFormatRaw;
+    snd->bitsPerSample = format.bitsPerSample;
+    snd->sampleCount = (uint)((dataChunk.chunkSize / format.channelCount) / (format.bitsPerSample / 8));
+    snd->channelCount = format.channelCount;
+    snd->sampleRate = format.sampleRate;
+    snd->bytesPerSecond = format.bytesPerSecond;
+    
+    snd->data.p = (void*)(data + headerLength);
+    snd->ownsData = 0;
+    return 1;
+}
+
+int Snd_FromMemory(Snd* sound, const void* data, size_t length, const char* extension)
+{
+    if (strcmp(extension, "wav") == 0)
+    {
+        return Snd_FromWAVMemory(sound, data, length);
+    }
+    
+    return 0;
+}
+
 int Snd_FromPath(Snd* sound, const char* path)
 {
     FILE* file = fopen(path, "rb");
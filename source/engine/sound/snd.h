@@ -33,6 +33,9 @@ typedef struct
     unsigned int sampleCount;
     SndFormat format;
     
+    /* 0 when data points into memory owned elsewhere (an asset pack) */
+    int ownsData;
+    
 } Snd;
 
 extern int Snd_Init(Snd* snd,
@@ -45,6 +48,9 @@ extern int Snd_Init(Snd* snd,
 
 extern int Snd_FromPath(Snd* sound, const char* path);
 
+/* samples are used in place, data must outlive the sound */
+extern int Snd_FromMemory(Snd* sound, const void* data, size_t length, const char* extension);
+
 
 extern void Snd_Shutdown(Snd* snd);
 
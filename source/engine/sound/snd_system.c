@@ -214,6 +214,14 @@ void SndSystem_LoadSnd(SndSystem* system, int soundIndex, const char* path)
     Snd_FromPath(sound, fullPath);
 }
 
+void SndSystem_LoadSndMemory(SndSystem* system, int soundIndex, const void* data, size_t length, const char* extension)
+{
+    assert(soundIndex < SND_SYSTEM_MAX_SNDS);
+    Snd* sound = system->sounds + soundIndex;
+    
+    Snd_FromMemory(sound, data, length, extension);
+}
+
 int SndSystem_PlaySound(SndSystem* system, int sound)
 {
     SndEmitter* source = SndSystem_PrepareSound(system, system->sounds + sound);
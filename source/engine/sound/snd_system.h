@@ -70,6 +70,7 @@ extern void SndSystem_Shutdown(SndSystem* env);
 extern SndEmitter* SndSystem_PrepareSound(SndSystem* env, const Snd* sound);
 
 extern void SndSystem_LoadSnd(SndSystem* system, int sound, const char* path);
+extern void SndSystem_LoadSndMemory(SndSystem* system, int sound, const void* data, size_t length, const char* extension);
 
 extern int SndSystem_PlaySound(SndSystem* system, int sound);
 extern void SndSystem_SetAmbient(SndSystem* system, int sound);
@@ -5,6 +5,9 @@
 #include "gl_prog.h"
 #include "utils.h"
 #include <string.h>
+#include <limits.h>
+#include <stddef.h>
+#include <assert.h>
 
 
 /*
@@ -20,12 +23,52 @@
 
 #define VBO_OFFSET(i) ((char *)NULL + (i))
 
+/* world matrices for instanced static draws, one per render queue item */
+#define GL_INSTANCES_MAX SCENE_ACTORS_MAX
+
+/* texture unit the joint palette stays bound to, after the material and env map units */
+#define GL_JOINT_PALETTE_UNIT 5
+
+/* frames the CPU may run ahead of the GPU when streaming */
+#define GL_STREAM_FRAMES 3
+
+/* fence for each frame in flight */
+typedef struct
+{
+    GLsync fences[GL_STREAM_FRAMES];
+    int region;
+    
+    /* set when the GPU may still be reading the current region */
+    int busy;
+} GlFrameSync;
+
+/* buffer split into one region per frame in flight.
+ Each frame writes the region the GPU finished with,
+ so uploads never wait on draws still using last frame's data. */
+typedef struct
+{
+    GLuint buffer;
+    size_t regionSize;
+} GlStream;
+
+/* transform feedback output of the skinning pass */
+typedef struct
+{
+    Vec3 position;
+    Vec3 normal;
+    Vec3 tangent;
+} GlSkinnedVert;
+
 enum
 {
     kGl2ProgramStaticLit,
+    kGl2ProgramStaticLitInstanced,
     kGl2ProgramHint,
     kGl2ProgramSkelLit,
     kGl2ProgramSkelSolid,
+    kGl2ProgramSkelSkin,
+    kGl2ProgramSkelLitCached,
+    kGl2ProgramSkelSolidCached,
     kGl2ProgramPart,
     kGl2ProgramGui,
     kGl2ProgramBg,
@@ -44,8 +87,10 @@ enum
     kProgLocEnvMap,
     kProgLocDepth,
     
-    kProgLocJointRotations,
-    kProgLocJointOrigins,
+    kProgLocJoints,
+    kProgLocJointBase,
+    kProgLocPackScale,
+    kProgLocPackOffset,
     kProgLocCamPosition,
     
     kProgLocLightPositions,
@@ -68,8 +113,143 @@ typedef struct
     int partVao;
     int partVbo;
     
+    GlStream instances;
+    Mat4 instanceMatrices[GL_INSTANCES_MAX];
+    
+    /* where this frame's matrices were written, starting with queue item instanceFirst */
+    size_t instanceOffset;
+    int instanceFirst;
+    
+    /* posed joints of every skeleton drawn this frame.
+     Each joint is two texels: rotation, then origin. */
+    GlStream joints;
+    GLuint jointTexture;
+    Vec4* jointPalette;
+    int jointPaletteCapacity;
+    
+    /* first joint of each render queue item in the buffer texture, -1 when it didn't fit and isn't drawn */
+    int jointBases[SCENE_ACTORS_MAX];
+    
+    /* skinned verts of every skeleton drawn this frame, when caching skinning */
+    GLuint skinCacheVbo;
+    GLuint skinCacheVao;
+    int skinCacheCapacity;
+    
+    /* first vert of each render queue item in the skin cache */
+    int skinBases[SCENE_ACTORS_MAX];
+    
+    GlFrameSync frameSync;
+    
+    GlStream hintVerts;
+    GlStream hintIndicies;
+    GlStream guiVerts;
+    GlStream guiIndicies;
+    
+    /* where this frame's data was written in the streams */
+    size_t hintIndexOffset;
+    GLint hintBaseVertex;
+    size_t guiIndexOffset;
+    GLint guiBaseVertex;
+    
 } Gl2Context;
 
+static void GlStream_Init(GlStream* stream, size_t regionSize)
+{
+    stream->regionSize = regionSize;
+    
+    /* copy write binding leaves the bound VAO's element buffer alone */
+    glGenBuffers(1, &stream->buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, stream->buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, regionSize * GL_STREAM_FRAMES, NULL, GL_STREAM_DRAW);
+}
+
+static void GlStream_Shutdown(GlStream* stream)
+{
+    glDeleteBuffers(1, &stream->buffer);
+}
+
+/* grows each region to at least regionSize. Anything written before is dropped */
+static void GlStream_Reserve(GlStream* stream, size_t regionSize)
+{
+    if (regionSize <= stream->regionSize)
+        return;
+    
+    stream->regionSize = regionSize;
+    
+    glBindBuffer(GL_COPY_WRITE_BUFFER, stream->buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, regionSize * GL_STREAM_FRAMES, NULL, GL_STREAM_DRAW);
+}
+
+/* copies data into this frame's region and returns its byte offset in the buffer */
+static size_t GlStream_Write(GlStream* stream, const GlFrameSync* sync, const void* data, size_t size)
+{
+    assert(size <= stream->regionSize);
+    
+    size_t offset = stream->regionSize * sync->region;
+    
+    if (size == 0)
+        return offset;
+    
+    glBindBuffer(GL_COPY_WRITE_BUFFER, stream->buffer);
+    
+    if (sync->busy)
+    {
+        /* GPU is behind, orphan the storage instead of waiting for it */
+        glBufferData(GL_COPY_WRITE_BUFFER, stream->regionSize * GL_STREAM_FRAMES, NULL, GL_STREAM_DRAW);
+    }
+    
+    /* the region's fence has passed (or the storage is new) so no sync is needed */
+    void* dest = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    
+    if (dest)
+    {
+        memcpy(dest, data, size);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+    
+    return offset;
+}
+
+static void GlFrameSync_Init(GlFrameSync* sync)
+{
+    for (int i = 0; i < GL_STREAM_FRAMES; ++i)
+        sync->fences[i] = NULL;
+    
+    sync->region = 0;
+    sync->busy = 0;
+}
+
+static void GlFrameSync_Shutdown(GlFrameSync* sync)
+{
+    for (int i = 0; i < GL_STREAM_FRAMES; ++i)
+    {
+        if (sync->fences[i])
+            glDeleteSync(sync->fences[i]);
+    }
+}
+
+/* polls the fence of the region about to be written, never blocks */
+static void GlFrameSync_Begin(GlFrameSync* sync)
+{
+    GLsync fence = sync->fences[sync->region];
+    sync->busy = 0;
+    
+    if (fence)
+    {
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        sync->busy = (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED);
+        
+        glDeleteSync(fence);
+        sync->fences[sync->region] = NULL;
+    }
+}
+
+static void GlFrameSync_End(GlFrameSync* sync)
+{
+    sync->fences[sync->region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    sync->region = (sync->region + 1) % GL_STREAM_FRAMES;
+}
+
 
 static int Gl_UploadSkelSkin(Renderer* gl, SkelSkin* skin)
 {
@@ -84,33 +264,110 @@ static int Gl_UploadSkelSkin(Renderer* gl, SkelSkin* skin)
     skin->vboGpuId = vboId;
     skin->vaoGpuId = vaoId;
     
-    glBufferData(GL_ARRAY_BUFFER, sizeof(SkelSkinVert) * skin->vertCount, skin->verts, GL_STATIC_DRAW);
-    
-    size_t offset = 0;
-    
-    glEnableVertexAttribArray(kGlAttribNormal);
-    glVertexAttribPointer(kGlAttribNormal, 3, GL_FLOAT, GL_FALSE, sizeof(SkelSkinVert), VBO_OFFSET(offset));
-    offset += sizeof(Vec3);
-    
-    glEnableVertexAttribArray(kGlAttribTangent);
-    glVertexAttribPointer(kGlAttribTangent, 3, GL_FLOAT, GL_FALSE, sizeof(SkelSkinVert), VBO_OFFSET(offset));
-    offset += sizeof(Vec3);
+    if (gl->packVerts)
+    {
+        SkelSkinPackedVert* packed = malloc(sizeof(SkelSkinPackedVert) * skin->vertCount);
+        
+        if (!packed)
+        {
+            glDeleteBuffers(1, &vboId);
+            glDeleteVertexArrays(1, &vaoId);
+            return 0;
+        }
+        
+        SkelSkin_Pack(skin, packed);
+        
+        glBufferData(GL_ARRAY_BUFFER, sizeof(SkelSkinPackedVert) * skin->vertCount, packed, GL_STATIC_DRAW);
+        free(packed);
+        
+        /* integers are converted unnormalized and scaled in the shader, so snorm rules don't matter */
+        GLsizei stride = sizeof(SkelSkinPackedVert);
+        
+        glEnableVertexAttribArray(kGlAttribNormal);
+        glVertexAttribPointer(kGlAttribNormal, 2, GL_SHORT, GL_FALSE, stride, VBO_OFFSET(offsetof(SkelSkinPackedVert, normal)));
+        
+        glEnableVertexAttribArray(kGlAttribTangent);
+        glVertexAttribPointer(kGlAttribTangent, 2, GL_SHORT, GL_FALSE, stride, VBO_OFFSET(offsetof(SkelSkinPackedVert, tangent)));
+        
+        glEnableVertexAttribArray(kGlAttribUv0);
+        glVertexAttribPointer(kGlAttribUv0, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, VBO_OFFSET(offsetof(SkelSkinPackedVert, uv)));
+        
+        for (int i = 0; i < SKEL_WEIGHTS_PER_VERT; ++i)
+        {
+            glEnableVertexAttribArray(kGlAttribWeight0 + i);
+            glVertexAttribPointer(kGlAttribWeight0 + i, 3, GL_SHORT, GL_FALSE, stride, VBO_OFFSET(offsetof(SkelSkinPackedVert, weightOffsets) + sizeof(short) * 4 * i));
+        }
+        
+        /* the float layout keeps influence in weight w, here they are read together */
+        glEnableVertexAttribArray(kGlAttribWeightInfluences);
+        glVertexAttribPointer(kGlAttribWeightInfluences, SKEL_WEIGHTS_PER_VERT, GL_UNSIGNED_BYTE, GL_TRUE, stride, VBO_OFFSET(offsetof(SkelSkinPackedVert, influences)));
+        
+        glEnableVertexAttribArray(kGlAttribWeightJoints);
+        glVertexAttribPointer(kGlAttribWeightJoints, SKEL_WEIGHTS_PER_VERT, GL_SHORT, GL_FALSE, stride, VBO_OFFSET(offsetof(SkelSkinPackedVert, weightJoints)));
+    }
+    else
+    {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(SkelSkinVert) * skin->vertCount, skin->verts, GL_STATIC_DRAW);
+        
+        size_t offset = 0;
+        
+        glEnableVertexAttribArray(kGlAttribNormal);
+        glVertexAttribPointer(kGlAttribNormal, 3, GL_FLOAT, GL_FALSE, sizeof(SkelSkinVert), VBO_OFFSET(offset));
+        offset += sizeof(Vec3);
+        
+        glEnableVertexAttribArray(kGlAttribTangent);
+        glVertexAttribPointer(kGlAttribTangent, 3, GL_FLOAT, GL_FALSE, sizeof(SkelSkinVert), VBO_OFFSET(offset));
+        offset += sizeof(Vec3);
+        
+        glEnableVertexAttribArray(kGlAttribUv0);
+        glVertexAttribPointer(kGlAttribUv0, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(SkelSkinVert), VBO_OFFSET(offset));
+        offset += sizeof(SkelSkinVertUv);
+        
+        for (int i = 0; i < SKEL_WEIGHTS_PER_VERT; ++i)
+        {
+            glEnableVertexAttribArray(kGlAttribWeight0 + i);
+            glVertexAttribPointer(kGlAttribWeight0 + i, 4, GL_FLOAT, GL_FALSE, sizeof(SkelSkinVert), VBO_OFFSET(offset));
+            offset += sizeof(Vec4);
+        }
+        
+        glEnableVertexAttribArray(kGlAttribWeightJoints);
+        glVertexAttribPointer(kGlAttribWeightJoints, SKEL_WEIGHTS_PER_VERT, GL_SHORT, GL_FALSE, sizeof(SkelSkinVert), VBO_OFFSET(offset));
+        //offset += sizeof(short) * SKEL_WEIGHTS_PER_VERT;
+    }
     
-    glEnableVertexAttribArray(kGlAttribUv0);
-    glVertexAttribPointer(kGlAttribUv0, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(SkelSkinVert), VBO_OFFSET(offset));
-    offset += sizeof(SkelSkinVertUv);
+    skin->eboGpuId = 0;
     
-    for (int i = 0; i < SKEL_WEIGHTS_PER_VERT; ++i)
+    if (skin->indexCount > 0)
     {
-        glEnableVertexAttribArray(kGlAttribWeight0 + i);
-        glVertexAttribPointer(kGlAttribWeight0 + i, 4, GL_FLOAT, GL_FALSE, sizeof(SkelSkinVert), VBO_OFFSET(offset));
-        offset += sizeof(Vec4);
+        /* bound to the skin VAO for uncached drawing, and onto the skin cache VAO per draw */
+        glGenBuffers(1, &skin->eboGpuId);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, skin->eboGpuId);
+        
+        if (SkelSkin_IndexSize(skin) == 2)
+        {
+            unsigned short* narrow = malloc(sizeof(unsigned short) * skin->indexCount);
+            
+            if (!narrow)
+            {
+                glDeleteBuffers(1, &skin->eboGpuId);
+                glDeleteBuffers(1, &vboId);
+                glDeleteVertexArrays(1, &vaoId);
+                skin->eboGpuId = 0;
+                return 0;
+            }
+            
+            for (unsigned int j = 0; j < skin->indexCount; ++j)
+                narrow[j] = (unsigned short)skin->indices[j];
+            
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned short) * skin->indexCount, narrow, GL_STATIC_DRAW);
+            free(narrow);
+        }
+        else
+        {
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * skin->indexCount, skin->indices, GL_STATIC_DRAW);
+        }
     }
     
-    glEnableVertexAttribArray(kGlAttribWeightJoints);
-    glVertexAttribPointer(kGlAttribWeightJoints, SKEL_WEIGHTS_PER_VERT, GL_SHORT, GL_FALSE, sizeof(SkelSkinVert), VBO_OFFSET(offset));
-    //offset += sizeof(short) * SKEL_WEIGHTS_PER_VERT;
-    
     if (skin->purgeable)
     {
         SkelSkin_Purge(skin);
@@ -123,6 +380,9 @@ static int Gl_CleanupSkelSkin(Renderer* gl, SkelSkin* skin)
 {
     glDeleteBuffers(1, &skin->vboGpuId);
     glDeleteVertexArrays(1, &skin->vaoGpuId);
+    
+    if (skin->eboGpuId)
+        glDeleteBuffers(1, &skin->eboGpuId);
 
     return 1;
 }
@@ -140,24 +400,103 @@ static int Gl_UploadMesh(Renderer* gl, StaticMesh* mesh)
     mesh->vboGpuId = vboId;
     mesh->vaoGpuId = vaoId;
     
-    glBufferData(GL_ARRAY_BUFFER, sizeof(StaticMeshVert) * mesh->vertCount, mesh->verts, GL_STATIC_DRAW);
-
-    size_t offset = 0;
+    int i;
     
-    glEnableVertexAttribArray(kGlAttribVertex);
-    glVertexAttribPointer(kGlAttribVertex, 3, GL_FLOAT, GL_FALSE, sizeof(StaticMeshVert), VBO_OFFSET(offset));
-    offset += sizeof(Vec3);
+    if (gl->packVerts)
+    {
+        StaticMeshPackedVert* packed = malloc(sizeof(StaticMeshPackedVert) * mesh->vertCount);
+        
+        if (!packed)
+        {
+            glDeleteBuffers(1, &vboId);
+            glDeleteVertexArrays(1, &vaoId);
+            return 0;
+        }
+        
+        StaticMesh_Pack(mesh, packed);
+        
+        glBufferData(GL_ARRAY_BUFFER, sizeof(StaticMeshPackedVert) * mesh->vertCount, packed, GL_STATIC_DRAW);
+        free(packed);
+        
+        /* unnormalized, the shader applies packScale and packOffset */
+        GLsizei stride = sizeof(StaticMeshPackedVert);
+        
+        glEnableVertexAttribArray(kGlAttribVertex);
+        glVertexAttribPointer(kGlAttribVertex, 3, GL_UNSIGNED_SHORT, GL_FALSE, stride, VBO_OFFSET(offsetof(StaticMeshPackedVert, pos)));
+        
+        glEnableVertexAttribArray(kGlAttribNormal);
+        glVertexAttribPointer(kGlAttribNormal, 2, GL_SHORT, GL_FALSE, stride, VBO_OFFSET(offsetof(StaticMeshPackedVert, normal)));
+        
+        for (i = 0; i < mesh->uvChannelCount; ++i)
+        {
+            glEnableVertexAttribArray(kGlAttribUv0 + i);
+            glVertexAttribPointer(kGlAttribUv0 + i, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, VBO_OFFSET(offsetof(StaticMeshPackedVert, uv) + sizeof(StaticMeshVertUv) * i));
+        }
+    }
+    else
+    {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(StaticMeshVert) * mesh->vertCount, mesh->verts, GL_STATIC_DRAW);
+        
+        size_t offset = 0;
+        
+        glEnableVertexAttribArray(kGlAttribVertex);
+        glVertexAttribPointer(kGlAttribVertex, 3, GL_FLOAT, GL_FALSE, sizeof(StaticMeshVert), VBO_OFFSET(offset));
+        offset += sizeof(Vec3);
+        
+        glEnableVertexAttribArray(kGlAttribNormal);
+        glVertexAttribPointer(kGlAttribNormal, 3, GL_FLOAT, GL_FALSE, sizeof(StaticMeshVert), VBO_OFFSET(offset));
+        offset += sizeof(Vec3);
+        
+        for (i = 0; i < mesh->uvChannelCount; ++i)
+        {
+            glEnableVertexAttribArray(kGlAttribUv0 + i);
+            glVertexAttribPointer(kGlAttribUv0 + i, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(StaticMeshVert), VBO_OFFSET(offset));
+            offset += sizeof(StaticMeshVertUv);
+        }
+    }
     
-    glEnableVertexAttribArray(kGlAttribNormal);
-    glVertexAttribPointer(kGlAttribNormal, 3, GL_FLOAT, GL_FALSE, sizeof(StaticMeshVert), VBO_OFFSET(offset));
-    offset += sizeof(Vec3);
+    mesh->eboGpuId = 0;
     
-    int i;
-    for (i = 0; i < mesh->uvChannelCount; ++i)
+    if (mesh->indexCount > 0)
+    {
+        /* the element buffer binding is VAO state */
+        glGenBuffers(1, &mesh->eboGpuId);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->eboGpuId);
+        
+        if (StaticMesh_IndexSize(mesh) == 2)
+        {
+            unsigned short* narrow = malloc(sizeof(unsigned short) * mesh->indexCount);
+            
+            if (!narrow)
+            {
+                glDeleteBuffers(1, &mesh->eboGpuId);
+                glDeleteBuffers(1, &vboId);
+                glDeleteVertexArrays(1, &vaoId);
+                mesh->eboGpuId = 0;
+                return 0;
+            }
+            
+            for (unsigned int j = 0; j < mesh->indexCount; ++j)
+                narrow[j] = (unsigned short)mesh->indices[j];
+            
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned short) * mesh->indexCount, narrow, GL_STATIC_DRAW);
+            free(narrow);
+        }
+        else
+        {
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * mesh->indexCount, mesh->indices, GL_STATIC_DRAW);
+        }
+    }
+    
+    /* per instance world matrix, re-pointed into the instance buffer for each batch */
+    Gl2Context* ctx = gl->context;
+    glBindBuffer(GL_ARRAY_BUFFER, ctx->instances.buffer);
+    
+    for (i = 0; i < 4; ++i)
     {
-        glEnableVertexAttribArray(kGlAttribUv0 + i);
-        glVertexAttribPointer(kGlAttribUv0 + i, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(StaticMeshVert), VBO_OFFSET(offset));
-        offset += sizeof(StaticMeshVertUv);
+        glEnableVertexAttribArray(kGlAttribInstanceModel + i);
+        glVertexAttribPointer(kGlAttribInstanceModel + i, 4, GL_FLOAT, GL_FALSE, sizeof(Mat4), VBO_OFFSET(sizeof(Vec4) * i));
+        glVertexAttribDivisor(kGlAttribInstanceModel + i, 1);
     }
     
     if (mesh->purgeable)
@@ -171,6 +510,9 @@ static int Gl_CleanupMesh(Renderer* gl, StaticMesh* mesh)
     glDeleteVertexArrays(1, &mesh->vaoGpuId);
     glDeleteBuffers(1, &mesh->vboGpuId);
     
+    if (mesh->eboGpuId)
+        glDeleteBuffers(1, &mesh->eboGpuId);
+    
     return 1;
 }
 
@@ -216,6 +558,14 @@ static GLenum Gl_GetTextureFormat(TextureFormat textureFormat)
         case kTextureFormatGray:
             format = GL_RED;
             break;
+        case kTextureFormatGray16:
+            format = GL_R16;
+            break;
+#ifdef GL_COMPRESSED_RED_RGTC1
+        case kTextureFormatBc4:
+            format = GL_COMPRESSED_RED_RGTC1;
+            break;
+#endif
         default:
             format = GL_RGBA;
             break;
@@ -277,7 +627,7 @@ static int Gl_UploadTexture2d(Renderer* gl, Texture* texture)
     
     GLenum format = Gl_GetTextureFormat(texture->format);
     
-    if (texture->subimageCount > 1)
+    if (Texture_IsCompressed(texture->format))
     {
         short width = texture->width;
         short height = texture->height;
@@ -295,10 +645,26 @@ static int Gl_UploadTexture2d(Renderer* gl, Texture* texture)
     else
     {
         GLenum internalFormat = GL_RGBA;
+        GLenum type = GL_UNSIGNED_BYTE;
+        
         if (texture->format == kTextureFormatRGB)
+        {
             internalFormat = GL_RGB;
+        }
+        else if (texture->format == kTextureFormatGray)
+        {
+            internalFormat = GL_RED;
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        }
+        else if (texture->format == kTextureFormatGray16)
+        {
+            internalFormat = GL_RED;
+            type = GL_UNSIGNED_SHORT;
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+        }
         
-        glTexImage2D(GL_TEXTURE_2D, 0, format, texture->width, texture->height, 0, internalFormat, GL_UNSIGNED_BYTE, texture->data);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, texture->width, texture->height, 0, internalFormat, type, texture->data);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
         
         if (texture->flags & kTextureFlagMipmap)
             glGenerateMipmap(GL_TEXTURE_2D);
@@ -395,17 +761,21 @@ static int Gl_PrepareBgBuffer(Renderer* gl, BgBuffer* buffer)
 
 static int Gl_PrepareHintBuffer(Renderer* gl, HintBuffer* buffer)
 {
+    Gl2Context* ctx = gl->context;
+    
+    GlStream_Init(&ctx->hintIndicies, sizeof(unsigned short) * HINT_VERTS_MAX);
+    GlStream_Init(&ctx->hintVerts, sizeof(HintVert) * HINT_VERTS_MAX);
+    
+    /* attributes point at the first region, draws select the others with a base vertex */
     GLuint vao, vbo, ibo;
     glGenVertexArrays(1, &vao);
     glBindVertexArray(vao);
     
-    glGenBuffers(1, &ibo);
+    ibo = ctx->hintIndicies.buffer;
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned short) * HINT_VERTS_MAX, NULL, GL_DYNAMIC_DRAW);
     
-    glGenBuffers(1, &vbo);
+    vbo = ctx->hintVerts.buffer;
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, HINT_VERTS_MAX * sizeof(HintVert), NULL, GL_DYNAMIC_DRAW);
     
     size_t offset = 0;
     glEnableVertexAttribArray(kGlAttribVertex);
@@ -425,25 +795,30 @@ static int Gl_PrepareHintBuffer(Renderer* gl, HintBuffer* buffer)
 
 static int Gl_CleanupHintBuffer(Renderer* gl, HintBuffer* buffer)
 {
+    Gl2Context* ctx = gl->context;
+    
     glDeleteVertexArrays(1, &buffer->vaoGpuId);
-    glDeleteBuffers(1, &buffer->iboGpuId);
-    glDeleteBuffers(1, &buffer->vboGpuId);
+    GlStream_Shutdown(&ctx->hintIndicies);
+    GlStream_Shutdown(&ctx->hintVerts);
     return 1;
 }
 
 static int Gl_PrepareGuiBuffer(Renderer* gl, GuiBuffer* buffer)
 {
+    Gl2Context* ctx = gl->context;
+    
+    GlStream_Init(&ctx->guiIndicies, sizeof(unsigned short) * GUI_VERTS_MAX);
+    GlStream_Init(&ctx->guiVerts, sizeof(GuiVert) * GUI_VERTS_MAX);
+    
     GLuint vao, vbo, ibo;
     glGenVertexArrays(1, &vao);
     glBindVertexArray(vao);
     
-    glGenBuffers(1, &ibo);
+    ibo = ctx->guiIndicies.buffer;
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned short) * GUI_VERTS_MAX, 0, GL_DYNAMIC_DRAW);
     
-    glGenBuffers(1, &vbo);
+    vbo = ctx->guiVerts.buffer;
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, GUI_VERTS_MAX * sizeof(GuiVert), 0, GL_DYNAMIC_DRAW);
     
     size_t offset = 0;
     glEnableVertexAttribArray(kGlAttribVertex);
@@ -470,9 +845,11 @@ static int Gl_PrepareGuiBuffer(Renderer* gl, GuiBuffer* buffer)
 
 static int Gl_CleanupGuiBuffer(Renderer* gl, GuiBuffer* buffer)
 {
+    Gl2Context* ctx = gl->context;
+    
     glDeleteVertexArrays(1, &buffer->vaoGpuId);
-    glDeleteBuffers(1, &buffer->iboGpuId);
-    glDeleteBuffers(1, &buffer->vboGpuId);
+    GlStream_Shutdown(&ctx->guiIndicies);
+    GlStream_Shutdown(&ctx->guiVerts);
     return 1;
 }
 
@@ -532,11 +909,32 @@ static int Gl_CheckCompatibility(Renderer* gl, RendererLimits* limits)
 #endif // __APPLE__
     printf("vertex uniform components: %i\n", components);
     
-    limits->maxSkelJoints = components / 4;
+    /* joints are read from a buffer texture, two texels each, rather than uniforms.
+     It holds a region for each frame in flight */
+    GLint bufferTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &bufferTexels);
+    printf("texture buffer texels: %i\n", bufferTexels);
+    
+    limits->maxSkelJoints = MIN(bufferTexels / 2 / GL_STREAM_FRAMES, USHRT_MAX);
     
     GLint maxTextureSize = 0;
     glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
     limits->maxTextureSize = maxTextureSize;
+    
+    limits->textureDxt = 0;
+    
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    
+    for (int i = 0; i < extensionCount; ++i)
+    {
+        const char* name = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        
+        if (name && strcmp(name, "GL_EXT_texture_compression_s3tc") == 0)
+            limits->textureDxt = 1;
+    }
+    
+    printf("dxt textures: %i\n", limits->textureDxt);
     return 1;
 }
 
@@ -556,6 +954,9 @@ static int Gl_Init(Renderer* gl)
 
     glEnable(GL_SCISSOR_TEST);
     
+    /* mesh shaders decode the vertex layout chosen for uploads */
+    GlProg_SetDefines(gl->packVerts ? "#define PACKED_VERTS 1\n" : NULL);
+    
     // background shader
     // ------------------------------------
     
@@ -594,6 +995,66 @@ static int Gl_Init(Renderer* gl)
     GlProg_MapUniformLoc(staticLit, "u_specular", kProgLocSpecular);
     GlProg_MapUniformLoc(staticLit, "u_camPosition", kProgLocCamPosition);
     GlProg_MapUniformLoc(staticLit, "u_lightPositions[0]", kProgLocLightPositions);
+    GlProg_MapUniformLoc(staticLit, "u_packScale", kProgLocPackScale);
+    GlProg_MapUniformLoc(staticLit, "u_packOffset", kProgLocPackOffset);
+    
+    // instanced object shader
+    // ------------------------------------
+    
+    Filepath_Append(vertPath, Filepath_DataPath(), "shaders/static_lit_instanced.vs");
+    Filepath_Append(fragPath, Filepath_DataPath(), "shaders/static_lit.fs");
+    
+    GlProg* staticInstanced = ctx->programs + kGl2ProgramStaticLitInstanced;
+    GlProg_InitWithPaths(staticInstanced, vertPath, fragPath);
+    
+    GlProg_BindAttrib(staticInstanced, kGlAttribVertex, "a_vertex");
+    GlProg_BindAttrib(staticInstanced, kGlAttribNormal, "a_normal");
+    GlProg_BindAttrib(staticInstanced, kGlAttribUv0, "a_uv0");
+    GlProg_BindAttrib(staticInstanced, kGlAttribInstanceModel, "a_model");
+    GlProg_Link(staticInstanced, 1);
+    
+    GlProg_MapUniformLoc(staticInstanced, "u_view", kProgLocView);
+    GlProg_MapUniformLoc(staticInstanced, "u_projection", kProgLocProjection);
+    GlProg_MapUniformLoc(staticInstanced, "u_albedo", kProgLocAlbedo);
+    GlProg_MapUniformLoc(staticInstanced, "u_specular", kProgLocSpecular);
+    GlProg_MapUniformLoc(staticInstanced, "u_camPosition", kProgLocCamPosition);
+    GlProg_MapUniformLoc(staticInstanced, "u_lightPositions[0]", kProgLocLightPositions);
+    GlProg_MapUniformLoc(staticInstanced, "u_packScale", kProgLocPackScale);
+    GlProg_MapUniformLoc(staticInstanced, "u_packOffset", kProgLocPackOffset);
+    
+    GlStream_Init(&ctx->instances, sizeof(Mat4) * GL_INSTANCES_MAX);
+    ctx->instanceOffset = 0;
+    ctx->instanceFirst = 0;
+    
+    ctx->jointPalette = NULL;
+    ctx->jointPaletteCapacity = 0;
+    
+    /* grown with the palette. The texture spans every region, shaders offset into this frame's */
+    GlStream_Init(&ctx->joints, sizeof(Vec4) * 2);
+    
+    glGenTextures(1, &ctx->jointTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, ctx->jointTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, ctx->joints.buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    
+    /* attribute pointers are re-pointed at each skin's range before drawing */
+    ctx->skinCacheCapacity = 0;
+    
+    glGenVertexArrays(1, &ctx->skinCacheVao);
+    glBindVertexArray(ctx->skinCacheVao);
+    
+    glGenBuffers(1, &ctx->skinCacheVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, ctx->skinCacheVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(GlSkinnedVert), NULL, GL_STREAM_COPY);
+    
+    glEnableVertexAttribArray(kGlAttribVertex);
+    glEnableVertexAttribArray(kGlAttribNormal);
+    glEnableVertexAttribArray(kGlAttribTangent);
+    glEnableVertexAttribArray(kGlAttribUv0);
+    
+    glBindVertexArray(0);
+    
+    GlFrameSync_Init(&ctx->frameSync);
 
     
     // Skeleton shader
@@ -614,6 +1075,7 @@ static int Gl_Init(Renderer* gl)
     GlProg_BindAttrib(skel, kGlAttribWeight0, "a_weight0");
     GlProg_BindAttrib(skel, kGlAttribWeight1, "a_weight1");
     GlProg_BindAttrib(skel, kGlAttribWeight2, "a_weight2");
+    GlProg_BindAttrib(skel, kGlAttribWeightInfluences, "a_weight_influences");
     
     GlProg_Link(skel, 1);
     
@@ -630,8 +1092,9 @@ static int Gl_Init(Renderer* gl)
     GlProg_MapUniformLoc(skel, "u_camPosition", kProgLocCamPosition);
     GlProg_MapUniformLoc(skel, "u_lightPositions[0]", kProgLocLightPositions);
 
-    GlProg_MapUniformLoc(skel, "u_jointRotations[0]", kProgLocJointRotations);
-    GlProg_MapUniformLoc(skel, "u_jointOrigins[0]", kProgLocJointOrigins);
+    GlProg_MapUniformLoc(skel, "u_joints", kProgLocJoints);
+    GlProg_MapUniformLoc(skel, "u_jointBase", kProgLocJointBase);
+    GlProg_MapUniformLoc(skel, "u_packScale", kProgLocPackScale);
     
     // Skeleton solid shader
     // ------------------------------------
@@ -646,16 +1109,92 @@ static int Gl_Init(Renderer* gl)
     GlProg_BindAttrib(skelSolid, kGlAttribWeight0, "a_weight0");
     GlProg_BindAttrib(skelSolid, kGlAttribWeight1, "a_weight1");
     GlProg_BindAttrib(skelSolid, kGlAttribWeight2, "a_weight2");
+    GlProg_BindAttrib(skelSolid, kGlAttribWeightInfluences, "a_weight_influences");
     
     GlProg_Link(skelSolid, 1);
     
-    GlProg_MapUniformLoc(skelSolid, "u_model", kProgLocModel);
+    /* one model matrix and color per light, selected by instance */
+    GlProg_MapUniformLoc(skelSolid, "u_models[0]", kProgLocModel);
     GlProg_MapUniformLoc(skelSolid, "u_view", kProgLocView);
     GlProg_MapUniformLoc(skelSolid, "u_projection", kProgLocProjection);
     
-    GlProg_MapUniformLoc(skelSolid, "u_jointRotations[0]", kProgLocJointRotations);
-    GlProg_MapUniformLoc(skelSolid, "u_jointOrigins[0]", kProgLocJointOrigins);
-    GlProg_MapUniformLoc(skelSolid, "u_color", kProgLocColor);
+    GlProg_MapUniformLoc(skelSolid, "u_joints", kProgLocJoints);
+    GlProg_MapUniformLoc(skelSolid, "u_jointBase", kProgLocJointBase);
+    GlProg_MapUniformLoc(skelSolid, "u_packScale", kProgLocPackScale);
+    GlProg_MapUniformLoc(skelSolid, "u_colors[0]", kProgLocColor);
+    
+    // Skeleton skinning shader
+    // ------------------------------------
+    /* vertex only, results are captured with transform feedback */
+    Filepath_Append(vertPath, Filepath_DataPath(), "shaders/skel_skin.vs");
+    
+    GlProg* skelSkin = ctx->programs + kGl2ProgramSkelSkin;
+    GlProg_Init(skelSkin);
+    GlProg_CompilePath(skelSkin, kGlShaderTypeVertex, vertPath, 1);
+    GlProg_Attach(skelSkin, kGlShaderTypeVertex);
+    
+    GlProg_BindAttrib(skelSkin, kGlAttribNormal, "a_normal");
+    GlProg_BindAttrib(skelSkin, kGlAttribTangent, "a_tangent");
+    GlProg_BindAttrib(skelSkin, kGlAttribWeightJoints, "a_weight_joints");
+    
+    GlProg_BindAttrib(skelSkin, kGlAttribWeight0, "a_weight0");
+    GlProg_BindAttrib(skelSkin, kGlAttribWeight1, "a_weight1");
+    GlProg_BindAttrib(skelSkin, kGlAttribWeight2, "a_weight2");
+    GlProg_BindAttrib(skelSkin, kGlAttribWeightInfluences, "a_weight_influences");
+    
+    const char* skinVaryings[] = {"tf_position", "tf_normal", "tf_tangent"};
+    glTransformFeedbackVaryings(skelSkin->programId, 3, skinVaryings, GL_INTERLEAVED_ATTRIBS);
+    
+    GlProg_Link(skelSkin, 1);
+    
+    GlProg_MapUniformLoc(skelSkin, "u_joints", kProgLocJoints);
+    GlProg_MapUniformLoc(skelSkin, "u_jointBase", kProgLocJointBase);
+    GlProg_MapUniformLoc(skelSkin, "u_packScale", kProgLocPackScale);
+    
+    // Skeleton shader, pre-skinned
+    // ------------------------------------
+    Filepath_Append(vertPath, Filepath_DataPath(), "shaders/skel_lit_cached.vs");
+    Filepath_Append(fragPath, Filepath_DataPath(), "shaders/skel_lit.fs");
+    
+    GlProg* skelCached = ctx->programs + kGl2ProgramSkelLitCached;
+    GlProg_InitWithPaths(skelCached, vertPath, fragPath);
+    
+    GlProg_BindAttrib(skelCached, kGlAttribVertex, "a_vertex");
+    GlProg_BindAttrib(skelCached, kGlAttribNormal, "a_normal");
+    GlProg_BindAttrib(skelCached, kGlAttribTangent, "a_tangent");
+    GlProg_BindAttrib(skelCached, kGlAttribUv0, "a_uv0");
+    
+    GlProg_Link(skelCached, 1);
+    
+    GlProg_MapUniformLoc(skelCached, "u_model", kProgLocModel);
+    GlProg_MapUniformLoc(skelCached, "u_view", kProgLocView);
+    GlProg_MapUniformLoc(skelCached, "u_projection", kProgLocProjection);
+    
+    GlProg_MapUniformLoc(skelCached, "u_albedo", kProgLocAlbedo);
+    GlProg_MapUniformLoc(skelCached, "u_normal", kProgLocNormal);
+    GlProg_MapUniformLoc(skelCached, "u_specular", kProgLocSpecular);
+    GlProg_MapUniformLoc(skelCached, "u_gloss", kProgLocGloss);
+    GlProg_MapUniformLoc(skelCached, "u_envMap", kProgLocEnvMap);
+    
+    GlProg_MapUniformLoc(skelCached, "u_camPosition", kProgLocCamPosition);
+    GlProg_MapUniformLoc(skelCached, "u_lightPositions[0]", kProgLocLightPositions);
+    
+    // Skeleton solid shader, pre-skinned
+    // ------------------------------------
+    Filepath_Append(vertPath, Filepath_DataPath(), "shaders/skel_solid_cached.vs");
+    Filepath_Append(fragPath, Filepath_DataPath(), "shaders/skel_solid.fs");
+    
+    GlProg* skelSolidCached = ctx->programs + kGl2ProgramSkelSolidCached;
+    GlProg_InitWithPaths(skelSolidCached, vertPath, fragPath);
+    
+    GlProg_BindAttrib(skelSolidCached, kGlAttribVertex, "a_vertex");
+    
+    GlProg_Link(skelSolidCached, 1);
+    
+    GlProg_MapUniformLoc(skelSolidCached, "u_models[0]", kProgLocModel);
+    GlProg_MapUniformLoc(skelSolidCached, "u_view", kProgLocView);
+    GlProg_MapUniformLoc(skelSolidCached, "u_projection", kProgLocProjection);
+    GlProg_MapUniformLoc(skelSolidCached, "u_colors[0]", kProgLocColor);
 
     // GUI shader
     // ------------------------------------
@@ -703,6 +1242,17 @@ static void Gl_Shutdown(Renderer* gl)
     {
         GlProg_Shutdown(ctx->programs + i);
     }
+    
+    GlStream_Shutdown(&ctx->instances);
+    
+    glDeleteTextures(1, &ctx->jointTexture);
+    GlStream_Shutdown(&ctx->joints);
+    free(ctx->jointPalette);
+    
+    glDeleteVertexArrays(1, &ctx->skinCacheVao);
+    glDeleteBuffers(1, &ctx->skinCacheVbo);
+    
+    GlFrameSync_Shutdown(&ctx->frameSync);
 }
 
 static void Gl_UpdateBuffers(Renderer* gl,
@@ -710,20 +1260,18 @@ static void Gl_UpdateBuffers(Renderer* gl,
                               const HintBuffer* hintBuffer,
                               const GuiBuffer* guiBuffer)
 {
-    /* upload hint buffer data */
-    glBindVertexArray(hintBuffer->vaoGpuId);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, hintBuffer->vboGpuId);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(unsigned short) * hintBuffer->indexCount, hintBuffer->indicies);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(HintVert) * hintBuffer->vertCount, hintBuffer->verts);
+    Gl2Context* ctx = gl->context;
+    const GlFrameSync* sync = &ctx->frameSync;
     
+    /* upload hint buffer data */
+    ctx->hintIndexOffset = GlStream_Write(&ctx->hintIndicies, sync, hintBuffer->indicies, sizeof(unsigned short) * hintBuffer->indexCount);
+    size_t offset = GlStream_Write(&ctx->hintVerts, sync, hintBuffer->verts, sizeof(HintVert) * hintBuffer->vertCount);
+    ctx->hintBaseVertex = (GLint)(offset / sizeof(HintVert));
     
-    glBindVertexArray(guiBuffer->vaoGpuId);
-
     // upload gui buffer data
-    glBindBuffer(GL_ARRAY_BUFFER, guiBuffer->vboGpuId);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(unsigned short) * guiBuffer->indexCount, guiBuffer->indicies);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GuiVert) * guiBuffer->vertCount, guiBuffer->verts);
+    ctx->guiIndexOffset = GlStream_Write(&ctx->guiIndicies, sync, guiBuffer->indicies, sizeof(unsigned short) * guiBuffer->indexCount);
+    offset = GlStream_Write(&ctx->guiVerts, sync, guiBuffer->verts, sizeof(GuiVert) * guiBuffer->vertCount);
+    ctx->guiBaseVertex = (GLint)(offset / sizeof(GuiVert));
 }
 
 static void Gl_RenderBg(Renderer* gl,
@@ -753,10 +1301,328 @@ static void Gl_RenderBg(Renderer* gl,
 }
 
 
+/* binds material maps to consecutive texture units. When skip is set the binds are only counted. */
+static int Gl_BindMaps(const Engine* engine, const int* maps, int mapCount, int skip)
+{
+    int binds = 0;
+    
+    for (int i = 0; i < mapCount; ++i)
+    {
+        if (maps[i] == -1)
+            continue;
+        
+        if (!skip)
+        {
+            glActiveTexture(GL_TEXTURE0 + i);
+            glBindTexture(GL_TEXTURE_2D, engine->renderSystem.textures[maps[i]].gpuId);
+        }
+        
+        ++binds;
+    }
+    
+    if (!skip)
+        glActiveTexture(GL_TEXTURE0);
+    
+    return binds;
+}
+
+static void Gl_UploadLights(GlProg* prog, const Engine* engine)
+{
+    Vec3 p[SCENE_LIGHTS_PER_VIEW];
+    
+    for (int j = 0; j < SCENE_LIGHTS_PER_VIEW; ++j)
+        p[j] = engine->sceneSystem.activeLights[j]->position;
+    
+    glUniform3fv(GlProg_UniformLoc(prog, kProgLocLightPositions), SCENE_LIGHTS_PER_VIEW, &p[0].x);
+}
+
+/* the program is setup on first use each frame, after that it is only bound */
+static GlProg* Gl_UseProgram(Renderer* gl,
+                             int program,
+                             const Frustum* cam,
+                             const Engine* engine,
+                             unsigned int* preparedMask)
+{
+    Gl2Context* ctx = gl->context;
+    
+    GlProg* prog = ctx->programs + program;
+    glUseProgram(prog->programId);
+    
+    if (*preparedMask & (1 << program))
+        return prog;
+    
+    *preparedMask |= (1 << program);
+    
+    glUniformMatrix4fv(GlProg_UniformLoc(prog, kProgLocProjection), 1, GL_FALSE, Frustum_ProjMatrix(cam)->m);
+    glUniformMatrix4fv(GlProg_UniformLoc(prog, kProgLocView), 1, GL_FALSE, Frustum_ViewMatrix(cam)->m);
+    glUniform3f(GlProg_UniformLoc(prog, kProgLocCamPosition), cam->position.x, cam->position.y, cam->position.z);
+    
+    /* lights are fixed for the view, so once per frame is enough */
+    Gl_UploadLights(prog, engine);
+    
+    if (program == kGl2ProgramSkelLit || program == kGl2ProgramSkelLitCached)
+    {
+        glUniform1i(GlProg_UniformLoc(prog, kProgLocAlbedo), 0);
+        glUniform1i(GlProg_UniformLoc(prog, kProgLocNormal), 1);
+        glUniform1i(GlProg_UniformLoc(prog, kProgLocSpecular), 2);
+        glUniform1i(GlProg_UniformLoc(prog, kProgLocGloss), 3);
+        glUniform1i(GlProg_UniformLoc(prog, kProgLocEnvMap), 4);
+        glUniform1i(GlProg_UniformLoc(prog, kProgLocJoints), GL_JOINT_PALETTE_UNIT);
+        
+        glActiveTexture(GL_TEXTURE4);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, engine->renderSystem.textures[TEX_VIEW_CUBE].gpuId);
+        glActiveTexture(GL_TEXTURE0);
+    }
+    else
+    {
+        glUniform1i(GlProg_UniformLoc(prog, kProgLocAlbedo), 0);
+        glUniform1i(GlProg_UniformLoc(prog, kProgLocSpecular), 1);
+    }
+    
+    return prog;
+}
+
+/* writes the world matrices of static items so batches can be drawn instanced.
+ Matrices are stored at the item's queue index. */
+static void Gl_UploadInstances(Renderer* gl, const Engine* engine, const RenderQueue* renderQueue)
+{
+    Gl2Context* ctx = gl->context;
+    
+    int first = -1;
+    
+    for (int i = 0; i < renderQueue->count; ++i)
+    {
+        const RenderItem* item = renderQueue->items + i;
+        
+        if (RenderKey_Program(item->key) != kRenderProgramStaticLit)
+            continue;
+        
+        if (first == -1)
+            first = i;
+        
+        ctx->instanceMatrices[i] = engine->sceneSystem.actorMatrices[item->actor];
+    }
+    
+    if (first == -1)
+        return;
+    
+    ctx->instanceFirst = first;
+    ctx->instanceOffset = GlStream_Write(&ctx->instances, &ctx->frameSync, ctx->instanceMatrices + first, sizeof(Mat4) * (renderQueue->count - first));
+}
+
+/* counts consecutive static items which can be drawn in one instanced call */
+static int Gl_InstanceRun(const Engine* engine, const RenderQueue* renderQueue, int start)
+{
+    const RenderItem* first = renderQueue->items + start;
+    const StaticMesh* mesh = &engine->sceneSystem.actorStaticModels[first->actor].mesh;
+    
+    int end = start + 1;
+    
+    while (end < renderQueue->count)
+    {
+        const RenderItem* item = renderQueue->items + end;
+        
+        if (RenderKey_Program(item->key) != kRenderProgramStaticLit ||
+            RenderKey_Material(item->key) != RenderKey_Material(first->key) ||
+            engine->sceneSystem.actorStaticModels[item->actor].mesh.vaoGpuId != mesh->vaoGpuId)
+        {
+            break;
+        }
+        
+        ++end;
+    }
+    
+    return end - start;
+}
+
+/* packs the posed joints of every skeleton in the queue into one buffer,
+ so they are uploaded once per frame and shared by the shadow and lit passes.
+ Skeletons past the buffer texture's capacity, or all of them if the palette can't grow,
+ are left with a jointBase of -1 and not drawn */
+static void Gl_UploadJoints(Renderer* gl, const Engine* engine, const RenderQueue* renderQueue)
+{
+    Gl2Context* ctx = gl->context;
+    
+    int jointMax = gl->limits.maxSkelJoints;
+    int jointCount = 0;
+    
+    for (int i = 0; i < renderQueue->count; ++i)
+    {
+        const RenderItem* item = renderQueue->items + i;
+        
+        if (RenderKey_Program(item->key) != kRenderProgramSkelLit)
+            continue;
+        
+        ctx->jointBases[i] = -1;
+        
+        int count = engine->sceneSystem.actorSkelModels[item->actor].skel.jointCount;
+        
+        if (jointCount + count <= jointMax)
+            jointCount += count;
+    }
+    
+    if (jointCount == 0)
+        return;
+    
+    if (jointCount > ctx->jointPaletteCapacity)
+    {
+        Vec4* palette = realloc(ctx->jointPalette, sizeof(Vec4) * 2 * jointCount);
+        if (!palette)
+            return;
+        
+        ctx->jointPalette = palette;
+        ctx->jointPaletteCapacity = jointCount;
+    }
+    
+    /* the same skeletons fit as when counting */
+    jointCount = 0;
+    
+    for (int i = 0; i < renderQueue->count; ++i)
+    {
+        const RenderItem* item = renderQueue->items + i;
+        
+        if (RenderKey_Program(item->key) != kRenderProgramSkelLit)
+            continue;
+        
+        const Skel* skel = &engine->sceneSystem.actorSkelModels[item->actor].skel;
+        
+        if (jointCount + skel->jointCount > jointMax)
+            continue;
+        
+        ctx->jointBases[i] = jointCount;
+        jointCount += skel->jointCount;
+        
+        Vec4* dest = ctx->jointPalette + ctx->jointBases[i] * 2;
+        
+        for (int j = 0; j < skel->jointCount; ++j)
+        {
+            Quat r = skel->renderJointRotations[j];
+            Vec3 o = skel->renderJointOrigins[j];
+            
+            dest[j * 2] = Vec4_Create(r.x, r.y, r.z, r.w);
+            dest[j * 2 + 1] = Vec4_Create(o.x, o.y, o.z, 0.0f);
+        }
+    }
+    
+    GlStream_Reserve(&ctx->joints, sizeof(Vec4) * 2 * ctx->jointPaletteCapacity);
+    size_t offset = GlStream_Write(&ctx->joints, &ctx->frameSync, ctx->jointPalette, sizeof(Vec4) * 2 * jointCount);
+    
+    /* the texture starts at the first region, so bases count from there */
+    int frameBase = (int)(offset / (sizeof(Vec4) * 2));
+    
+    for (int i = 0; i < renderQueue->count; ++i)
+    {
+        if (RenderKey_Program(renderQueue->items[i].key) == kRenderProgramSkelLit && ctx->jointBases[i] >= 0)
+            ctx->jointBases[i] += frameBase;
+    }
+    
+    glActiveTexture(GL_TEXTURE0 + GL_JOINT_PALETTE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, ctx->jointTexture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+/* skins every skeleton in the queue once into the skin cache.
+ Shadow and lit passes then draw the cached verts instead of skinning again. */
+static void Gl_SkinActors(Renderer* gl, const Engine* engine, const RenderQueue* renderQueue)
+{
+    Gl2Context* ctx = gl->context;
+    
+    int vertCount = 0;
+    
+    for (int i = 0; i < renderQueue->count; ++i)
+    {
+        const RenderItem* item = renderQueue->items + i;
+        
+        if (RenderKey_Program(item->key) != kRenderProgramSkelLit || ctx->jointBases[i] < 0)
+            continue;
+        
+        ctx->skinBases[i] = vertCount;
+        vertCount += engine->sceneSystem.actorSkelModels[item->actor].skin.vertCount;
+    }
+    
+    if (vertCount == 0)
+        return;
+    
+    glBindBuffer(GL_ARRAY_BUFFER, ctx->skinCacheVbo);
+    
+    if (vertCount > ctx->skinCacheCapacity)
+    {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(GlSkinnedVert) * vertCount, NULL, GL_STREAM_COPY);
+        ctx->skinCacheCapacity = vertCount;
+    }
+    
+    GlProg* skinProg = ctx->programs + kGl2ProgramSkelSkin;
+    glUseProgram(skinProg->programId);
+    glUniform1i(GlProg_UniformLoc(skinProg, kProgLocJoints), GL_JOINT_PALETTE_UNIT);
+    
+    glEnable(GL_RASTERIZER_DISCARD);
+    
+    for (int i = 0; i < renderQueue->count; ++i)
+    {
+        const RenderItem* item = renderQueue->items + i;
+        
+        if (RenderKey_Program(item->key) != kRenderProgramSkelLit || ctx->jointBases[i] < 0)
+            continue;
+        
+        const SkelSkin* skin = &engine->sceneSystem.actorSkelModels[item->actor].skin;
+        
+        glBindVertexArray(skin->vaoGpuId);
+        glUniform1i(GlProg_UniformLoc(skinProg, kProgLocJointBase), ctx->jointBases[i]);
+        
+        if (gl->packVerts)
+            glUniform1f(GlProg_UniformLoc(skinProg, kProgLocPackScale), skin->packScale);
+        
+        glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER,
+                          0,
+                          ctx->skinCacheVbo,
+                          sizeof(GlSkinnedVert) * ctx->skinBases[i],
+                          sizeof(GlSkinnedVert) * skin->vertCount);
+        
+        /* unique verts only, the draws index into them */
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, skin->vertCount);
+        glEndTransformFeedback();
+        
+        gl->stats.skinnedVerts += skin->vertCount;
+    }
+    
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+}
+
+/* points the skin cache VAO at a skin's range of the cache, uvs still come from the skin */
+static void Gl_BindSkinCache(Renderer* gl, const SkelSkin* skin, int base)
+{
+    Gl2Context* ctx = gl->context;
+    
+    glBindVertexArray(ctx->skinCacheVao);
+    
+    glBindBuffer(GL_ARRAY_BUFFER, ctx->skinCacheVbo);
+    
+    size_t offset = sizeof(GlSkinnedVert) * base;
+    glVertexAttribPointer(kGlAttribVertex, 3, GL_FLOAT, GL_FALSE, sizeof(GlSkinnedVert), VBO_OFFSET(offset));
+    offset += sizeof(Vec3);
+    
+    glVertexAttribPointer(kGlAttribNormal, 3, GL_FLOAT, GL_FALSE, sizeof(GlSkinnedVert), VBO_OFFSET(offset));
+    offset += sizeof(Vec3);
+    
+    glVertexAttribPointer(kGlAttribTangent, 3, GL_FLOAT, GL_FALSE, sizeof(GlSkinnedVert), VBO_OFFSET(offset));
+    
+    glBindBuffer(GL_ARRAY_BUFFER, skin->vboGpuId);
+    
+    if (gl->packVerts)
+        glVertexAttribPointer(kGlAttribUv0, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(SkelSkinPackedVert), VBO_OFFSET(offsetof(SkelSkinPackedVert, uv)));
+    else
+        glVertexAttribPointer(kGlAttribUv0, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(SkelSkinVert), VBO_OFFSET(offsetof(SkelSkinVert, uv)));
+    
+    /* indices are relative to the skin, so they work against the re-pointed range */
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, skin->eboGpuId);
+}
+
 static void Gl_RenderActors(Renderer* gl,
                             const Frustum* cam,
                             const Engine* engine,
-                            const RenderList* renderList)
+                            const RenderQueue* renderQueue)
 {
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
@@ -770,45 +1636,92 @@ static void Gl_RenderActors(Renderer* gl,
     
     Gl2Context* ctx = gl->context;
     
-    GlProg* shadowProg = ctx->programs + kGl2ProgramSkelSolid;
+    Gl_UploadJoints(gl, engine, renderQueue);
+    
+    /* read once so the whole frame uses one path */
+    int skinCached = gl->cacheSkinning;
+    
+    if (skinCached)
+        Gl_SkinActors(gl, engine, renderQueue);
+    
+    GlProg* shadowProg = ctx->programs + (skinCached ? kGl2ProgramSkelSolidCached : kGl2ProgramSkelSolid);
     glUseProgram(shadowProg->programId);
     glUniformMatrix4fv(GlProg_UniformLoc(shadowProg, kProgLocProjection), 1, GL_FALSE, Frustum_ProjMatrix(cam)->m);
     glUniformMatrix4fv(GlProg_UniformLoc(shadowProg, kProgLocView), 1, GL_FALSE, Frustum_ViewMatrix(cam)->m);
+    
+    /* each light's shadow is an instance of the same draw, so the brightness is fixed for the frame */
+    Vec4 shadowColors[SCENE_LIGHTS_PER_VIEW] = {
+        {0.0f, 0.0f, 0.0f, 0.24f},
+        {0.0f, 0.0f, 0.0f, 0.1f}
+    };
+    
+    glUniform4fv(GlProg_UniformLoc(shadowProg, kProgLocColor), SCENE_LIGHTS_PER_VIEW, &shadowColors[0].x);
+    glUniform1i(GlProg_UniformLoc(shadowProg, kProgLocJoints), GL_JOINT_PALETTE_UNIT);
+    
+    unsigned int boundVao = 0;
 
-    for (int i = 0; i < renderList->skelActorCount; ++i)
+    for (int i = 0; i < renderQueue->count; ++i)
     {
-        const Actor* actor = engine->sceneSystem.actors + renderList->skelActors[i];
-        const SkelModel* model = &actor->skelModel;
+        const RenderItem* item = renderQueue->items + i;
+        
+        if (RenderKey_Program(item->key) != kRenderProgramSkelLit || ctx->jointBases[i] < 0)
+            continue;
+        
+        const Actor* actor = engine->sceneSystem.actors + item->actor;
+        const SkelModel* model = actor->skelModel;
+        
+        if (skinCached)
+        {
+            Gl_BindSkinCache(gl, &model->skin, ctx->skinBases[i]);
+        }
+        else
+        {
+            if (model->skin.vaoGpuId != boundVao)
+            {
+                glBindVertexArray(model->skin.vaoGpuId);
+                boundVao = model->skin.vaoGpuId;
+            }
+            else
+            {
+                ++gl->stats.bindsAvoided;
+            }
+            
+            glUniform1i(GlProg_UniformLoc(shadowProg, kProgLocJointBase), ctx->jointBases[i]);
+            
+            if (gl->packVerts)
+                glUniform1f(GlProg_UniformLoc(shadowProg, kProgLocPackScale), model->skin.packScale);
+        }
         
-        glBindVertexArray(model->skin.vaoGpuId);
+        Vec3 shadowNormal = Vec3_Create(0.0f, 0.0f, 1.0f);
         
-        glUniform4fv(GlProg_UniformLoc(shadowProg, kProgLocJointRotations), model->skel.jointCount, (float*)model->skel.renderJointRotations);
-        glUniform3fv(GlProg_UniformLoc(shadowProg, kProgLocJointOrigins), model->skel.jointCount, (float*)model->skel.renderJointOrigins);
+        if (actor->pathPoly != NULL)
+            shadowNormal = actor->pathPoly->plane.normal;
         
+        Plane shadowPlane = Plane_Create(Vec3_Offset(*actor->position, 0.0f, 0.0f, -0.05f), shadowNormal);
         
-        float brightness[SCENE_LIGHTS_PER_VIEW] = { 0.24f, 0.1f};
+        Mat4 objects[SCENE_LIGHTS_PER_VIEW];
 
         for (int j = 0; j < SCENE_LIGHTS_PER_VIEW; ++j)
         {
             const SceneLight* light = engine->sceneSystem.activeLights[j];
             
-            Vec3 shadowNormal = Vec3_Create(0.0f, 0.0f, 1.0f);
-            
-            if (actor->pathPoly != NULL)
-                shadowNormal = actor->pathPoly->plane.normal;
-            
-            Plane shadowPlane = Plane_Create(Vec3_Offset(actor->position, 0.0f, 0.0f, -0.05f), shadowNormal);
-            
-            Mat4 object;
             Mat4 shadowTransform = Mat4_CreateShadow(shadowPlane, light->position);
-            Mat4_Mult(&actor->worldMatrix, &shadowTransform, &object);
-            
-            glUniformMatrix4fv(GlProg_UniformLoc(shadowProg, kProgLocModel), 1, GL_FALSE, object.m);
-            glUniform4f(GlProg_UniformLoc(shadowProg, kProgLocColor), 0.0f, 0.0f, 0.0f, brightness[j]);
-
-            glDrawArrays(GL_TRIANGLES, 0, model->skin.vertCount);
-
+            Mat4_Mult(actor->worldMatrix, &shadowTransform, objects + j);
         }
+        
+        glUniformMatrix4fv(GlProg_UniformLoc(shadowProg, kProgLocModel), SCENE_LIGHTS_PER_VIEW, GL_FALSE, objects[0].m);
+        
+        /* instances are rasterized in order, so the stencil still lets the first light's shadow win */
+        if (model->skin.indexCount > 0)
+        {
+            GLenum indexType = (SkelSkin_IndexSize(&model->skin) == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            glDrawElementsInstanced(GL_TRIANGLES, model->skin.indexCount, indexType, NULL, SCENE_LIGHTS_PER_VIEW);
+        }
+        else
+        {
+            glDrawArraysInstanced(GL_TRIANGLES, 0, model->skin.vertCount, SCENE_LIGHTS_PER_VIEW);
+        }
+        ++gl->stats.drawCalls;
     }
 
     glDisable(GL_STENCIL_TEST);
@@ -817,116 +1730,178 @@ static void Gl_RenderActors(Renderer* gl,
     glEnable(GL_CULL_FACE);
     glDepthMask(GL_TRUE);
     
-    GlProg* skelProg = ctx->programs + kGl2ProgramSkelLit;
-    glUseProgram(skelProg->programId);
+    Gl_UploadInstances(gl, engine, renderQueue);
     
-    glUniformMatrix4fv(GlProg_UniformLoc(skelProg, kProgLocProjection), 1, GL_FALSE, Frustum_ProjMatrix(cam)->m);
-    glUniformMatrix4fv(GlProg_UniformLoc(skelProg, kProgLocView), 1, GL_FALSE, Frustum_ViewMatrix(cam)->m);
-    glUniform1i(GlProg_UniformLoc(skelProg, kProgLocAlbedo), 0);
-    glUniform1i(GlProg_UniformLoc(skelProg, kProgLocNormal), 1);
-    glUniform1i(GlProg_UniformLoc(skelProg, kProgLocSpecular), 2);
-    glUniform1i(GlProg_UniformLoc(skelProg, kProgLocGloss), 3);
-    glUniform1i(GlProg_UniformLoc(skelProg, kProgLocEnvMap), 4);
+    /* the queue is sorted by program, then material, then mesh.
+     State is only changed when the corresponding part of the key changes. */
+    GlProg* prog = NULL;
+    int boundProgram = -1;
+    int boundKeyProgram = -1;
+    unsigned int preparedMask = 0;
+    RenderKey boundMaterial = 0;
     
-    glActiveTexture(GL_TEXTURE4);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, engine->renderSystem.textures[TEX_VIEW_CUBE].gpuId);
-
-    glActiveTexture(GL_TEXTURE0);
-
-    glUniform3f(GlProg_UniformLoc(skelProg, kProgLocCamPosition), cam->position.x, cam->position.y, cam->position.z);
-
-    for (int i = 0; i < renderList->skelActorCount; ++i)
+    int next;
+    for (int i = 0; i < renderQueue->count; i = next)
     {
-        const Actor* actor = engine->sceneSystem.actors + renderList->skelActors[i];
-        const SkelModel* model = &actor->skelModel;
-        
-        Vec3 p[SCENE_LIGHTS_PER_VIEW];
-        
-        for (int j = 0; j < SCENE_LIGHTS_PER_VIEW; ++j)
-            p[j] = engine->sceneSystem.activeLights[j]->position;
+        const RenderItem* item = renderQueue->items + i;
+        const Actor* actor = engine->sceneSystem.actors + item->actor;
         
-        glUniform3fv(GlProg_UniformLoc(skelProg, kProgLocLightPositions), SCENE_LIGHTS_PER_VIEW, &p[0].x);
+        int keyProgram = RenderKey_Program(item->key);
+        int instanceCount = 1;
+        int program;
         
-        if (model->material.albedoMap != -1)
+        if (keyProgram == kRenderProgramSkelLit)
         {
-            glBindTexture(GL_TEXTURE_2D, engine->renderSystem.textures[model->material.albedoMap].gpuId);
+            if (ctx->jointBases[i] < 0)
+            {
+                next = i + 1;
+                continue;
+            }
+            
+            program = skinCached ? kGl2ProgramSkelLitCached : kGl2ProgramSkelLit;
         }
-        
-        if (model->material.normalMap != -1)
+        else
         {
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, engine->renderSystem.textures[model->material.normalMap].gpuId);
+            /* actors sharing a mesh and material are adjacent after sorting */
+            instanceCount = Gl_InstanceRun(engine, renderQueue, i);
+            program = (instanceCount > 1) ? kGl2ProgramStaticLitInstanced : kGl2ProgramStaticLit;
         }
         
-        if (model->material.specularMap != -1)
+        next = i + instanceCount;
+        
+        if (program != boundProgram)
         {
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, engine->renderSystem.textures[model->material.specularMap].gpuId);
+            prog = Gl_UseProgram(gl, program, cam, engine, &preparedMask);
+            boundProgram = program;
         }
         
+        int materialChanged = (RenderKey_Material(item->key) != boundMaterial);
         
-        if (model->material.glossMap != -1)
+        if (keyProgram != boundKeyProgram)
         {
-            glActiveTexture(GL_TEXTURE3);
-            glBindTexture(GL_TEXTURE_2D, engine->renderSystem.textures[model->material.glossMap].gpuId);
+            /* texture units have different meanings in each program */
+            boundKeyProgram = keyProgram;
+            materialChanged = 1;
+            boundVao = 0;
         }
         
+        boundMaterial = RenderKey_Material(item->key);
         
-        glBindVertexArray(model->skin.vaoGpuId);
-        
-        glUniform4fv(GlProg_UniformLoc(skelProg, kProgLocJointRotations), model->skel.jointCount, (float*)model->skel.renderJointRotations);
-        glUniform3fv(GlProg_UniformLoc(skelProg, kProgLocJointOrigins), model->skel.jointCount, (float*)model->skel.renderJointOrigins);
-
-        glUniformMatrix4fv(GlProg_UniformLoc(skelProg, kProgLocModel), 1, GL_FALSE, actor->worldMatrix.m);
-
-        glDrawArrays(GL_TRIANGLES, 0, model->skin.vertCount);
-        
-        glActiveTexture(GL_TEXTURE0);
-    }
-    
-    GlProg* staticProg = ctx->programs + kGl2ProgramStaticLit;
-    
-    glUseProgram(staticProg->programId);
-    glUniformMatrix4fv(GlProg_UniformLoc(staticProg, kProgLocProjection), 1, GL_FALSE, Frustum_ProjMatrix(cam)->m);
-    glUniformMatrix4fv(GlProg_UniformLoc(staticProg, kProgLocView), 1, GL_FALSE, Frustum_ViewMatrix(cam)->m);
-    glUniform1i(GlProg_UniformLoc(staticProg, kProgLocAlbedo), 0);
-    glUniform1i(GlProg_UniformLoc(staticProg, kProgLocSpecular), 1);
-    
-    glUniform3f(GlProg_UniformLoc(staticProg, kProgLocCamPosition), cam->position.x, cam->position.y, cam->position.z);
-    
-    for (int i = 0; i < renderList->staticActorCount; ++i)
-    {
-        const Actor* actor = engine->sceneSystem.actors + renderList->staticActors[i];
-        
-        Vec3 p[SCENE_LIGHTS_PER_VIEW];
+        unsigned int vao = 0;
         
-        for (int j = 0; j < SCENE_LIGHTS_PER_VIEW; ++j)
-            p[j] = engine->sceneSystem.activeLights[j]->position;
-
-        glUniform3fv(GlProg_UniformLoc(skelProg, kProgLocLightPositions), SCENE_LIGHTS_PER_VIEW, &p[0].x);
-
-        const StaticModel* model = &actor->staticModel;
+        /* verts, or indices when indexType is set */
+        unsigned int vertCount;
+        GLenum indexType = 0;
         
-        if (model->material.albedoMap != -1)
+        if (keyProgram == kRenderProgramSkelLit)
         {
-            glBindTexture(GL_TEXTURE_2D, engine->renderSystem.textures[model->material.albedoMap].gpuId);
+            const SkelModel* model = actor->skelModel;
+            
+            int maps[] = {
+                model->material.albedoMap,
+                model->material.normalMap,
+                model->material.specularMap,
+                model->material.glossMap
+            };
+            
+            int binds = Gl_BindMaps(engine, maps, 4, !materialChanged);
+            if (!materialChanged)
+                gl->stats.bindsAvoided += binds;
+            
+            if (skinCached)
+            {
+                /* re-pointed every draw, so it is never the bound VAO */
+                Gl_BindSkinCache(gl, &model->skin, ctx->skinBases[i]);
+                boundVao = 0;
+            }
+            else
+            {
+                glUniform1i(GlProg_UniformLoc(prog, kProgLocJointBase), ctx->jointBases[i]);
+                vao = model->skin.vaoGpuId;
+                
+                if (gl->packVerts)
+                    glUniform1f(GlProg_UniformLoc(prog, kProgLocPackScale), model->skin.packScale);
+            }
+            
+            vertCount = model->skin.vertCount;
+            
+            if (model->skin.indexCount > 0)
+            {
+                vertCount = model->skin.indexCount;
+                indexType = (SkelSkin_IndexSize(&model->skin) == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            }
         }
-
-        if (model->material.specularMap != -1)
+        else
         {
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, engine->renderSystem.textures[model->material.specularMap].gpuId);
+            const StaticModel* model = actor->staticModel;
+            
+            int maps[] = {
+                model->material.albedoMap,
+                model->material.specularMap
+            };
+            
+            int binds = Gl_BindMaps(engine, maps, 2, !materialChanged);
+            if (!materialChanged)
+                gl->stats.bindsAvoided += binds;
+            
+            vao = model->mesh.vaoGpuId;
+            vertCount = model->mesh.vertCount;
+            
+            /* instances share the mesh, so one scale covers the batch */
+            if (gl->packVerts)
+            {
+                glUniform3fv(GlProg_UniformLoc(prog, kProgLocPackScale), 1, &model->mesh.packScale.x);
+                glUniform3fv(GlProg_UniformLoc(prog, kProgLocPackOffset), 1, &model->mesh.packOffset.x);
+            }
+            
+            if (model->mesh.indexCount > 0)
+            {
+                vertCount = model->mesh.indexCount;
+                indexType = (StaticMesh_IndexSize(&model->mesh) == 2) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            }
         }
         
-        glBindVertexArray(model->mesh.vaoGpuId);
+        if (vao == 0)
+        {
+            /* skin cache, already bound */
+        }
+        else if (vao != boundVao)
+        {
+            glBindVertexArray(vao);
+            boundVao = vao;
+        }
+        else
+        {
+            ++gl->stats.bindsAvoided;
+        }
         
-        glUniformMatrix4fv(GlProg_UniformLoc(staticProg, kProgLocModel), 1, GL_FALSE, actor->worldMatrix.m);
-
-        glDrawArrays(GL_TRIANGLES, 0, model->mesh.vertCount);
+        if (instanceCount > 1)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, ctx->instances.buffer);
+            
+            for (int j = 0; j < 4; ++j)
+            {
+                size_t offset = ctx->instanceOffset + sizeof(Mat4) * (i - ctx->instanceFirst) + sizeof(Vec4) * j;
+                glVertexAttribPointer(kGlAttribInstanceModel + j, 4, GL_FLOAT, GL_FALSE, sizeof(Mat4), VBO_OFFSET(offset));
+            }
+            
+            if (indexType)
+                glDrawElementsInstanced(GL_TRIANGLES, vertCount, indexType, NULL, instanceCount);
+            else
+                glDrawArraysInstanced(GL_TRIANGLES, 0, vertCount, instanceCount);
+        }
+        else
+        {
+            glUniformMatrix4fv(GlProg_UniformLoc(prog, kProgLocModel), 1, GL_FALSE, actor->worldMatrix->m);
+            
+            if (indexType)
+                glDrawElements(GL_TRIANGLES, vertCount, indexType, NULL);
+            else
+                glDrawArrays(GL_TRIANGLES, 0, vertCount);
+        }
         
-        glActiveTexture(GL_TEXTURE0);
+        ++gl->stats.drawCalls;
     }
-
 }
 
 static void Gl_RenderHints(Renderer* gl,
@@ -948,27 +1923,34 @@ static void Gl_RenderHints(Renderer* gl,
     glUniformMatrix4fv(GlProg_UniformLoc(hintProg, kProgLocProjection), 1, GL_FALSE, Frustum_ProjMatrix(cam)->m);
 
     glBindVertexArray(buffer->vaoGpuId);
-    glDrawElements(GL_LINES, buffer->indexCount, GL_UNSIGNED_SHORT, NULL);
+    glDrawElementsBaseVertex(GL_LINES, buffer->indexCount, GL_UNSIGNED_SHORT, VBO_OFFSET(ctx->hintIndexOffset), ctx->hintBaseVertex);
 }
 
 
 static void Gl_Render(Renderer* gl,
                        const Frustum* cam,
                        const Engine* engine,
-                       const RenderList* renderList)
+                       const RenderQueue* renderQueue)
 {
+    gl->stats.drawCalls = 0;
+    gl->stats.bindsAvoided = 0;
+    gl->stats.skinnedVerts = 0;
+
     glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
     glScissor(0, 0, engine->renderSystem.viewportWidth * engine->renderSystem.scaleFactor, engine->renderSystem.viewportHeight * engine->renderSystem.scaleFactor);
 
-    Gl_UpdateBuffers(gl, engine, &engine->renderSystem.hintBuffer, &engine->guiSystem.buffer);
+    Gl2Context* ctx = gl->context;
+    GlFrameSync_Begin(&ctx->frameSync);
 
     /* "When you need to modify OpenGL ES resources, schedule those modifications at the beginning or end of a frame." */
     /* profiling shows UpdateBuffers is more effecient at the beginning than the end */
     Gl_UpdateBuffers(gl, engine, &engine->renderSystem.hintBuffer, &engine->guiSystem.buffer);
     
     Gl_RenderBg(gl, cam, engine, &engine->renderSystem.bgBuffer);
-    Gl_RenderActors(gl, cam, engine, renderList);
+    Gl_RenderActors(gl, cam, engine, renderQueue);
     //Gl_RenderHints(gl, cam, engine, &engine->renderSystem.hintBuffer);
+    
+    GlFrameSync_End(&ctx->frameSync);
 }
 
 static void Gl_FlushLoad(Renderer* gl)
@@ -996,6 +1978,13 @@ int Gl2_Init(Renderer* gl)
     
     gl->context = malloc(sizeof(Gl2Context));
     
+    gl->stats.drawCalls = 0;
+    gl->stats.bindsAvoided = 0;
+    gl->stats.skinnedVerts = 0;
+    
+    gl->cacheSkinning = 0;
+    gl->packVerts = 0;
+    
     gl->flushLoad = Gl_FlushLoad;
     return 1;
 }
@@ -15,6 +15,8 @@ static const char g_vertShaderPrefix[] = "\
 #version 330\n \
 ";
 
+static const char* g_defines = "";
+
 
 static inline int GLUniformCompare(const void* a, const void* b)
 {
@@ -24,6 +26,11 @@ static inline int GLUniformCompare(const void* a, const void* b)
 }
 
 
+void GlProg_SetDefines(const char* defines)
+{
+    g_defines = defines ? defines : "";
+}
+
 int GlProg_Init(GlProg* program)
 {
     if (!program)
@@ -35,7 +42,13 @@ int GlProg_Init(GlProg* program)
     
     for (int i = 0; i < PROG_UNIFORMS_MAX; ++i)
     {
-        program->locTable[0] = -1;
+        program->locTable[i] = -1;
+    }
+    
+    /* vertex only programs (transform feedback) never attach a fragment shader */
+    for (int i = 0; i < kGlShaderTypeCount; ++i)
+    {
+        program->attachedFlag[i] = 0;
     }
     
     return 1;
@@ -147,13 +160,13 @@ int GlProg_Compile(GlProg* program,
     
     if (type == kGlShaderTypeFragment)
     {
-        const char* sources[] = {g_fragShaderPrefix, source};
-        glShaderSource(shader->shaderID, 2, sources, NULL);
+        const char* sources[] = {g_fragShaderPrefix, g_defines, source};
+        glShaderSource(shader->shaderID, 3, sources, NULL);
     }
     else
     {
-        const char* sources[] = {g_vertShaderPrefix, source};
-        glShaderSource(shader->shaderID, 2, sources, NULL);
+        const char* sources[] = {g_vertShaderPrefix, g_defines, source};
+        glShaderSource(shader->shaderID, 3, sources, NULL);
     }
     
     glCompileShader(shader->shaderID);
@@ -27,7 +27,12 @@ typedef enum
     /* GUI */
     kGlAttribAtlasId,
     kGlAttribColor,
-
+    
+    /* Instancing. A mat4 occupies 4 consecutive locations. */
+    kGlAttribInstanceModel,
+    
+    /* packed skel influences. Skins have one uv channel, and 16 locations are all spoken for */
+    kGlAttribWeightInfluences = kGlAttribUv1,
     
 } GlAttrib;
 
@@ -85,6 +90,9 @@ typedef struct
     
 } GlProg;
 
+/* source inserted after the version line of every shader compiled afterwards, for #defines */
+extern void GlProg_SetDefines(const char* defines);
+
 extern int GlProg_Init(GlProg* program);
 extern int GlProg_InitWithPaths(GlProg* program,
                                 const char* vertexPath,
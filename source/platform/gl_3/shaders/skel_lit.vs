@@ -1,20 +1,35 @@
-#define MAX_JOINTS 48
 #define MAX_WEIGHTS 3
 
 uniform mat4 u_model;
 uniform mat4 u_view;
 uniform mat4 u_projection;
 
-uniform vec3 u_jointOrigins[MAX_JOINTS];
-uniform vec4 u_jointRotations[MAX_JOINTS];
+/* joints of every skeleton this frame, two texels each: rotation, origin */
+uniform samplerBuffer u_joints;
+uniform int u_jointBase;
 
+#ifdef PACKED_VERTS
+in vec2 a_normal;
+in vec2 a_tangent;
+#else
 in vec3 a_normal;
 in vec3 a_tangent;
+#endif
 in vec2 a_uv0;
 in vec3 a_weight_joints;
+#ifdef PACKED_VERTS
+/* SkelSkinPackedVert, offsets in snorm16 scaled by u_packScale, unorm8 influences */
+uniform float u_packScale;
+
+in vec3 a_weight0;
+in vec3 a_weight1;
+in vec3 a_weight2;
+in vec3 a_weight_influences;
+#else
 in vec4 a_weight0;
 in vec4 a_weight1;
 in vec4 a_weight2;
+#endif
 
 out vec2 v_uvs[1];
 out vec3 v_fragPosition;
@@ -26,6 +41,28 @@ vec3 quatRotate(const vec4 quat, const vec3 vec)
     return vec + t * quat.w + cross(quat.xyz, t);
 }
 
+#ifdef PACKED_VERTS
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    
+    return normalize(n);
+}
+#endif
+
+vec4 jointRotation(int joint)
+{
+    return texelFetch(u_joints, (u_jointBase + joint) * 2);
+}
+
+vec3 jointOrigin(int joint)
+{
+    return texelFetch(u_joints, (u_jointBase + joint) * 2 + 1).xyz;
+}
+
 void main()
 {
     vec3 vert = vec3(0.0, 0.0, 0.0);
@@ -33,18 +70,33 @@ void main()
     vec3 tangent = vec3(0.0, 0.0, 0.0);
 
     vec4 weights[MAX_WEIGHTS];
+#ifdef PACKED_VERTS
+    weights[0] = vec4(a_weight0 * u_packScale, a_weight_influences.x);
+    weights[1] = vec4(a_weight1 * u_packScale, a_weight_influences.y);
+    weights[2] = vec4(a_weight2 * u_packScale, a_weight_influences.z);
+#else
     weights[0] = a_weight0;
     weights[1] = a_weight1;
     weights[2] = a_weight2;
+#endif
+    
+#ifdef PACKED_VERTS
+    vec3 restNormal = octDecode(a_normal / 32767.0);
+    vec3 restTangent = octDecode(a_tangent / 32767.0);
+#else
+    vec3 restNormal = a_normal;
+    vec3 restTangent = a_tangent;
+#endif
     
     for (int i = 0; i < MAX_WEIGHTS; i++)
     {
         int joint = int(a_weight_joints[i]);
-        vec3 transformed = u_jointOrigins[joint] + quatRotate(u_jointRotations[joint], weights[i].xyz);
+        vec4 rotation = jointRotation(joint);
+        vec3 transformed = jointOrigin(joint) + quatRotate(rotation, weights[i].xyz);
         vert += transformed * weights[i].w;
-        transformed = quatRotate(u_jointRotations[joint], a_normal);
+        transformed = quatRotate(rotation, restNormal);
         normal += transformed * weights[i].w;
-        transformed = quatRotate(u_jointRotations[joint], a_tangent);
+        transformed = quatRotate(rotation, restTangent);
         tangent += transformed * weights[i].w;
     }
     
@@ -0,0 +1,22 @@
+uniform mat4 u_model;
+uniform mat4 u_view;
+uniform mat4 u_projection;
+
+/* already skinned by skel_skin.vs */
+in vec3 a_vertex;
+in vec3 a_normal;
+in vec3 a_tangent;
+in vec2 a_uv0;
+
+out vec2 v_uvs[1];
+out vec3 v_fragPosition;
+out mat3 v_tbnMatrix;
+
+void main()
+{
+    v_uvs[0] = a_uv0;
+    v_tbnMatrix = mat3(a_tangent, cross(a_tangent, a_normal), a_normal);
+    v_fragPosition = (u_model * vec4(a_vertex, 1.0)).xyz;
+    
+    gl_Position = u_projection * u_view * u_model * vec4(a_vertex, 1.0);
+}
@@ -0,0 +1,102 @@
+#define MAX_WEIGHTS 3
+
+/* joints of every skeleton this frame, two texels each: rotation, origin */
+uniform samplerBuffer u_joints;
+uniform int u_jointBase;
+
+#ifdef PACKED_VERTS
+in vec2 a_normal;
+in vec2 a_tangent;
+#else
+in vec3 a_normal;
+in vec3 a_tangent;
+#endif
+in vec3 a_weight_joints;
+#ifdef PACKED_VERTS
+/* SkelSkinPackedVert, offsets in snorm16 scaled by u_packScale, unorm8 influences */
+uniform float u_packScale;
+
+in vec3 a_weight0;
+in vec3 a_weight1;
+in vec3 a_weight2;
+in vec3 a_weight_influences;
+#else
+in vec4 a_weight0;
+in vec4 a_weight1;
+in vec4 a_weight2;
+#endif
+
+/* captured with transform feedback, in model space */
+out vec3 tf_position;
+out vec3 tf_normal;
+out vec3 tf_tangent;
+
+vec3 quatRotate(const vec4 quat, const vec3 vec)
+{
+    vec3 t = cross(quat.xyz, vec) * 2.0;
+    return vec + t * quat.w + cross(quat.xyz, t);
+}
+
+#ifdef PACKED_VERTS
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    
+    return normalize(n);
+}
+#endif
+
+vec4 jointRotation(int joint)
+{
+    return texelFetch(u_joints, (u_jointBase + joint) * 2);
+}
+
+vec3 jointOrigin(int joint)
+{
+    return texelFetch(u_joints, (u_jointBase + joint) * 2 + 1).xyz;
+}
+
+void main()
+{
+    vec3 vert = vec3(0.0, 0.0, 0.0);
+    vec3 normal = vec3(0.0, 0.0, 0.0);
+    vec3 tangent = vec3(0.0, 0.0, 0.0);
+
+    vec4 weights[MAX_WEIGHTS];
+#ifdef PACKED_VERTS
+    weights[0] = vec4(a_weight0 * u_packScale, a_weight_influences.x);
+    weights[1] = vec4(a_weight1 * u_packScale, a_weight_influences.y);
+    weights[2] = vec4(a_weight2 * u_packScale, a_weight_influences.z);
+#else
+    weights[0] = a_weight0;
+    weights[1] = a_weight1;
+    weights[2] = a_weight2;
+#endif
+    
+#ifdef PACKED_VERTS
+    vec3 restNormal = octDecode(a_normal / 32767.0);
+    vec3 restTangent = octDecode(a_tangent / 32767.0);
+#else
+    vec3 restNormal = a_normal;
+    vec3 restTangent = a_tangent;
+#endif
+    
+    for (int i = 0; i < MAX_WEIGHTS; i++)
+    {
+        int joint = int(a_weight_joints[i]);
+        vec4 rotation = jointRotation(joint);
+        vec3 transformed = jointOrigin(joint) + quatRotate(rotation, weights[i].xyz);
+        vert += transformed * weights[i].w;
+        transformed = quatRotate(rotation, restNormal);
+        normal += transformed * weights[i].w;
+        transformed = quatRotate(rotation, restTangent);
+        tangent += transformed * weights[i].w;
+    }
+    
+    tf_position = vert;
+    tf_normal = normal;
+    tf_tangent = tangent;
+}
@@ -1,10 +1,10 @@
 
-uniform vec4 u_color;
+flat in vec4 v_color;
 
 out vec4 fragColor;
 
 void main()
 {
-    fragColor = u_color;
+    fragColor = v_color;
 }
 
@@ -1,19 +1,33 @@
-#define MAX_JOINTS 48
 #define MAX_WEIGHTS 3
+#define LIGHT_COUNT 2
 
-uniform mat4 u_model;
+/* instance i is the shadow cast by light i */
+uniform mat4 u_models[LIGHT_COUNT];
+uniform vec4 u_colors[LIGHT_COUNT];
 uniform mat4 u_view;
 uniform mat4 u_projection;
 
-uniform vec3 u_jointOrigins[MAX_JOINTS];
-uniform vec4 u_jointRotations[MAX_JOINTS];
+/* joints of every skeleton this frame, two texels each: rotation, origin */
+uniform samplerBuffer u_joints;
+uniform int u_jointBase;
 
 in vec2 a_uv0;
 in vec3 a_weight_joints;
+#ifdef PACKED_VERTS
+/* SkelSkinPackedVert, offsets in snorm16 scaled by u_packScale, unorm8 influences */
+uniform float u_packScale;
+
+in vec3 a_weight0;
+in vec3 a_weight1;
+in vec3 a_weight2;
+in vec3 a_weight_influences;
+#else
 in vec4 a_weight0;
 in vec4 a_weight1;
 in vec4 a_weight2;
+#endif
 
+flat out vec4 v_color;
 
 vec3 quatRotate(const vec4 quat, const vec3 vec)
 {
@@ -21,22 +35,39 @@ vec3 quatRotate(const vec4 quat, const vec3 vec)
     return vec + t * quat.w + cross(quat.xyz, t);
 }
 
+vec4 jointRotation(int joint)
+{
+    return texelFetch(u_joints, (u_jointBase + joint) * 2);
+}
+
+vec3 jointOrigin(int joint)
+{
+    return texelFetch(u_joints, (u_jointBase + joint) * 2 + 1).xyz;
+}
+
 void main()
 {
     vec3 vert = vec3(0.0, 0.0, 0.0);
     
     vec4 weights[MAX_WEIGHTS];
+#ifdef PACKED_VERTS
+    weights[0] = vec4(a_weight0 * u_packScale, a_weight_influences.x);
+    weights[1] = vec4(a_weight1 * u_packScale, a_weight_influences.y);
+    weights[2] = vec4(a_weight2 * u_packScale, a_weight_influences.z);
+#else
     weights[0] = a_weight0;
     weights[1] = a_weight1;
     weights[2] = a_weight2;
+#endif
     
     for (int i = 0; i < MAX_WEIGHTS; i++)
     {
         int joint = int(a_weight_joints[i]);
-        vec3 transformed = u_jointOrigins[joint] + quatRotate(u_jointRotations[joint], weights[i].xyz);
+        vec4 rotation = jointRotation(joint);
+        vec3 transformed = jointOrigin(joint) + quatRotate(rotation, weights[i].xyz);
         vert += transformed * weights[i].w;
     }
     
-    
-    gl_Position = u_projection * u_view * u_model * vec4(vert, 1.0);
+    v_color = u_colors[gl_InstanceID];
+    gl_Position = u_projection * u_view * u_models[gl_InstanceID] * vec4(vert, 1.0);
 }
@@ -0,0 +1,18 @@
+#define LIGHT_COUNT 2
+
+/* instance i is the shadow cast by light i */
+uniform mat4 u_models[LIGHT_COUNT];
+uniform vec4 u_colors[LIGHT_COUNT];
+uniform mat4 u_view;
+uniform mat4 u_projection;
+
+/* already skinned by skel_skin.vs */
+in vec3 a_vertex;
+
+flat out vec4 v_color;
+
+void main()
+{
+    v_color = u_colors[gl_InstanceID];
+    gl_Position = u_projection * u_view * u_models[gl_InstanceID] * vec4(a_vertex, 1.0);
+}
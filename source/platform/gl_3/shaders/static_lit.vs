@@ -4,8 +4,27 @@ uniform mat4 u_projection;
 
 uniform vec3 u_lightPositions[2];
 
+#ifdef PACKED_VERTS
+/* StaticMeshPackedVert, position against the mesh bounds, octahedral normal */
+uniform vec3 u_packScale;
+uniform vec3 u_packOffset;
+
+in vec3 a_vertex;
+in vec2 a_normal;
+
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    
+    return normalize(n);
+}
+#else
 in vec3 a_vertex;
 in vec3 a_normal;
+#endif
 in vec2 a_uv0;
 
 out vec3 v_normal;
@@ -15,13 +34,21 @@ out vec3 v_fragPosition;
 
 void main()
 {    
+#ifdef PACKED_VERTS
+    vec3 vertex = a_vertex * u_packScale + u_packOffset;
+    vec3 normal = octDecode(a_normal / 32767.0);
+#else
+    vec3 vertex = a_vertex;
+    vec3 normal = a_normal;
+#endif
+    
     v_uv = a_uv0;
     
     v_lightPosition[0] = u_lightPositions[0];
     v_lightPosition[1] = u_lightPositions[1];
     
-    v_normal = (u_model * vec4(a_normal , 0.0)).xyz;
-    v_fragPosition = (u_model * vec4(a_vertex, 1.0)).xyz;
+    v_normal = (u_model * vec4(normal, 0.0)).xyz;
+    v_fragPosition = (u_model * vec4(vertex, 1.0)).xyz;
     
-    gl_Position = u_projection * u_view * u_model * vec4(a_vertex, 1.0);
+    gl_Position = u_projection * u_view * u_model * vec4(vertex, 1.0);
 }
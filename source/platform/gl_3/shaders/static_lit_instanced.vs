@@ -0,0 +1,54 @@
+uniform mat4 u_view;
+uniform mat4 u_projection;
+
+uniform vec3 u_lightPositions[2];
+
+#ifdef PACKED_VERTS
+/* StaticMeshPackedVert, position against the mesh bounds, octahedral normal */
+uniform vec3 u_packScale;
+uniform vec3 u_packOffset;
+
+in vec3 a_vertex;
+in vec2 a_normal;
+
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    
+    return normalize(n);
+}
+#else
+in vec3 a_vertex;
+in vec3 a_normal;
+#endif
+in vec2 a_uv0;
+in mat4 a_model;
+
+out vec3 v_normal;
+out vec2 v_uv;
+out vec3 v_lightPosition[2];
+out vec3 v_fragPosition;
+
+void main()
+{    
+#ifdef PACKED_VERTS
+    vec3 vertex = a_vertex * u_packScale + u_packOffset;
+    vec3 normal = octDecode(a_normal / 32767.0);
+#else
+    vec3 vertex = a_vertex;
+    vec3 normal = a_normal;
+#endif
+    
+    v_uv = a_uv0;
+    
+    v_lightPosition[0] = u_lightPositions[0];
+    v_lightPosition[1] = u_lightPositions[1];
+    
+    v_normal = (a_model * vec4(normal, 0.0)).xyz;
+    v_fragPosition = (a_model * vec4(vertex, 1.0)).xyz;
+    
+    gl_Position = u_projection * u_view * a_model * vec4(vertex, 1.0);
+}
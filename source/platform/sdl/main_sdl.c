@@ -1,6 +1,7 @@
 #include "SDL2/SDL.h"
 #include "gl_3.h"
 #include <stdio.h>
+#include <string.h>
 #include "utils.h"
 
 #if __APPLE__
@@ -75,6 +76,14 @@ int main(int argc, char * argv[])
     
     Renderer gl;
     Gl2_Init(&gl); 
+    
+    /* shaders are compiled for the vertex layout, so unlike cacheSkinning it can't change after init */
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-packverts") == 0)
+            gl.packVerts = 1;
+    }
+    
 #if __APPLE__
     SndDriver* driver = SndDriver_CoreAudio_Create(44100);
 #else
@@ -88,6 +97,8 @@ int main(int argc, char * argv[])
     engineSettings.renderWidth = g_windowWidth;
     engineSettings.renderHeight = g_windowHeight;
     engineSettings.renderScaleFactor = 1.0f;
+    engineSettings.viewCacheBudget = 64 * 1024 * 1024;
+    engineSettings.jobThreads = SDL_GetCPUCount();
 
     if (!Engine_Init(&g_engine, &gl, driver,engineSettings))
     {
@@ -121,6 +132,10 @@ int main(int argc, char * argv[])
                     {
                         quit = 1;
                     }
+                    else if (e.key.keysym.sym == SDLK_k)
+                    {
+                        gl.cacheSkinning = !gl.cacheSkinning;
+                    }
                 }
                 case SDL_MOUSEBUTTONDOWN:
                     if (e.button.button == SDL_BUTTON_LEFT) {inputState.mouseButtons[kMouseButtonLeft].down = 1; }
@@ -138,6 +153,13 @@ int main(int argc, char * argv[])
         SDL_GL_SwapWindow(window);
     }
     
+    if (BUILD_DEBUG)
+    {
+        const ViewCacheStats* stats = ViewCache_Stats(&g_engine.viewCache);
+        printf("view cache: %d hits (%d adopted in flight), %d misses, %d evictions\n", stats->hits, stats->waits, stats->misses, stats->evictions);
+    }
+    
+    Engine_Shutdown(&g_engine);
     SDL_GL_DeleteContext(context);
 	
 #if ! __APPLE__
@@ -0,0 +1,176 @@
+
+/*
+ Times the engine's own per frame loops, Engine_Update and Engine_Render, over a generated
+ scene loaded through SceneSystem_Load. The engine is built without a platform layer: the
+ renderer draws nothing, and there is no nav mesh, script or view, so this is the cost of
+ walking actors, not of what their callbacks do.
+
+ Most actors are weapons, which turn in onUpdate and are culled and queued as static models.
+ The rest are triggers with onTouch, buttons that take taps, and waypoints with no callbacks.
+ The mouse is pressed every other frame so Engine_RecieveInput tests the tappable actors.
+
+ E=../../source/engine
+ cc -O2 -pthread -DSCENE_ACTORS_MAX=4096 -I$E/core -I$E/game -I$E/gui -I$E/input -I$E/nav \
+    -I$E/part -I$E/render -I$E/script -I$E/sound -I../../source/platform main.c \
+    $E/core/*.c $E/game/*.c $E/gui/*.c $E/input/*.c $E/nav/*.c $E/part/*.c $E/render/*.c \
+    $E/script/*.c $E/sound/*.c -o actorbench -lm -ldl
+
+ actorbench [-f frames] [actors]...
+
+ Reference, -O2, x86-64, -f 2000, best of 5 runs, per frame. Actors were 4 KB with their
+ transforms inline, 3.9 KB with the transforms in SceneSystem arrays, and are 256 bytes with
+ the flags, models, path and names moved out too. Past a thousand actors most of update is
+ SpatialHash_FindPairs, about 0.9 ms at 4096, which the layout doesn't change:
+ actors   update                        render
+          inline   arrays   split       inline   arrays   split
+ 256      26 us    26 us    26 us       5.1 us   5.3 us   5.4 us
+ 1024     207 us   176 us   169 us      32 us    29 us    27 us
+ 4096     1418 us  1241 us  1213 us     222 us   203 us   132 us
+ */
+
+#include <math.h>
+
+#include "engine.h"
+
+#include "../bench_util.h"
+
+#define MANIFEST_PATH "actorbench.manifest"
+
+/* a renderer that accepts everything and draws nothing */
+static int Null_Init(Renderer* renderer) { return 1; }
+static void Null_Shutdown(Renderer* renderer) {}
+static void Null_Render(Renderer* renderer, const Frustum* cam, const struct Engine* engine, const RenderQueue* queue) {}
+static int Null_PrepareGuiBuffer(Renderer* renderer, GuiBuffer* buffer) { return 1; }
+static int Null_PrepareHintBuffer(Renderer* renderer, HintBuffer* buffer) { return 1; }
+
+/* actors are spread over side by side units */
+static int Manifest_Write(const char* path, int count, float side)
+{
+    FILE* file = fopen(path, "w");
+
+    if (!file)
+        return 0;
+
+    static const char* types[] = { "weapon", "weapon", "weapon", "weapon", "weapon", "trigger", "button", "waypoint" };
+
+    fprintf(file, "{ \"actors\": [\n");
+
+    for (int i = 0; i < count; ++i)
+    {
+        float x = Rand_Float(-side * 0.5f, side * 0.5f);
+        float y = Rand_Float(-side * 0.5f, side * 0.5f);
+        const char* type = types[rand() % 8];
+
+        fprintf(file, "{ \"type\": \"%s\", \"position\": [%f, %f, 0.0], \"bounds_min\": [%f, %f, 0.0], \"bounds_max\": [%f, %f, 1.0] }%s\n",
+                type, x, y, x - 0.5f, y - 0.5f, x + 0.5f, y + 0.5f, i + 1 < count ? "," : "");
+    }
+
+    fprintf(file, "] }\n");
+    fclose(file);
+    return 1;
+}
+
+static int Bench(int count, int frames)
+{
+    Engine* engine = &g_engine;
+
+    /* the same density at every count, so touches grow with the actors */
+    float side = sqrtf(count) * 2.0f;
+
+    if (!Manifest_Write(MANIFEST_PATH, count, side))
+    {
+        printf("failed to write %s\n", MANIFEST_PATH);
+        return 0;
+    }
+
+    SceneSystem_Load(&engine->sceneSystem, MANIFEST_PATH);
+    remove(MANIFEST_PATH);
+
+    if (engine->sceneSystem.liveCount != count)
+    {
+        printf("%i actors: loaded %i\n", count, engine->sceneSystem.liveCount);
+        return 0;
+    }
+
+    /* from the middle, looking down at the far half */
+    Frustum* cam = &engine->renderSystem.cam;
+    cam->far = side;
+    cam->position = Vec3_Create(0.0f, 0.0f, side * 0.15f);
+    cam->target = Vec3_Create(0.0f, side * 0.3f, 0.0f);
+    cam->orientation = Vec3_Create(0.0f, 0.0f, 1.0f);
+
+    InputState input;
+    memset(&input, 0, sizeof(InputState));
+    input.mouseCursor.x = 320.0f;
+    input.mouseCursor.y = 240.0f;
+
+    double updateUs = 0.0;
+    double renderUs = 0.0;
+
+    /* the first frame is warm up */
+    for (int frame = 0; frame <= frames; ++frame)
+    {
+        input.mouseButtons[kMouseButtonLeft].down = frame % 2;
+        engine->inputSystem.info.mouseButtons[kMouseButtonLeft].handled = 0;
+
+        double start = Time_Us();
+        Engine_Update(engine, &input);
+        double end = Time_Us();
+        Engine_Render(engine);
+
+        if (frame > 0)
+        {
+            updateUs += end - start;
+            renderUs += Time_Us() - end;
+        }
+    }
+
+    const RenderCullStats* stats = &engine->renderSystem.cullStats;
+
+    printf("%i actors: update %.1f us, render %.1f us, %i of %i drawn (%zu byte Actor)\n",
+           count, updateUs / frames, renderUs / frames, stats->visible, stats->tested, sizeof(Actor));
+    return 1;
+}
+
+int main(int argc, const char* argv[])
+{
+    int frames = 200;
+    int arg = 1;
+
+    Args_ReadFlag(argc, argv, &arg, "-f", &frames);
+
+    if (frames < 1)
+    {
+        printf("usage: actorbench [-f frames] [actors]...\n");
+        return 1;
+    }
+
+    Renderer renderer;
+    memset(&renderer, 0, sizeof(Renderer));
+    renderer.init = Null_Init;
+    renderer.shutdown = Null_Shutdown;
+    renderer.render = Null_Render;
+    renderer.prepareGuiBuffer = Null_PrepareGuiBuffer;
+    renderer.prepareHintBuffer = Null_PrepareHintBuffer;
+
+    /* the parts of Engine_Init that don't load assets */
+    Engine* engine = &g_engine;
+    NavSystem_Init(&engine->navSystem);
+    ScriptSystem_Init(&engine->scriptSystem);
+    InputSystem_Init(&engine->inputSystem, kInputConfigMouseKeyboard);
+    RenderSystem_Init(&engine->renderSystem, engine, &renderer, 640, 480);
+    ViewCache_Init(&engine->viewCache, 0);
+    JobSystem_Init(&engine->jobSystem, 1);
+    SceneSystem_Init(&engine->sceneSystem);
+    engine->controlEnabled = 1;
+
+    /* weapons copy their model from here, so they get bounds to cull with */
+    StaticModel* wrench = engine->renderSystem.models + MODEL_WRENCH;
+    wrench->mesh.bounds.origin = Vec3_Zero;
+    wrench->mesh.bounds.radius = 0.5f;
+
+    srand(1);
+
+    const int counts[] = { 256, 1024, 4096 };
+    return Bench_RunCounts(argc, argv, arg, counts, 3, 1, SCENE_ACTORS_MAX, Bench, frames) ? 0 : 1;
+}
@@ -1,7 +1,19 @@
 
+/*
+ Generates data_assets.h from data.assets, and optionally the data.pack archive.
+
+ assetmanifest < data.assets > data_assets.h
+ assetmanifest -pack <data dir> data.pack < data.assets
+
+ The pack layout is described in source/engine/core/asset_pack.h.
+ Entries are keyed by the type and identifier written to the header, so both
+ must be generated from the same manifest.
+ */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 #define ASSET_NAME_MAX 128
 #define PATH_MAX 512
@@ -19,6 +31,7 @@ typedef struct
 typedef struct
 {
     int type;
+    int identifier;
     char enumName[ASSET_NAME_MAX];
     
     int hasPath;
@@ -33,9 +46,136 @@ static int AssetEntry_Compare(const void* a, const void *b)
     return strncmp(ea->enumName, eb->enumName, ASSET_NAME_MAX);
 }
 
+#define PACK_MAGIC 0x50425250
+#define PACK_VERSION 1
+#define PACK_ALIGN 16
+#define PACK_EXT_MAX 8
+
+static void Put32(FILE* file, uint32_t x)
+{
+    unsigned char bytes[4] = { x & 0xFF, (x >> 8) & 0xFF, (x >> 16) & 0xFF, (x >> 24) & 0xFF };
+    fwrite(bytes, 4, 1, file);
+}
+
+static void PadTo(FILE* file, long offset)
+{
+    while (ftell(file) < offset)
+        fputc(0, file);
+}
+
+static const char* Extension(const char* path)
+{
+    const char* dot = strrchr(path, '.');
+    return dot ? dot + 1 : "";
+}
+
+static int WritePack(const char* dataDir, const char* outPath, const AssetEntry* entries, int entryCount)
+{
+    FILE* out = fopen(outPath, "wb");
+    
+    if (!out)
+    {
+        fprintf(stderr, "failed to open %s\n", outPath);
+        return 0;
+    }
+    
+    /* entries sorted by type then identifier, as the engine searches them */
+    int packCount = 0;
+    const AssetEntry* packed[ASSET_ENTRY_MAX];
+    
+    for (int type = 0; type < ASSET_TYPE_MAX; ++type)
+    {
+        for (int i = 0; i < entryCount; ++i)
+        {
+            if (entries[i].type == type && entries[i].hasPath)
+                packed[packCount++] = entries + i;
+        }
+    }
+    
+    long tableSize = 16 + packCount * (16 + PACK_EXT_MAX);
+    long offset = (tableSize + PACK_ALIGN - 1) & ~(PACK_ALIGN - 1);
+    
+    uint32_t offsets[ASSET_ENTRY_MAX];
+    uint32_t lengths[ASSET_ENTRY_MAX];
+    
+    for (int i = 0; i < packCount; ++i)
+    {
+        char path[PATH_MAX * 2];
+        snprintf(path, sizeof(path), "%s/%s", dataDir, packed[i]->path);
+        
+        FILE* file = fopen(path, "rb");
+        
+        if (!file)
+        {
+            fprintf(stderr, "missing asset %s: %s\n", packed[i]->enumName, path);
+            fclose(out);
+            return 0;
+        }
+        
+        fseek(file, 0, SEEK_END);
+        lengths[i] = (uint32_t)ftell(file);
+        fclose(file);
+        
+        offsets[i] = (uint32_t)offset;
+        offset = (offset + lengths[i] + PACK_ALIGN - 1) & ~(PACK_ALIGN - 1);
+    }
+    
+    Put32(out, PACK_MAGIC);
+    Put32(out, PACK_VERSION);
+    Put32(out, packCount);
+    Put32(out, 0);
+    
+    for (int i = 0; i < packCount; ++i)
+    {
+        char extension[PACK_EXT_MAX];
+        memset(extension, 0, sizeof(extension));
+        strncpy(extension, Extension(packed[i]->path), PACK_EXT_MAX - 1);
+        
+        Put32(out, packed[i]->type);
+        Put32(out, packed[i]->identifier);
+        Put32(out, offsets[i]);
+        Put32(out, lengths[i]);
+        fwrite(extension, PACK_EXT_MAX, 1, out);
+    }
+    
+    for (int i = 0; i < packCount; ++i)
+    {
+        char path[PATH_MAX * 2];
+        snprintf(path, sizeof(path), "%s/%s", dataDir, packed[i]->path);
+        
+        FILE* file = fopen(path, "rb");
+        PadTo(out, offsets[i]);
+        
+        char buffer[4096];
+        size_t read;
+        while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            fwrite(buffer, 1, read, out);
+        
+        fclose(file);
+    }
+    
+    fclose(out);
+    fprintf(stderr, "packed %i assets, %li bytes\n", packCount, offset);
+    return 1;
+}
+
 int main(int argc, const char * argv[])
 {
     char lineBuffer[LINE_MAX];
+    
+    const char* packDir = NULL;
+    const char* packPath = NULL;
+    
+    if (argc == 4 && strcmp(argv[1], "-pack") == 0)
+    {
+        packDir = argv[2];
+        packPath = argv[3];
+    }
+    else if (argc != 1)
+    {
+        fprintf(stderr, "usage: assetmanifest [-pack <data dir> <out.pack>] < data.assets\n");
+        return 1;
+    }
  
     int entryCount = 0;
     int typeCount = 0;
@@ -86,6 +226,24 @@ int main(int argc, const char * argv[])
     
     qsort(entries, entryCount, sizeof(AssetEntry), AssetEntry_Compare);
     
+    /* enum values follow the sorted order within each type */
+    for (int i = 0; i < entryCount; ++i)
+    {
+        AssetEntry* entry = entries + i;
+        entry->identifier = 0;
+        
+        for (int j = 0; j < i; ++j)
+        {
+            if (entries[j].type == entry->type)
+                ++entry->identifier;
+        }
+    }
+    
+    if (packPath)
+    {
+        return WritePack(packDir, packPath, entries, entryCount) ? 0 : 1;
+    }
+    
     printf("#ifndef ASSET_MANIFEST_H\n");
     printf("#define ASSET_MANIFEST_H\n\n");
     
@@ -97,6 +255,14 @@ int main(int argc, const char * argv[])
     printf("    const char* path;\n");
     printf("} AssetEntry;\n\n");
     
+    /* keys for data.pack entries */
+    printf("enum\n{\n");
+    for (int i = 0; i < typeCount; ++i)
+    {
+        printf("    AssetType_%s,\n", types[i].name);
+    }
+    printf("};\n\n");
+    
     for (int i = 0; i < typeCount; ++i)
     {
         printf("enum\n{\n");
@@ -0,0 +1,84 @@
+
+/*
+ Helpers shared by the benchmarks and checks under tools/. Each tool is built on its own
+ from one main.c, so everything here is static inline. Include it as "../bench_util.h".
+
+ Count driven tools take an optional flag then counts, as in touchbench [-f frames] [actors]...
+ With no counts they run their defaults, skipping any past the largest count allowed.
+ */
+
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* runs one benchmark at count, with the tool's flag value. returns 0 on a mismatch or failure */
+typedef int (*BenchFunc)(int count, int value);
+
+static inline double Time_Us()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+static inline double Time_Ms()
+{
+    return Time_Us() / 1000.0;
+}
+
+static inline float Rand_Float(float min, float max)
+{
+    return min + (max - min) * (rand() / (float)RAND_MAX);
+}
+
+/* reads "flag N" at argv[*arg] into value and steps past both. returns 0, leaving *arg, if it isn't there */
+static inline int Args_ReadFlag(int argc, const char* argv[], int* arg, const char* flag, int* value)
+{
+    if (*arg + 1 >= argc || strcmp(argv[*arg], flag) != 0)
+        return 0;
+
+    *value = atoi(argv[*arg + 1]);
+    *arg += 2;
+    return 1;
+}
+
+/* runs bench over the counts from argv[arg] on, or over defaults when there are none.
+ Counts given outside [minCount, maxCount] fail */
+static inline int Bench_RunCounts(int argc, const char* argv[], int arg,
+                                  const int* defaults, int defaultCount,
+                                  int minCount, int maxCount,
+                                  BenchFunc bench, int value)
+{
+    if (arg >= argc)
+    {
+        for (int i = 0; i < defaultCount; ++i)
+        {
+            if (defaults[i] <= maxCount && !bench(defaults[i], value))
+                return 0;
+        }
+
+        return 1;
+    }
+
+    for (; arg < argc; ++arg)
+    {
+        int count = atoi(argv[arg]);
+
+        if (count < minCount || count > maxCount)
+        {
+            printf("%s: not a valid count\n", argv[arg]);
+            return 0;
+        }
+
+        if (!bench(count, value))
+            return 0;
+    }
+
+    return 1;
+}
+
+#endif
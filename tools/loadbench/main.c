@@ -0,0 +1,89 @@
+
+/*
+ Times the engine's model loaders, to check load time work against real assets.
+
+ E=../../source/engine
+ cc -O2 -I$E/core -I$E/render main.c $E/render/static_model.c $E/render/static_mesh.c \
+    $E/render/mesh_opt.c $E/render/material.c $E/core/vec_math.c $E/core/geo_math.c \
+    $E/core/utils.c -o loadbench -lm
+
+ loadbench [-n iterations] wrench.obj tunnel.mesh ...
+
+ Reference, 200x200 grid obj with its faces shuffled (5.4 MB, 79202 triangles), -O2,
+ best of 12 runs. ACMR is computed after the timing:
+ fgets/sscanf parser, unindexed    91 ms, 237609 verts
+ chunked tokenizer, indexed        11.4 ms, 40000 verts, ACMR 3.00
+ .bmesh, meshconvert               0.61 ms, ordered offline, ACMR 0.68
+
+ The tokenizer is 8x the old parser, short of the 10x aimed for. Most of what is left is
+ parsing face indices and looking up shared corners, which the shuffled faces scatter.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "static_model.h"
+#include "mesh_opt.h"
+
+int main(int argc, const char* argv[])
+{
+    int iterations = 10;
+    int arg = 1;
+
+    if (argc > 2 && strcmp(argv[1], "-n") == 0)
+    {
+        iterations = atoi(argv[2]);
+        arg = 3;
+    }
+
+    if (arg >= argc || iterations < 1)
+    {
+        printf("usage: loadbench [-n iterations] <model>...\n");
+        return 1;
+    }
+
+    for (; arg < argc; ++arg)
+    {
+        StaticModel last;
+        clock_t start = clock();
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            StaticModel model;
+            memset(&model, 0, sizeof(model));
+
+            if (!StaticModel_FromPath(&model, argv[arg]))
+            {
+                printf("failed to load %s\n", argv[arg]);
+                return 1;
+            }
+
+            /* the last load is kept for its stats, outside the timing */
+            if (i + 1 < iterations)
+                StaticModel_Shutdown(&model);
+            else
+                last = model;
+        }
+
+        double ms = ((double)(clock() - start) / CLOCKS_PER_SEC) * 1000.0 / iterations;
+
+        unsigned int vertCount = last.mesh.vertCount;
+        unsigned int indexCount = last.mesh.indexCount;
+        float acmr = 0.0f;
+
+        if (last.mesh.indices)
+            acmr = MeshOpt_ACMR(last.mesh.indices, indexCount, vertCount, 16);
+
+        StaticModel_Shutdown(&last);
+        printf("%s: %.2f ms, %u verts", argv[arg], ms, vertCount);
+
+        if (indexCount > 0)
+            printf(", %u indices, ACMR %.2f", indexCount, acmr);
+
+        printf("\n");
+    }
+
+    return 0;
+}
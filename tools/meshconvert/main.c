@@ -0,0 +1,157 @@
+
+/*
+ Converts static models to version 2 .bmesh, with the triangles ordered for the vertex cache.
+ The ordering is too slow to run on every load, so point data.assets at the .bmesh.
+
+ E=../../source/engine
+ cc -O2 -I$E/core -I$E/render main.c $E/render/static_model.c $E/render/static_mesh.c \
+    $E/render/mesh_opt.c $E/render/material.c $E/core/vec_math.c $E/core/geo_math.c \
+    $E/core/utils.c -o meshconvert -lm
+
+ meshconvert wrench.obj wrench.bmesh
+
+ Any model the engine loads is accepted. The output is reloaded and must match the
+ ordered mesh bit for bit. ACMR, vertex shader runs per triangle for a 16 entry FIFO,
+ is printed before and after ordering.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "static_model.h"
+#include "mesh_opt.h"
+
+static void Put32(FILE* file, uint32_t x)
+{
+    unsigned char bytes[4] = { x & 0xFF, (x >> 8) & 0xFF, (x >> 16) & 0xFF, (x >> 24) & 0xFF };
+    fwrite(bytes, 4, 1, file);
+}
+
+static void Put16(FILE* file, uint16_t x)
+{
+    unsigned char bytes[2] = { x & 0xFF, x >> 8 };
+    fwrite(bytes, 2, 1, file);
+}
+
+static void PutFloat(FILE* file, float f)
+{
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    Put32(file, x);
+}
+
+static void PutVec3(FILE* file, Vec3 v)
+{
+    PutFloat(file, v.x);
+    PutFloat(file, v.y);
+    PutFloat(file, v.z);
+}
+
+static int WriteBinary(const StaticMesh* mesh, const char* path)
+{
+    FILE* file = fopen(path, "wb");
+
+    if (!file)
+    {
+        printf("failed to open %s\n", path);
+        return 0;
+    }
+
+    Put32(file, STATIC_MODEL_BINARY_VERSION);
+    Put32(file, mesh->vertCount);
+    Put32(file, mesh->uvChannelCount);
+    Put32(file, mesh->indexCount);
+
+    for (unsigned int i = 0; i < mesh->vertCount; ++i)
+    {
+        const StaticMeshVert* vert = mesh->verts + i;
+        PutVec3(file, vert->pos);
+        PutVec3(file, vert->normal);
+
+        for (int j = 0; j < STATIC_MESH_UVS; ++j)
+        {
+            Put16(file, vert->uv[j].u);
+            Put16(file, vert->uv[j].v);
+        }
+    }
+
+    for (unsigned int i = 0; i < mesh->indexCount; ++i)
+        Put32(file, mesh->indices[i]);
+
+    int status = !ferror(file);
+
+    if (fclose(file) != 0 || !status)
+    {
+        printf("failed to write %s\n", path);
+        return 0;
+    }
+
+    return 1;
+}
+
+static int Mesh_Equal(const StaticMesh* a, const StaticMesh* b)
+{
+    if (a->vertCount != b->vertCount || a->uvChannelCount != b->uvChannelCount || a->indexCount != b->indexCount)
+        return 0;
+
+    if (memcmp(a->verts, b->verts, sizeof(StaticMeshVert) * a->vertCount) != 0)
+        return 0;
+
+    return a->indexCount == 0 || memcmp(a->indices, b->indices, sizeof(unsigned int) * a->indexCount) == 0;
+}
+
+int main(int argc, const char* argv[])
+{
+    if (argc != 3)
+    {
+        printf("usage: meshconvert <model> <out.bmesh>\n");
+        return 1;
+    }
+
+    StaticModel model;
+    memset(&model, 0, sizeof(model));
+
+    if (!StaticModel_FromPath(&model, argv[1]))
+    {
+        printf("failed to load %s\n", argv[1]);
+        return 1;
+    }
+
+    StaticMesh* mesh = &model.mesh;
+
+    if (mesh->indices)
+    {
+        float before = MeshOpt_ACMR(mesh->indices, mesh->indexCount, mesh->vertCount, 16);
+
+        if (!StaticMesh_Optimize(mesh))
+        {
+            printf("failed to order %s\n", argv[1]);
+            return 1;
+        }
+
+        float after = MeshOpt_ACMR(mesh->indices, mesh->indexCount, mesh->vertCount, 16);
+        printf("%u verts, %u indices, ACMR %.2f ordered to %.2f\n", mesh->vertCount, mesh->indexCount, before, after);
+    }
+    else
+    {
+        printf("%u verts, not indexed\n", mesh->vertCount);
+    }
+
+    if (!WriteBinary(mesh, argv[2]))
+        return 1;
+
+    StaticModel check;
+    memset(&check, 0, sizeof(check));
+
+    if (!StaticModel_FromPath(&check, argv[2]) || !Mesh_Equal(mesh, &check.mesh))
+    {
+        printf("%s does not reload to the same mesh\n", argv[2]);
+        return 1;
+    }
+
+    StaticModel_Shutdown(&check);
+    StaticModel_Shutdown(&model);
+    return 0;
+}
@@ -0,0 +1,193 @@
+
+/*
+ Times NavMesh_Raycast on a synthetic rolling grid, testing every poly as it used to
+ against walking the bounding volume hierarchy, and checks both find the same poly.
+ Half the rays probe straight down for the floor, like Player_OnUpdate, and half
+ come from a raised camera, like clicks.
+
+ E=../../source/engine
+ cc -O2 -I$E/core -I$E/nav main.c $E/nav/nav_mesh.c $E/core/geo_math.c $E/core/vec_math.c \
+    $E/core/utils.c -o navbench -lm
+
+ navbench [-r rays] [grid size]...
+
+ Reference, -O2, x86-64, 10000 rays, per ray:
+ polys    every poly   hierarchy   build
+ 100      6.0 us       0.62 us     0.05 ms
+ 2500     101 us       0.94 us     0.8 ms
+ 10000    356 us       1.1 us      3.4 ms
+ */
+
+#include "nav_mesh.h"
+
+#include "../bench_util.h"
+
+/* edge indices are 16 bit, so size * size * 4 <= 0xFFFF */
+#define GRID_SIZE_MAX 127
+
+static float Grid_Height(float x, float y)
+{
+    return sinf(x * 0.15f) * cosf(y * 0.11f) * 2.0f;
+}
+
+/* size by size unit quads. Shared vertices follow the rolling height, so quads aren't quite flat */
+static int Grid_Build(NavMesh* mesh, int size)
+{
+    int side = size + 1;
+
+    if (!NavMesh_Init(mesh, side * side, size * size * 4, size * size))
+        return 0;
+
+    for (int y = 0; y < side; ++y)
+    {
+        for (int x = 0; x < side; ++x)
+            mesh->vertices[y * side + x] = Vec3_Create(x, y, Grid_Height(x, y));
+    }
+
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            int index = y * size + x;
+            NavPoly* poly = mesh->polys + index;
+
+            poly->index = index;
+            poly->edgeStart = index * 4;
+            poly->edgeCount = 4;
+
+            unsigned short corners[4] = {
+                y * side + x,
+                y * side + x + 1,
+                (y + 1) * side + x + 1,
+                (y + 1) * side + x
+            };
+
+            short neighbors[4] = {
+                y > 0 ? index - size : -1,
+                x + 1 < size ? index + 1 : -1,
+                y + 1 < size ? index + size : -1,
+                x > 0 ? index - 1 : -1
+            };
+
+            Vec3 center = Vec3_Zero;
+
+            for (int j = 0; j < 4; ++j)
+            {
+                NavEdge* edge = mesh->edges + poly->edgeStart + j;
+                edge->flags = neighbors[j] == -1 ? kNavEdgeFlagSolid : kNavEdgeFlagNone;
+                edge->neighborIndex = neighbors[j];
+                edge->vertices[0] = corners[j];
+                edge->vertices[1] = corners[(j + 1) % 4];
+
+                center = Vec3_Add(center, Vec3_Lerp(mesh->vertices[corners[j]], mesh->vertices[corners[(j + 1) % 4]], 0.5f));
+            }
+
+            Vec3 d1 = Vec3_Sub(mesh->vertices[corners[2]], mesh->vertices[corners[0]]);
+            Vec3 d2 = Vec3_Sub(mesh->vertices[corners[3]], mesh->vertices[corners[1]]);
+
+            poly->plane.normal = Vec3_Norm(Vec3_Cross(d1, d2));
+            poly->plane.point = Vec3_Scale(center, 0.25f);
+        }
+    }
+
+    return 1;
+}
+
+static int Bench(int size, int rayCount)
+{
+    NavMesh mesh;
+
+    if (!Grid_Build(&mesh, size))
+    {
+        printf("failed to build mesh\n");
+        return 0;
+    }
+
+    Ray3* rays = malloc(sizeof(Ray3) * rayCount);
+    NavPoly** expected = malloc(sizeof(NavPoly*) * rayCount);
+    float* expectedT = malloc(sizeof(float) * rayCount);
+
+    Vec3 camera = Vec3_Create(-size * 0.2f, -size * 0.2f, size * 0.5f);
+
+    for (int i = 0; i < rayCount; ++i)
+    {
+        float x = Rand_Float(0.0f, size);
+        float y = Rand_Float(0.0f, size);
+
+        if (i % 2 == 0)
+        {
+            rays[i] = Ray3_Create(Vec3_Create(x, y, Grid_Height(x, y) + 1.0f), Vec3_Create(0.0f, 0.0f, -1.0f));
+        }
+        else
+        {
+            Vec3 target = Vec3_Create(x, y, Grid_Height(x, y));
+            rays[i] = Ray3_Create(camera, Vec3_Norm(Vec3_Sub(target, camera)));
+        }
+    }
+
+    /* without the hierarchy every poly is tested */
+    double start = Time_Us();
+
+    for (int i = 0; i < rayCount; ++i)
+        expected[i] = NavMesh_Raycast(&mesh, rays[i], expectedT + i);
+
+    double bruteUs = Time_Us() - start;
+
+    start = Time_Us();
+
+    if (!NavMesh_BuildBvh(&mesh))
+    {
+        printf("failed to build hierarchy\n");
+        return 0;
+    }
+
+    double buildUs = Time_Us() - start;
+
+    int hits = 0;
+    start = Time_Us();
+
+    for (int i = 0; i < rayCount; ++i)
+    {
+        float t;
+        NavPoly* poly = NavMesh_Raycast(&mesh, rays[i], &t);
+
+        if (poly != expected[i] || (poly && t != expectedT[i]))
+        {
+            printf("%i polys: ray %i hit %i, expected %i\n", mesh.polyCount, i,
+                   poly ? poly->index : -1, expected[i] ? expected[i]->index : -1);
+            return 0;
+        }
+
+        hits += poly != NULL;
+    }
+
+    double bvhUs = Time_Us() - start;
+
+    printf("%i polys: every poly %.2f us, hierarchy %.3f us, build %.2f ms, %i nodes, %i of %i rays hit\n",
+           mesh.polyCount, bruteUs / rayCount, bvhUs / rayCount, buildUs / 1000.0, mesh.bvhNodeCount, hits, rayCount);
+
+    NavMesh_Shutdown(&mesh);
+    free(rays);
+    free(expected);
+    free(expectedT);
+    return 1;
+}
+
+int main(int argc, const char* argv[])
+{
+    int rayCount = 10000;
+    int arg = 1;
+
+    Args_ReadFlag(argc, argv, &arg, "-r", &rayCount);
+
+    if (rayCount < 1)
+    {
+        printf("usage: navbench [-r rays] [grid size]...\n");
+        return 1;
+    }
+
+    srand(1);
+
+    const int sizes[] = { 10, 50, 100 };
+    return Bench_RunCounts(argc, argv, arg, sizes, 3, 1, GRID_SIZE_MAX, Bench, rayCount) ? 0 : 1;
+}
@@ -0,0 +1,254 @@
+
+/*
+ Packs random static and skinned verts with StaticMesh_Pack and SkelSkin_Pack, decodes
+ them the way the PACKED_VERTS shaders do, and checks the error against the float layout.
+ Some skinned verts have weights that don't sum to one, as exporters write them, which
+ must still pack to influences summing to 255.
+
+ E=../../source/engine
+ cc -O2 -I$E/core -I$E/render main.c $E/render/static_mesh.c $E/render/skel_skin.c \
+    $E/render/skel.c $E/render/mesh_opt.c $E/core/vec_math.c $E/core/vec_soa.c \
+    $E/core/geo_math.c $E/core/utils.c -o packcheck -lm
+
+ packcheck [verts]
+
+ Positions and weight offsets are reported in quantization steps, so half a step is exact
+ rounding. Influences are against the weights normalized to sum to one.
+
+ Reference, x86-64, 100000 verts. Before weights were normalized, 16961 of the skinned
+ verts packed to influences not summing to 255, some wrapping past zero:
+ position     0.503 steps
+ normal       0.0037 degrees
+ tangent      0.0036 degrees
+ offset       0.501 steps
+ influence    0.0039, every vert summing to 255
+ */
+
+#include "static_mesh.h"
+#include "skel_skin.h"
+
+#include "../bench_util.h"
+
+/* past these the packed layout visibly differs from the float one.
+ Decoding in float, as the shaders do, costs a few hundredths of a step on top of rounding */
+#define MAX_STEP_ERROR 0.51f
+#define MAX_ANGLE_ERROR 0.01f
+#define MAX_INFLUENCE_ERROR (2.0f / 255.0f)
+
+static Vec3 Rand_Unit()
+{
+    Vec3 v;
+
+    do
+    {
+        v = Vec3_Create(Rand_Float(-1.0f, 1.0f), Rand_Float(-1.0f, 1.0f), Rand_Float(-1.0f, 1.0f));
+    } while (Vec3_Length(v) < 0.01f);
+
+    return Vec3_Norm(v);
+}
+
+/* as the shaders, a_normal / 32767.0 then octDecode */
+static Vec3 Unpack_Normal(const short* packed)
+{
+    return Vec3_Norm(Vec2_OctDecode(Vec2_Create(packed[0] / 32767.0f, packed[1] / 32767.0f)));
+}
+
+/* acosf of the dot loses small angles to float precision, about 0.02 degrees */
+static float Angle_Degrees(Vec3 a, Vec3 b)
+{
+    return atan2f(Vec3_Length(Vec3_Cross(a, b)), Vec3_Dot(a, b)) * 180.0f / M_PI;
+}
+
+static int Check_StaticMesh(int vertCount)
+{
+    StaticMesh mesh;
+
+    if (!StaticMesh_Init(&mesh, vertCount, 2))
+    {
+        printf("failed to init mesh\n");
+        return 0;
+    }
+
+    /* one flat axis, which still needs a scale */
+    for (int i = 0; i < vertCount; ++i)
+    {
+        StaticMeshVert* vert = mesh.verts + i;
+        vert->pos = Vec3_Create(Rand_Float(-40.0f, 25.0f), Rand_Float(0.0f, 3.0f), 2.0f);
+        vert->normal = Rand_Unit();
+
+        for (int j = 0; j < STATIC_MESH_UVS; ++j)
+        {
+            vert->uv[j].u = rand() & 0xFFFF;
+            vert->uv[j].v = rand() & 0xFFFF;
+        }
+    }
+
+    StaticMeshPackedVert* packed = malloc(sizeof(StaticMeshPackedVert) * vertCount);
+
+    if (!packed)
+    {
+        printf("failed to allocate packed verts\n");
+        return 0;
+    }
+
+    StaticMesh_Pack(&mesh, packed);
+
+    float posError = 0.0f;
+    float normalError = 0.0f;
+    int uvsEqual = 1;
+
+    for (int i = 0; i < vertCount; ++i)
+    {
+        const StaticMeshVert* vert = mesh.verts + i;
+
+        for (int j = 0; j < 3; ++j)
+        {
+            float scale = Vec3_Get(mesh.packScale, j);
+            float decoded = packed[i].pos[j] * scale + Vec3_Get(mesh.packOffset, j);
+            posError = MAX(posError, fabsf(decoded - Vec3_Get(vert->pos, j)) / scale);
+        }
+
+        normalError = MAX(normalError, Angle_Degrees(Unpack_Normal(packed[i].normal), vert->normal));
+        uvsEqual &= memcmp(packed[i].uv, vert->uv, sizeof(vert->uv)) == 0;
+    }
+
+    printf("static mesh, %i verts, %zu bytes packed from %zu\n", vertCount, sizeof(StaticMeshPackedVert), sizeof(StaticMeshVert));
+    printf(" position     %.3f steps\n", posError);
+    printf(" normal       %.4f degrees\n", normalError);
+
+    free(packed);
+    StaticMesh_Shutdown(&mesh);
+
+    if (posError > MAX_STEP_ERROR || normalError > MAX_ANGLE_ERROR || !uvsEqual)
+    {
+        printf("static mesh round trip failed%s\n", uvsEqual ? "" : ", uvs differ");
+        return 0;
+    }
+
+    return 1;
+}
+
+static int Check_SkelSkin(int vertCount)
+{
+    SkelSkin skin;
+
+    if (!SkelSkin_Init(&skin, vertCount, vertCount * SKEL_WEIGHTS_PER_VERT))
+    {
+        printf("failed to init skin\n");
+        return 0;
+    }
+
+    for (int i = 0; i < vertCount; ++i)
+    {
+        SkelSkinVert* vert = skin.verts + i;
+        vert->normal = Rand_Unit();
+        vert->tangent = Rand_Unit();
+        vert->uv.u = rand() & 0xFFFF;
+        vert->uv.v = rand() & 0xFFFF;
+
+        /* a quarter sum to one, the rest are scaled up to three times over or under */
+        float sum = 0.0f;
+        float w[SKEL_WEIGHTS_PER_VERT];
+
+        for (int j = 0; j < SKEL_WEIGHTS_PER_VERT; ++j)
+        {
+            w[j] = j == 0 || rand() % 3 ? Rand_Float(0.0f, 1.0f) : 0.0f;
+            sum += w[j];
+        }
+
+        float scale = i % 4 == 0 ? 1.0f / MAX(sum, V_EPSILON) : Rand_Float(0.3f, 3.0f);
+
+        for (int j = 0; j < SKEL_WEIGHTS_PER_VERT; ++j)
+        {
+            Vec3 offset = Vec3_Scale(Rand_Unit(), Rand_Float(0.0f, 1.5f));
+            vert->weights[j] = Vec4_Create(offset.x, offset.y, offset.z, w[j] * scale);
+            vert->weightJoints[j] = rand() % 64;
+        }
+    }
+
+    SkelSkinPackedVert* packed = malloc(sizeof(SkelSkinPackedVert) * vertCount);
+
+    if (!packed)
+    {
+        printf("failed to allocate packed verts\n");
+        return 0;
+    }
+
+    SkelSkin_Pack(&skin, packed);
+
+    float normalError = 0.0f;
+    float tangentError = 0.0f;
+    float offsetError = 0.0f;
+    float influenceError = 0.0f;
+    int badSums = 0;
+    int othersEqual = 1;
+
+    for (int i = 0; i < vertCount; ++i)
+    {
+        const SkelSkinVert* vert = skin.verts + i;
+        const SkelSkinPackedVert* p = packed + i;
+
+        normalError = MAX(normalError, Angle_Degrees(Unpack_Normal(p->normal), vert->normal));
+        tangentError = MAX(tangentError, Angle_Degrees(Unpack_Normal(p->tangent), vert->tangent));
+
+        float weightSum = 0.0f;
+        int influenceSum = 0;
+
+        for (int j = 0; j < SKEL_WEIGHTS_PER_VERT; ++j)
+        {
+            weightSum += vert->weights[j].w;
+            influenceSum += p->influences[j];
+        }
+
+        badSums += influenceSum != 255;
+
+        for (int j = 0; j < SKEL_WEIGHTS_PER_VERT; ++j)
+        {
+            const Vec4* w = vert->weights + j;
+            offsetError = MAX(offsetError, fabsf(p->weightOffsets[j][0] * skin.packScale - w->x) / skin.packScale);
+            offsetError = MAX(offsetError, fabsf(p->weightOffsets[j][1] * skin.packScale - w->y) / skin.packScale);
+            offsetError = MAX(offsetError, fabsf(p->weightOffsets[j][2] * skin.packScale - w->z) / skin.packScale);
+
+            influenceError = MAX(influenceError, fabsf(p->influences[j] / 255.0f - w->w / weightSum));
+            othersEqual &= p->weightJoints[j] == vert->weightJoints[j];
+        }
+
+        othersEqual &= p->uv.u == vert->uv.u && p->uv.v == vert->uv.v;
+    }
+
+    printf("skinned mesh, %i verts, %zu bytes packed from %zu\n", vertCount, sizeof(SkelSkinPackedVert), sizeof(SkelSkinVert));
+    printf(" normal       %.4f degrees\n", normalError);
+    printf(" tangent      %.4f degrees\n", tangentError);
+    printf(" offset       %.3f steps\n", offsetError);
+    printf(" influence    %.4f, %i verts not summing to 255\n", influenceError, badSums);
+
+    free(packed);
+    SkelSkin_Shutdown(&skin);
+
+    if (normalError > MAX_ANGLE_ERROR || tangentError > MAX_ANGLE_ERROR || offsetError > MAX_STEP_ERROR ||
+        influenceError > MAX_INFLUENCE_ERROR || badSums > 0 || !othersEqual)
+    {
+        printf("skinned mesh round trip failed%s\n", othersEqual ? "" : ", uvs or joints differ");
+        return 0;
+    }
+
+    return 1;
+}
+
+int main(int argc, const char* argv[])
+{
+    int vertCount = argc > 1 ? atoi(argv[1]) : 100000;
+
+    if (vertCount < 1)
+    {
+        printf("usage: packcheck [verts]\n");
+        return 1;
+    }
+
+    srand(1);
+
+    if (!Check_StaticMesh(vertCount) || !Check_SkelSkin(vertCount))
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,389 @@
+
+/*
+ Checks NavSolver_Solve against the sorted list solver it replaced, and times path
+ queries on a synthetic grid with blobs of blocked cells. Both must find the same
+ polys through the same edges, or neither a path.
+
+ E=../../source/engine
+ cc -O2 -I$E/core -I$E/nav main.c $E/nav/nav.c $E/nav/nav_mesh.c $E/core/geo_math.c \
+    $E/core/vec_math.c $E/core/utils.c -o pathbench -lm
+
+ pathbench [-q queries] [grid size]...
+
+ Query ends are at most QUERY_REACH cells apart on each axis, so paths fit PATH_MAX_NODES.
+ Ends walled off from each other search their whole region before giving up.
+
+ Reference, -O2, x86-64, 2000 queries:
+ polys    sorted list      heap
+ 400      29700 /s         56500 /s
+ 2500     6200 /s          15300 /s
+ 8100     1560 /s          6600 /s
+ */
+
+#include "nav.h"
+#include "stretchy_buffer.h"
+
+#include "../bench_util.h"
+
+/* cells a query's ends are apart at most, along each axis */
+#define QUERY_REACH 20
+
+/* search nodes keep edge indices in a short, so size * size * 4 <= 0x7FFF */
+#define GRID_SIZE_MAX 90
+
+/* the solver before the heap, an open list sorted by cost */
+
+struct ListNode
+{
+    short polyIndex;
+    short edgeIndex;
+    float cost;
+    int next;
+    int parent;
+};
+
+typedef struct
+{
+    int head;
+    struct ListNode* pool;
+    char* closed;
+} ListSolver;
+
+static void ListSolver_Prepare(ListSolver* nav, const NavMesh* mesh)
+{
+    nav->pool = NULL;
+    nav->closed = NULL;
+
+    stb_sb_add(nav->pool, mesh->polyCount);
+    stb_sb_add(nav->closed, mesh->polyCount);
+}
+
+static int ListSolver_Solve(ListSolver* nav,
+                            const NavMesh* mesh,
+                            Vec3 startPoint,
+                            Vec3 endPoint,
+                            const NavPoly* startPoly,
+                            const NavPoly* endPoly,
+                            NavPath* path)
+{
+    NavPath_Clear(path);
+
+    stb__sbn(nav->pool) = 0;
+    memset(nav->closed, 0, sizeof(char) * stb__sbn(nav->closed));
+
+    struct ListNode* first = stb_sb_add(nav->pool, 1);
+    first->next = -1;
+    first->parent = -1;
+    first->polyIndex = startPoly->index;
+    first->edgeIndex = -1;
+    first->cost = 0.0f;
+
+    nav->head = 0;
+
+    while (nav->head != -1)
+    {
+        int currentIndex = nav->head;
+        struct ListNode* currentNode = nav->pool + currentIndex;
+
+        Vec3 currentPoint = startPoint;
+        if (currentNode->edgeIndex != -1)
+        {
+            const NavEdge* edge = mesh->edges + currentNode->edgeIndex;
+            currentPoint = Vec3_Lerp(mesh->vertices[edge->vertices[0]], mesh->vertices[edge->vertices[1]], 0.5f);
+        }
+
+        nav->head = currentNode->next;
+        currentNode->next = -1;
+        nav->closed[currentNode->polyIndex] = 1;
+
+        if (currentNode->polyIndex == endPoly->index)
+        {
+            NavPath temp;
+            NavPath_Init(&temp);
+
+            NavPath_AddNode(&temp, endPoint, -1, endPoly->index);
+
+            const struct ListNode* i = currentNode;
+
+            while (i->parent != -1)
+            {
+                NavPath_AddNode(&temp, Vec3_Zero, i->edgeIndex, i->polyIndex);
+                i = nav->pool + i->parent;
+            }
+
+            NavPath_Reverse(&temp, path);
+            return 1;
+        }
+
+        const NavPoly* currentPoly = mesh->polys + currentNode->polyIndex;
+
+        for (int i = 0; i < currentPoly->edgeCount; ++i)
+        {
+            const NavEdge* edge = mesh->edges + currentPoly->edgeStart + i;
+
+            if (edge->neighborIndex == -1)
+                continue;
+
+            const NavPoly* neighbor = mesh->polys + edge->neighborIndex;
+
+            if (nav->closed[neighbor->index] == 1)
+                continue;
+
+            struct ListNode* toInsert = NULL;
+
+            if (nav->head != -1)
+            {
+                struct ListNode* node = nav->pool + nav->head;
+                struct ListNode* previous = NULL;
+
+                while (node)
+                {
+                    if (node->polyIndex == neighbor->index)
+                    {
+                        toInsert = node;
+
+                        if (previous)
+                            previous->next = toInsert->next;
+                        else
+                            nav->head = toInsert->next;
+                        break;
+                    }
+
+                    previous = node;
+                    node = node->next != -1 ? nav->pool + node->next : NULL;
+                }
+            }
+
+            if (!toInsert)
+            {
+                toInsert = stb_sb_add(nav->pool, 1);
+                currentNode = nav->pool + currentIndex;
+            }
+
+            Vec3 edgeCenter = Vec3_Lerp(mesh->vertices[edge->vertices[0]], mesh->vertices[edge->vertices[1]], 0.5f);
+
+            float heuristic = Vec3_Dist(edgeCenter, endPoint) * 1.5f;
+            toInsert->cost = currentNode->cost + Vec3_Dist(edgeCenter, currentPoint) + heuristic;
+
+            toInsert->polyIndex = neighbor->index;
+            toInsert->edgeIndex = currentPoly->edgeStart + i;
+            toInsert->parent = currentIndex;
+            toInsert->next = -1;
+
+            int toInsertIndex = (int)(toInsert - nav->pool);
+
+            if (nav->head == -1)
+            {
+                nav->head = toInsertIndex;
+                continue;
+            }
+
+            struct ListNode* node = nav->pool + nav->head;
+            struct ListNode* previous = NULL;
+            int inserted = 0;
+
+            while (node)
+            {
+                if (toInsert->cost < node->cost)
+                {
+                    toInsert->next = (int)(node - nav->pool);
+
+                    if (previous)
+                        previous->next = toInsertIndex;
+                    else
+                        nav->head = toInsertIndex;
+
+                    inserted = 1;
+                    break;
+                }
+
+                previous = node;
+                node = node->next != -1 ? nav->pool + node->next : NULL;
+            }
+
+            if (!inserted)
+                previous->next = toInsertIndex;
+        }
+    }
+
+    return 0;
+}
+
+static int Grid_Blocked(int x, int y)
+{
+    return sinf(x * 0.7f) * cosf(y * 0.55f) + sinf((x + y) * 0.23f) * 0.5f > 0.8f;
+}
+
+/* size by size unit quads, linked to the four around them unless either is blocked */
+static int Grid_Build(NavMesh* mesh, int size)
+{
+    int side = size + 1;
+
+    if (!NavMesh_Init(mesh, side * side, size * size * 4, size * size))
+        return 0;
+
+    for (int y = 0; y < side; ++y)
+    {
+        for (int x = 0; x < side; ++x)
+            mesh->vertices[y * side + x] = Vec3_Create(x, y, 0.0f);
+    }
+
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            int index = y * size + x;
+            NavPoly* poly = mesh->polys + index;
+
+            poly->index = index;
+            poly->edgeStart = index * 4;
+            poly->edgeCount = 4;
+            poly->plane = Plane_Create(Vec3_Create(x + 0.5f, y + 0.5f, 0.0f), Vec3_Create(0.0f, 0.0f, 1.0f));
+
+            unsigned short corners[4] = {
+                y * side + x,
+                y * side + x + 1,
+                (y + 1) * side + x + 1,
+                (y + 1) * side + x
+            };
+
+            int nx[4] = { x, x + 1, x, x - 1 };
+            int ny[4] = { y - 1, y, y + 1, y };
+
+            for (int j = 0; j < 4; ++j)
+            {
+                NavEdge* edge = mesh->edges + poly->edgeStart + j;
+                edge->vertices[0] = corners[j];
+                edge->vertices[1] = corners[(j + 1) % 4];
+                edge->neighborIndex = -1;
+                edge->flags = kNavEdgeFlagSolid;
+
+                if (nx[j] >= 0 && nx[j] < size && ny[j] >= 0 && ny[j] < size &&
+                    !Grid_Blocked(x, y) && !Grid_Blocked(nx[j], ny[j]))
+                {
+                    edge->neighborIndex = ny[j] * size + nx[j];
+                    edge->flags = kNavEdgeFlagNone;
+                }
+            }
+        }
+    }
+
+    return 1;
+}
+
+static int Path_Equal(const NavPath* a, const NavPath* b)
+{
+    if (a->nodeCount != b->nodeCount)
+        return 0;
+
+    for (int i = 0; i < a->nodeCount; ++i)
+    {
+        if (a->nodes[i].polyIndex != b->nodes[i].polyIndex || a->nodes[i].edgeIndex != b->nodes[i].edgeIndex)
+            return 0;
+    }
+
+    return 1;
+}
+
+static int Bench(int size, int queryCount)
+{
+    NavMesh mesh;
+
+    if (!Grid_Build(&mesh, size))
+    {
+        printf("failed to build mesh\n");
+        return 0;
+    }
+
+    int* starts = malloc(sizeof(int) * queryCount);
+    int* ends = malloc(sizeof(int) * queryCount);
+
+    for (int i = 0; i < queryCount; ++i)
+    {
+        int x = rand() % size;
+        int y = rand() % size;
+        int reach = MIN(QUERY_REACH, size - 1);
+
+        int endX = x + rand() % (reach * 2 + 1) - reach;
+        int endY = y + rand() % (reach * 2 + 1) - reach;
+
+        starts[i] = y * size + x;
+        ends[i] = CLAMP(endY, 0, size - 1) * size + CLAMP(endX, 0, size - 1);
+    }
+
+    ListSolver list;
+    ListSolver_Prepare(&list, &mesh);
+
+    NavSolver solver;
+    NavSolver_Init(&solver);
+    NavSolver_Prepare(&solver, &mesh);
+
+    NavPath* expected = malloc(sizeof(NavPath) * queryCount);
+    int* expectedFound = malloc(sizeof(int) * queryCount);
+
+    double start = Time_Us();
+
+    for (int i = 0; i < queryCount; ++i)
+    {
+        const NavPoly* a = mesh.polys + starts[i];
+        const NavPoly* b = mesh.polys + ends[i];
+        expectedFound[i] = ListSolver_Solve(&list, &mesh, a->plane.point, b->plane.point, a, b, expected + i);
+    }
+
+    double listUs = Time_Us() - start;
+
+    int found = 0;
+    NavPath path;
+    start = Time_Us();
+
+    for (int i = 0; i < queryCount; ++i)
+    {
+        const NavPoly* a = mesh.polys + starts[i];
+        const NavPoly* b = mesh.polys + ends[i];
+
+        int result = NavSolver_Solve(&solver, &mesh, a->plane.point, b->plane.point, a, b, &path);
+
+        if (result != expectedFound[i] || (result && !Path_Equal(&path, expected + i)))
+        {
+            printf("%i polys: query %i from %i to %i differs, %i nodes, expected %i\n",
+                   mesh.polyCount, i, starts[i], ends[i], path.nodeCount, expected[i].nodeCount);
+            return 0;
+        }
+
+        found += result;
+    }
+
+    double heapUs = Time_Us() - start;
+
+    printf("%i polys: sorted list %.0f queries/s, heap %.0f queries/s, %i of %i found\n",
+           mesh.polyCount, queryCount / (listUs / 1e6), queryCount / (heapUs / 1e6), found, queryCount);
+
+    NavSolver_Shutdown(&solver);
+    stb_sb_free(list.pool);
+    stb_sb_free(list.closed);
+    NavMesh_Shutdown(&mesh);
+    free(starts);
+    free(ends);
+    free(expected);
+    free(expectedFound);
+    return 1;
+}
+
+int main(int argc, const char* argv[])
+{
+    int queryCount = 2000;
+    int arg = 1;
+
+    Args_ReadFlag(argc, argv, &arg, "-q", &queryCount);
+
+    if (queryCount < 1)
+    {
+        printf("usage: pathbench [-q queries] [grid size]...\n");
+        return 1;
+    }
+
+    srand(1);
+
+    const int sizes[] = { 20, 50, 90 };
+    return Bench_RunCounts(argc, argv, arg, sizes, 3, 1, GRID_SIZE_MAX, Bench, queryCount) ? 0 : 1;
+}
@@ -0,0 +1,357 @@
+
+/*
+ Converts the background plates written by the blender exporter to DDS.
+
+ Color plates become DXT1 (8:1 against RGBA).
+ Depth plates become BC4 (4 bits per texel, against 24 for the RGB png).
+ stb_image decodes pngs to 8 bits, which BC4 keeps.
+ The engine loads <view>.dds and <view>_depth.dds in place of the pngs when they exist.
+
+ cc -O2 main.c -o platecompress -lm
+
+ platecompress hallway.png hallway.dds
+ platecompress -depth hallway_depth.png hallway_depth.dds
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#include "../../source/platform/stb_image.h"
+
+enum
+{
+    DDSD_CAPS = 0x1,
+    DDSD_HEIGHT = 0x2,
+    DDSD_WIDTH = 0x4,
+    DDSD_PIXELFORMAT = 0x1000,
+    DDSD_LINEARSIZE = 0x80000,
+
+    DDPF_FOURCC = 0x4,
+
+    DDSCAPS_TEXTURE = 0x1000,
+};
+
+typedef enum
+{
+    kPlateDxt1 = 0,
+    kPlateBc4,
+} PlateFormat;
+
+static void Put32(FILE* file, uint32_t x)
+{
+    unsigned char bytes[4] = { x & 0xFF, (x >> 8) & 0xFF, (x >> 16) & 0xFF, (x >> 24) & 0xFF };
+    fwrite(bytes, 4, 1, file);
+}
+
+static void WriteHeader(FILE* file, PlateFormat format, int width, int height, uint32_t dataLength)
+{
+    fwrite("DDS ", 4, 1, file);
+    Put32(file, 124);
+    Put32(file, DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE);
+    Put32(file, height);
+    Put32(file, width);
+    Put32(file, dataLength);
+    Put32(file, 0); // depth
+    Put32(file, 0); // mip count, a single level
+
+    for (int i = 0; i < 11; ++i)
+        Put32(file, 0);
+
+    // pixel format
+    Put32(file, 32);
+
+    Put32(file, DDPF_FOURCC);
+    fwrite(format == kPlateDxt1 ? "DXT1" : "ATI1", 4, 1, file);
+
+    // bit count and masks, unused when compressed
+    for (int i = 0; i < 5; ++i)
+        Put32(file, 0);
+
+    Put32(file, DDSCAPS_TEXTURE);
+    Put32(file, 0);
+    Put32(file, 0);
+    Put32(file, 0);
+    Put32(file, 0);
+}
+
+static uint16_t To565(const int* c)
+{
+    return (uint16_t)(((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+}
+
+static void From565(uint16_t x, int* c)
+{
+    c[0] = ((x >> 11) & 0x1F) * 255 / 31;
+    c[1] = ((x >> 5) & 0x3F) * 255 / 63;
+    c[2] = (x & 0x1F) * 255 / 31;
+}
+
+/* bounding box endpoints inset by 1/16th, flipped to follow the block's diagonal.
+ From "Real-Time DXT Compression", van Waveren. */
+static void EncodeDxt1Block(const unsigned char block[16][4], unsigned char* out)
+{
+    int lo[3] = {255, 255, 255};
+    int hi[3] = {0, 0, 0};
+    int mean[3] = {0, 0, 0};
+
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            lo[c] = block[i][c] < lo[c] ? block[i][c] : lo[c];
+            hi[c] = block[i][c] > hi[c] ? block[i][c] : hi[c];
+            mean[c] += block[i][c];
+        }
+    }
+
+    int covRG = 0;
+    int covBG = 0;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        int g = block[i][1] * 16 - mean[1];
+        covRG += (block[i][0] * 16 - mean[0]) * g;
+        covBG += (block[i][2] * 16 - mean[2]) * g;
+    }
+
+    for (int c = 0; c < 3; ++c)
+    {
+        int inset = (hi[c] - lo[c]) >> 4;
+        lo[c] += inset;
+        hi[c] -= inset;
+    }
+
+    if (covRG < 0) { int t = lo[0]; lo[0] = hi[0]; hi[0] = t; }
+    if (covBG < 0) { int t = lo[2]; lo[2] = hi[2]; hi[2] = t; }
+
+    uint16_t c0 = To565(hi);
+    uint16_t c1 = To565(lo);
+
+    /* c0 > c1 selects the opaque four color mode */
+    if (c0 < c1) { uint16_t t = c0; c0 = c1; c1 = t; }
+
+    uint32_t indices = 0;
+
+    if (c0 != c1)
+    {
+        int palette[4][3];
+        From565(c0, palette[0]);
+        From565(c1, palette[1]);
+
+        for (int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (int i = 0; i < 16; ++i)
+        {
+            int best = 0;
+            int bestDist = -1;
+
+            for (int j = 0; j < 4; ++j)
+            {
+                int dist = 0;
+                for (int c = 0; c < 3; ++c)
+                {
+                    int d = block[i][c] - palette[j][c];
+                    dist += d * d;
+                }
+
+                if (bestDist < 0 || dist < bestDist)
+                {
+                    best = j;
+                    bestDist = dist;
+                }
+            }
+
+            indices |= (uint32_t)best << (i * 2);
+        }
+    }
+
+    out[0] = c0 & 0xFF;
+    out[1] = c0 >> 8;
+    out[2] = c1 & 0xFF;
+    out[3] = c1 >> 8;
+    out[4] = indices & 0xFF;
+    out[5] = (indices >> 8) & 0xFF;
+    out[6] = (indices >> 16) & 0xFF;
+    out[7] = (indices >> 24) & 0xFF;
+}
+
+static void EncodeBc4Block(const unsigned char block[16], unsigned char* out)
+{
+    int lo = 255;
+    int hi = 0;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        lo = block[i] < lo ? block[i] : lo;
+        hi = block[i] > hi ? block[i] : hi;
+    }
+
+    uint64_t indices = 0;
+
+    /* a0 > a1 selects the eight value mode */
+    if (hi != lo)
+    {
+        int palette[8];
+        palette[0] = hi;
+        palette[1] = lo;
+
+        for (int j = 1; j < 7; ++j)
+            palette[j + 1] = ((7 - j) * hi + j * lo) / 7;
+
+        for (int i = 0; i < 16; ++i)
+        {
+            int best = 0;
+            int bestDist = 256;
+
+            for (int j = 0; j < 8; ++j)
+            {
+                int dist = abs(block[i] - palette[j]);
+                if (dist < bestDist)
+                {
+                    best = j;
+                    bestDist = dist;
+                }
+            }
+
+            indices |= (uint64_t)best << (i * 3);
+        }
+    }
+
+    out[0] = hi;
+    out[1] = lo;
+
+    for (int i = 0; i < 6; ++i)
+        out[2 + i] = (indices >> (i * 8)) & 0xFF;
+}
+
+static int WriteDxt1(FILE* file, const char* path)
+{
+    int width, height, comp;
+    unsigned char* pixels = stbi_load(path, &width, &height, &comp, 4);
+
+    if (!pixels)
+    {
+        printf("failed to load %s: %s\n", path, stbi_failure_reason());
+        return 0;
+    }
+
+    int blocksX = (width + 3) / 4;
+    int blocksY = (height + 3) / 4;
+
+    WriteHeader(file, kPlateDxt1, width, height, blocksX * blocksY * 8);
+
+    for (int by = 0; by < blocksY; ++by)
+    {
+        for (int bx = 0; bx < blocksX; ++bx)
+        {
+            unsigned char block[16][4];
+
+            /* edges repeat the last row and column */
+            for (int i = 0; i < 16; ++i)
+            {
+                int x = bx * 4 + (i % 4);
+                int y = by * 4 + (i / 4);
+                x = x < width ? x : width - 1;
+                y = y < height ? y : height - 1;
+                memcpy(block[i], pixels + (y * width + x) * 4, 4);
+            }
+
+            unsigned char out[8];
+            EncodeDxt1Block(block, out);
+            fwrite(out, 8, 1, file);
+        }
+    }
+
+    stbi_image_free(pixels);
+    return 1;
+}
+
+static int WriteDepth(FILE* file, const char* path)
+{
+    int width, height, comp;
+    unsigned char* depth = stbi_load(path, &width, &height, &comp, 1);
+
+    if (!depth)
+    {
+        printf("failed to load %s: %s\n", path, stbi_failure_reason());
+        return 0;
+    }
+
+    int blocksX = (width + 3) / 4;
+    int blocksY = (height + 3) / 4;
+
+    WriteHeader(file, kPlateBc4, width, height, blocksX * blocksY * 8);
+
+    for (int by = 0; by < blocksY; ++by)
+    {
+        for (int bx = 0; bx < blocksX; ++bx)
+        {
+            unsigned char block[16];
+
+            for (int i = 0; i < 16; ++i)
+            {
+                int x = bx * 4 + (i % 4);
+                int y = by * 4 + (i / 4);
+                x = x < width ? x : width - 1;
+                y = y < height ? y : height - 1;
+                block[i] = depth[y * width + x];
+            }
+
+            unsigned char out[8];
+            EncodeBc4Block(block, out);
+            fwrite(out, 8, 1, file);
+        }
+    }
+
+    stbi_image_free(depth);
+    return 1;
+}
+
+int main(int argc, const char* argv[])
+{
+    int depth = 0;
+
+    int arg = 1;
+
+    while (arg < argc && argv[arg][0] == '-')
+    {
+        if (strcmp(argv[arg], "-depth") == 0)
+        {
+            depth = 1;
+        }
+        else
+        {
+            printf("unknown option: %s\n", argv[arg]);
+            return 1;
+        }
+
+        ++arg;
+    }
+
+    if (argc - arg != 2)
+    {
+        printf("usage: platecompress [-depth] <plate.png> <plate.dds>\n");
+        return 1;
+    }
+
+    FILE* file = fopen(argv[arg + 1], "wb");
+
+    if (!file)
+    {
+        printf("failed to open %s\n", argv[arg + 1]);
+        return 1;
+    }
+
+    int status = depth ? WriteDepth(file, argv[arg]) : WriteDxt1(file, argv[arg]);
+
+    fclose(file);
+    return status ? 0 : 1;
+}
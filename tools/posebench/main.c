@@ -0,0 +1,237 @@
+
+/*
+ Checks the batched pose code against the scalar version it replaced, and times both.
+ Exits non zero if any joint is further off than the tolerance.
+
+ E=../../source/engine
+ cc -O2 -I$E/core -I$E/render main.c $E/render/skel.c $E/core/vec_soa.c $E/core/vec_math.c \
+    $E/core/utils.c -o posebench -lm
+
+ posebench [-n iterations] [-j joints]
+
+ Add -DVEC_SOA_SCALAR to check the fallback.
+
+ Reference, -O2, x86-64 SSE2:
+ 40 joints    scalar 5117 ns, batched 1981 ns (2.6x), slerp error 1.8e-5 rad
+ 200 joints   scalar 26348 ns, batched 8425 ns (3.1x)
+ */
+
+#include "skel.h"
+#include "vec_soa.h"
+
+#include "../bench_util.h"
+
+/* radians for rotations, model units for positions */
+#define POSE_TOLERANCE 1e-4f
+
+static Quat Rand_Quat()
+{
+    Quat q = Quat_Create(Rand_Float(-1.0f, 1.0f), Rand_Float(-1.0f, 1.0f), Rand_Float(-1.0f, 1.0f), Rand_Float(-1.0f, 1.0f));
+    return Quat_Norm(q);
+}
+
+/* Skel_Pose before batching */
+static void Reference_Pose(Skel* skel)
+{
+    Vec3 worldOrigin = Quat_MultVec3(&skel->rotation, Vec3_Add(skel->origin, skel->offset));
+
+    for (int i = 0; i < skel->jointCount; ++i)
+    {
+        SkelJoint* joint = skel->joints + i;
+
+        if (joint->parent < 0)
+        {
+            joint->modelHead = worldOrigin;
+            joint->modelTail = Vec3_Add(worldOrigin, joint->tail);
+            joint->modelRotation = Quat_Mult(skel->rotation, joint->rotation);
+        }
+        else
+        {
+            const SkelJoint* parent = &skel->joints[joint->parent];
+
+            joint->modelHead = parent->modelTail;
+            joint->modelRotation = Quat_Mult(parent->modelRotation, joint->rotation);
+            joint->modelTail = Vec3_Add(Quat_MultVec3(&joint->modelRotation, joint->tail), parent->modelTail);
+        }
+
+        skel->renderJointOrigins[i] = joint->modelHead;
+        skel->renderJointRotations[i] = joint->modelRotation;
+    }
+}
+
+/* the animator's slerp before batching */
+static Quat Reference_Slerp(Quat from, Quat to, float t)
+{
+    if (Quat_Dot(from, to) < 0.0f)
+        to = Quat_Scale(to, -1.0f);
+
+    return Quat_Slerp(from, to, t);
+}
+
+static int Skel_Random(Skel* skel, int jointCount)
+{
+    if (!Skel_Init(skel, jointCount, 0))
+        return 0;
+
+    for (int i = 0; i < jointCount; ++i)
+    {
+        SkelJoint* joint = skel->joints + i;
+        snprintf(joint->name, SKEL_JOINT_NAME_MAX, "joint%i", i);
+
+        /* a spine with limbs hanging off, like a character */
+        joint->parent = (i == 0) ? -1 : ((i % 4 == 0) ? rand() % i : i - 1);
+        joint->tail = Vec3_Create(Rand_Float(-1.0f, 1.0f), Rand_Float(0.0f, 1.0f), Rand_Float(-1.0f, 1.0f));
+    }
+
+    skel->origin = Vec3_Create(0.0f, 1.0f, 0.0f);
+    skel->rotation = Rand_Quat();
+    return 1;
+}
+
+int main(int argc, const char* argv[])
+{
+    int iterations = 100000;
+    int jointCount = 40;
+
+    int arg = 1;
+
+    while (Args_ReadFlag(argc, argv, &arg, "-n", &iterations) || Args_ReadFlag(argc, argv, &arg, "-j", &jointCount))
+        ;
+
+    if (arg < argc || iterations < 1 || jointCount < 1 || jointCount > 0x7FFF)
+    {
+        printf("usage: posebench [-n iterations] [-j joints]\n");
+        return 1;
+    }
+
+#if VEC_SOA_SSE
+    printf("kernels: sse\n");
+#elif VEC_SOA_NEON
+    printf("kernels: neon\n");
+#else
+    printf("kernels: scalar\n");
+#endif
+
+    srand(1);
+
+    Skel skel;
+    Skel reference;
+
+    if (!Skel_Random(&skel, jointCount) || !Skel_Copy(&reference, &skel))
+    {
+        printf("failed to create skeleton\n");
+        return 1;
+    }
+
+    int padded = VEC_SOA_PAD(jointCount);
+    float* lanes = malloc(sizeof(float) * padded * 8);
+    Quat* from = malloc(sizeof(Quat) * jointCount);
+    Quat* to = malloc(sizeof(Quat) * jointCount);
+
+    QuatSoA fromSoA = QuatSoA_Arrays(lanes, padded);
+    QuatSoA toSoA = QuatSoA_Arrays(lanes + padded * 4, padded);
+
+    float slerpError = 0.0f;
+    float rotationError = 0.0f;
+    float positionError = 0.0f;
+
+    for (int trial = 0; trial < 1000; ++trial)
+    {
+        float t = (trial % 11) / 10.0f;
+
+        for (int i = 0; i < jointCount; ++i)
+        {
+            from[i] = Rand_Quat();
+
+            /* mostly small steps as between frames, some large as in transitions */
+            to[i] = (trial % 2) ? Rand_Quat() : Quat_Norm(Quat_Add(from[i], Quat_Scale(Rand_Quat(), 0.1f)));
+
+            if (rand() % 2)
+                to[i] = Quat_Scale(to[i], -1.0f);
+
+            QuatSoA_Set(fromSoA, i, from[i]);
+            QuatSoA_Set(toSoA, i, to[i]);
+        }
+
+        for (int i = jointCount; i < padded; ++i)
+        {
+            QuatSoA_Set(fromSoA, i, Quat_Identity);
+            QuatSoA_Set(toSoA, i, Quat_Identity);
+        }
+
+        QuatSoA_Slerp(fromSoA, fromSoA, toSoA, t, jointCount);
+
+        for (int i = 0; i < jointCount; ++i)
+        {
+            Quat expected = Reference_Slerp(from[i], to[i], t);
+            slerpError = MAX(slerpError, Quat_Angle(expected, QuatSoA_Get(fromSoA, i)));
+
+            skel.joints[i].rotation = expected;
+            reference.joints[i].rotation = expected;
+        }
+
+        Skel_Pose(&skel);
+        Reference_Pose(&reference);
+
+        for (int i = 0; i < jointCount; ++i)
+        {
+            rotationError = MAX(rotationError, Quat_Angle(skel.renderJointRotations[i], reference.renderJointRotations[i]));
+            positionError = MAX(positionError, Vec3_Dist(skel.joints[i].modelTail, reference.joints[i].modelTail));
+            positionError = MAX(positionError, Vec3_Dist(skel.renderJointOrigins[i], reference.renderJointOrigins[i]));
+        }
+    }
+
+    printf("%i joints in %i levels\n", jointCount, skel.poseLevelCount);
+    printf("max error: slerp %g rad, rotation %g rad, position %g\n", slerpError, rotationError, positionError);
+
+    double start = Time_Us();
+
+    for (int n = 0; n < iterations; ++n)
+    {
+        float t = (n % 8) / 8.0f;
+
+        for (int i = 0; i < jointCount; ++i)
+            reference.joints[i].rotation = Reference_Slerp(from[i], to[i], t);
+
+        Reference_Pose(&reference);
+    }
+
+    double scalarNs = (Time_Us() - start) * 1e3 / iterations;
+    start = Time_Us();
+
+    for (int n = 0; n < iterations; ++n)
+    {
+        float t = (n % 8) / 8.0f;
+
+        for (int i = 0; i < jointCount; ++i)
+        {
+            QuatSoA_Set(fromSoA, i, from[i]);
+            QuatSoA_Set(toSoA, i, to[i]);
+        }
+
+        QuatSoA_Slerp(fromSoA, fromSoA, toSoA, t, jointCount);
+
+        for (int i = 0; i < jointCount; ++i)
+            skel.joints[i].rotation = QuatSoA_Get(fromSoA, i);
+
+        Skel_Pose(&skel);
+    }
+
+    double batchNs = (Time_Us() - start) * 1e3 / iterations;
+
+    printf("blend + pose: scalar %.0f ns, batched %.0f ns (%.2fx)\n", scalarNs, batchNs, scalarNs / batchNs);
+
+    free(lanes);
+    free(from);
+    free(to);
+    Skel_Shutdown(&skel);
+    Skel_Shutdown(&reference);
+
+    if (slerpError > POSE_TOLERANCE || rotationError > POSE_TOLERANCE || positionError > POSE_TOLERANCE)
+    {
+        printf("FAILED: tolerance %g\n", POSE_TOLERANCE);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,302 @@
+
+/*
+ Converts text .skanim animations written by the blender exporter to binary .bskanim.
+ The engine picks the loader by extension, so point data.assets at the .bskanim.
+
+ E=../../source/engine
+ cc -O2 -I$E/core -I$E/render main.c $E/render/skel_anim.c $E/render/skel.c \
+    $E/core/vec_math.c $E/core/vec_soa.c $E/core/geo_math.c $E/core/utils.c -o skanimconvert -lm
+
+ skanimconvert astronaut_walk.skanim astronaut_walk.bskanim
+ skanimconvert -compress 0.5 astronaut_walk.skanim astronaut_walk.bskanim
+ skanimconvert -bench 100 astronaut_walk.skanim astronaut_walk.bskanim
+
+ -compress writes version 2, smallest three keys with constant tracks stored once.
+ A non zero error in degrees also drops keys that slerping can rebuild within it.
+ The compression ratio and the largest angular error against the text are printed.
+
+ -bench loads both files repeatedly and prints the average load time of each.
+
+ Reference, a 40 joint, 120 frame walk, and a 4 joint clip spinning a full turn about
+ each axis, whose keys flip sign between frames:
+ clip     -compress   keys          max error
+ walk     0           3372 / 4800   0.0053 degrees
+ walk     0.5         514 / 4800    0.4990 degrees
+ spin     0           480 / 480     0.0072 degrees
+ spin     0.5         15 / 480      0.0057 degrees
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "skel_anim.h"
+
+static void Put32(FILE* file, uint32_t x)
+{
+    unsigned char bytes[4] = { x & 0xFF, (x >> 8) & 0xFF, (x >> 16) & 0xFF, (x >> 24) & 0xFF };
+    fwrite(bytes, 4, 1, file);
+}
+
+static void Put16(FILE* file, uint16_t x)
+{
+    unsigned char bytes[2] = { x & 0xFF, x >> 8 };
+    fwrite(bytes, 2, 1, file);
+}
+
+static void PutFloat(FILE* file, float f)
+{
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    Put32(file, x);
+}
+
+static int WriteBinary(const SkelAnim* anim, const char* path)
+{
+    FILE* file = fopen(path, "wb");
+
+    if (!file)
+    {
+        printf("failed to open %s\n", path);
+        return 0;
+    }
+
+    fwrite(SKEL_ANIM_BINARY_MAGIC, 4, 1, file);
+    Put32(file, anim->tracks ? SKEL_ANIM_BINARY_VERSION : 1);
+    Put32(file, anim->jointCount);
+    Put32(file, anim->frameCount);
+    Put32(file, anim->framesPerSecond);
+    Put32(file, anim->markerCount);
+
+    for (int i = 0; i < anim->frameCount; ++i)
+    {
+        const Vec3* offset = &anim->frames[i].rootOffset;
+        PutFloat(file, offset->x);
+        PutFloat(file, offset->y);
+        PutFloat(file, offset->z);
+    }
+
+    if (anim->tracks)
+    {
+        Put32(file, anim->keyCount);
+
+        for (int i = 0; i < anim->jointCount; ++i)
+        {
+            Put32(file, anim->tracks[i].firstKey);
+            Put32(file, anim->tracks[i].keyCount);
+        }
+
+        for (unsigned int i = 0; i < anim->keyCount; ++i)
+            Put16(file, anim->keyFrames[i]);
+
+        for (unsigned int i = 0; i < anim->keyCount; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+                Put16(file, anim->keys[i].c[j]);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < anim->frameCount * anim->jointCount; ++i)
+        {
+            const Quat* q = &anim->frameData[i].rotation;
+            PutFloat(file, q->x);
+            PutFloat(file, q->y);
+            PutFloat(file, q->z);
+            PutFloat(file, q->w);
+        }
+    }
+
+    for (int i = 0; i < anim->markerCount; ++i)
+    {
+        char name[SKEL_ANIM_MARKER_NAME_MAX];
+        memset(name, 0, sizeof(name));
+        snprintf(name, sizeof(name), "%s", anim->markers[i].name);
+
+        fwrite(name, SKEL_ANIM_MARKER_NAME_MAX, 1, file);
+        Put32(file, anim->markers[i].frame);
+    }
+
+    fclose(file);
+    return 1;
+}
+
+static int Matches(const SkelAnim* a, const SkelAnim* b)
+{
+    if (a->jointCount != b->jointCount ||
+        a->frameCount != b->frameCount ||
+        a->markerCount != b->markerCount)
+        return 0;
+
+    for (int i = 0; i < a->frameCount; ++i)
+    {
+        if (a->frames[i].markerIndex != b->frames[i].markerIndex ||
+            memcmp(&a->frames[i].rootOffset, &b->frames[i].rootOffset, sizeof(Vec3)) != 0)
+            return 0;
+    }
+
+    if ((a->tracks != NULL) != (b->tracks != NULL))
+        return 0;
+
+    if (a->tracks)
+    {
+        if (a->keyCount != b->keyCount ||
+            memcmp(a->tracks, b->tracks, sizeof(SkelAnimTrack) * a->jointCount) != 0 ||
+            memcmp(a->keyFrames, b->keyFrames, sizeof(unsigned short) * a->keyCount) != 0 ||
+            memcmp(a->keys, b->keys, sizeof(SkelAnimKey) * a->keyCount) != 0)
+            return 0;
+    }
+    else if (memcmp(a->frameData, b->frameData, sizeof(SkelAnimJoint) * a->frameCount * a->jointCount) != 0)
+    {
+        return 0;
+    }
+
+    for (int i = 0; i < a->markerCount; ++i)
+    {
+        if (a->markers[i].frame != b->markers[i].frame ||
+            strcmp(a->markers[i].name, b->markers[i].name) != 0)
+            return 0;
+    }
+
+    return 1;
+}
+
+static void Report(const SkelAnim* reference, const SkelAnim* compressed)
+{
+    size_t rawBytes = sizeof(SkelAnimJoint) * reference->jointCount * reference->frameCount;
+    size_t compressedBytes = sizeof(SkelAnimTrack) * compressed->jointCount +
+                             (sizeof(SkelAnimKey) + sizeof(unsigned short)) * compressed->keyCount;
+
+    int constantTracks = 0;
+    for (int j = 0; j < compressed->jointCount; ++j)
+    {
+        if (compressed->tracks[j].keyCount == 1)
+            ++constantTracks;
+    }
+
+    float maxError = 0.0f;
+    int maxJoint = 0;
+    int maxFrame = 0;
+
+    for (int f = 0; f < reference->frameCount; ++f)
+    {
+        for (int j = 0; j < reference->jointCount; ++j)
+        {
+            float error = Quat_Angle(SkelAnim_JointRotation(reference, f, j), SkelAnim_JointRotation(compressed, f, j));
+
+            if (error > maxError)
+            {
+                maxError = error;
+                maxJoint = j;
+                maxFrame = f;
+            }
+        }
+    }
+
+    printf("rotations %zu -> %zu bytes, %.1fx\n", rawBytes, compressedBytes, rawBytes / (double)compressedBytes);
+    printf("%u keys of %i, %i of %i tracks constant\n",
+           compressed->keyCount,
+           reference->jointCount * reference->frameCount,
+           constantTracks,
+           compressed->jointCount);
+    printf("max error %.4f degrees, joint %i frame %i\n", RAD_TO_DEG(maxError), maxJoint, maxFrame);
+}
+
+static double Bench(const char* path, int iterations)
+{
+    clock_t start = clock();
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        SkelAnim anim;
+        memset(&anim, 0, sizeof(anim));
+
+        if (!SkelAnim_FromPath(&anim, path))
+            return -1.0;
+
+        SkelAnim_Shutdown(&anim);
+    }
+
+    return ((double)(clock() - start) / CLOCKS_PER_SEC) * 1000.0 / iterations;
+}
+
+int main(int argc, const char* argv[])
+{
+    int iterations = 0;
+    float maxError = -1.0f;
+    int arg = 1;
+
+    while (argc - arg > 2)
+    {
+        if (strcmp(argv[arg], "-bench") == 0)
+            iterations = atoi(argv[arg + 1]);
+        else if (strcmp(argv[arg], "-compress") == 0)
+            maxError = atof(argv[arg + 1]);
+        else
+            break;
+
+        arg += 2;
+    }
+
+    if (argc - arg != 2)
+    {
+        printf("usage: skanimconvert [-bench <iterations>] [-compress <max error degrees>] <anim.skanim> <anim.bskanim>\n");
+        return 1;
+    }
+
+    const char* inPath = argv[arg];
+    const char* outPath = argv[arg + 1];
+
+    SkelAnim text;
+    memset(&text, 0, sizeof(text));
+
+    if (!SkelAnim_FromPath(&text, inPath))
+    {
+        printf("failed to load %s\n", inPath);
+        return 1;
+    }
+
+    SkelAnim reference;
+    memset(&reference, 0, sizeof(reference));
+
+    if (maxError >= 0.0f)
+    {
+        if (!SkelAnim_FromPath(&reference, inPath) || !SkelAnim_Compress(&text, maxError))
+        {
+            printf("failed to compress %s\n", inPath);
+            return 1;
+        }
+    }
+
+    if (!WriteBinary(&text, outPath))
+        return 1;
+
+    /* the binary must reload to exactly what the text parsed or compressed to */
+    SkelAnim binary;
+    memset(&binary, 0, sizeof(binary));
+
+    if (!SkelAnim_FromPath(&binary, outPath) || !Matches(&text, &binary))
+    {
+        printf("round trip mismatch: %s\n", outPath);
+        return 1;
+    }
+
+    printf("%s: %i joints, %i frames, %i markers\n", outPath, text.jointCount, text.frameCount, text.markerCount);
+
+    if (maxError >= 0.0f)
+        Report(&reference, &text);
+
+    SkelAnim_Shutdown(&reference);
+    SkelAnim_Shutdown(&text);
+    SkelAnim_Shutdown(&binary);
+
+    if (iterations > 0)
+    {
+        printf("skanim  %.3f ms\n", Bench(inPath, iterations));
+        printf("bskanim %.3f ms\n", Bench(outPath, iterations));
+    }
+
+    return 0;
+}
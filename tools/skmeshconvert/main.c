@@ -0,0 +1,236 @@
+
+/*
+ Converts text .skmesh models written by the blender exporter to binary .bskmesh.
+ The engine picks the loader by extension, so point data.assets at the .bskmesh.
+
+ E=../../source/engine
+ cc -O2 -I$E/core -I$E/render main.c $E/render/skel_model.c $E/render/skel_skin.c \
+    $E/render/skel_anim.c $E/render/skel.c $E/render/material.c $E/render/mesh_opt.c \
+    $E/core/vec_math.c $E/core/vec_soa.c $E/core/geo_math.c $E/core/utils.c -o skmeshconvert -lm
+
+ skmeshconvert astronaut.skmesh astronaut.bskmesh
+
+ The output is reloaded and must match the text load bit for bit.
+ Text meshes are welded and cache ordered on load, so the output carries those indices
+ and the engine skips that work.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "skel_model.h"
+#include "mesh_opt.h"
+
+static void Put32(FILE* file, uint32_t x)
+{
+    unsigned char bytes[4] = { x & 0xFF, (x >> 8) & 0xFF, (x >> 16) & 0xFF, (x >> 24) & 0xFF };
+    fwrite(bytes, 4, 1, file);
+}
+
+static void PutFloat(FILE* file, float f)
+{
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    Put32(file, x);
+}
+
+static void PutVec3(FILE* file, Vec3 v)
+{
+    PutFloat(file, v.x);
+    PutFloat(file, v.y);
+    PutFloat(file, v.z);
+}
+
+static void PutName(FILE* file, const char* name)
+{
+    char padded[SKEL_JOINT_NAME_MAX];
+    memset(padded, 0, sizeof(padded));
+    snprintf(padded, sizeof(padded), "%s", name);
+    fwrite(padded, SKEL_JOINT_NAME_MAX, 1, file);
+}
+
+static void PutVert(FILE* file, const SkelSkinVert* vert)
+{
+    PutVec3(file, vert->normal);
+    PutVec3(file, vert->tangent);
+
+    unsigned char uv[4] = { vert->uv.u & 0xFF, vert->uv.u >> 8, vert->uv.v & 0xFF, vert->uv.v >> 8 };
+    fwrite(uv, 4, 1, file);
+
+    for (int i = 0; i < SKEL_WEIGHTS_PER_VERT; ++i)
+    {
+        PutFloat(file, vert->weights[i].x);
+        PutFloat(file, vert->weights[i].y);
+        PutFloat(file, vert->weights[i].z);
+        PutFloat(file, vert->weights[i].w);
+    }
+
+    for (int i = 0; i < SKEL_WEIGHTS_PER_VERT; ++i)
+    {
+        unsigned char joint[2] = { vert->weightJoints[i] & 0xFF, vert->weightJoints[i] >> 8 };
+        fwrite(joint, 2, 1, file);
+    }
+
+    unsigned char padding[2] = { 0, 0 };
+    fwrite(padding, 2, 1, file);
+}
+
+static int WriteBinary(const SkelModel* model, const char* path)
+{
+    FILE* file = fopen(path, "wb");
+
+    if (!file)
+    {
+        printf("failed to open %s\n", path);
+        return 0;
+    }
+
+    const Skel* skel = &model->skel;
+    const SkelSkin* skin = &model->skin;
+
+    fwrite(SKEL_MODEL_BINARY_MAGIC, 4, 1, file);
+    Put32(file, SKEL_MODEL_BINARY_VERSION);
+    Put32(file, skin->vertCount);
+    Put32(file, skin->weightCount);
+    Put32(file, skel->jointCount);
+    Put32(file, skel->attachPointCount);
+
+    PutVec3(file, skel->origin);
+
+    /* the text format has no material, so this is Material_Init's */
+    Put32(file, 0);
+    Put32(file, model->material.albedoMap);
+    Put32(file, model->material.normalMap);
+    Put32(file, model->material.specularMap);
+    Put32(file, model->material.glossMap);
+
+    for (int i = 0; i < skel->jointCount; ++i)
+    {
+        const SkelJoint* joint = skel->joints + i;
+        PutName(file, joint->name);
+        Put32(file, joint->parent);
+        PutVec3(file, joint->tail);
+    }
+
+    for (int i = 0; i < skel->attachPointCount; ++i)
+    {
+        const SkelAttachPoint* attachPoint = skel->attachPoints + i;
+        PutName(file, attachPoint->name);
+        Put32(file, attachPoint->joint);
+        PutVec3(file, attachPoint->offset);
+        PutFloat(file, attachPoint->rotation.x);
+        PutFloat(file, attachPoint->rotation.y);
+        PutFloat(file, attachPoint->rotation.z);
+        PutFloat(file, attachPoint->rotation.w);
+    }
+
+    long vertsOffset = SKEL_MODEL_BINARY_VERTS_OFFSET(skel->jointCount, skel->attachPointCount);
+
+    while (ftell(file) < vertsOffset)
+        fputc(0, file);
+
+    for (int i = 0; i < skin->vertCount; ++i)
+        PutVert(file, skin->verts + i);
+
+    Put32(file, skin->indexCount);
+
+    for (unsigned int i = 0; i < skin->indexCount; ++i)
+        Put32(file, skin->indices[i]);
+
+    fclose(file);
+    return 1;
+}
+
+static int Matches(const SkelModel* a, const SkelModel* b)
+{
+    if (a->skel.jointCount != b->skel.jointCount ||
+        a->skel.attachPointCount != b->skel.attachPointCount ||
+        a->skin.vertCount != b->skin.vertCount ||
+        a->skin.weightCount != b->skin.weightCount ||
+        a->skin.indexCount != b->skin.indexCount)
+        return 0;
+
+    if (memcmp(&a->skel.origin, &b->skel.origin, sizeof(Vec3)) != 0)
+        return 0;
+
+    for (int i = 0; i < a->skel.jointCount; ++i)
+    {
+        const SkelJoint* ja = a->skel.joints + i;
+        const SkelJoint* jb = b->skel.joints + i;
+
+        if (strcmp(ja->name, jb->name) != 0 ||
+            ja->parent != jb->parent ||
+            memcmp(&ja->tail, &jb->tail, sizeof(Vec3)) != 0)
+            return 0;
+    }
+
+    for (int i = 0; i < a->skel.attachPointCount; ++i)
+    {
+        const SkelAttachPoint* pa = a->skel.attachPoints + i;
+        const SkelAttachPoint* pb = b->skel.attachPoints + i;
+
+        if (strcmp(pa->name, pb->name) != 0 ||
+            pa->joint != pb->joint ||
+            memcmp(&pa->offset, &pb->offset, sizeof(Vec3)) != 0 ||
+            memcmp(&pa->rotation, &pb->rotation, sizeof(Quat)) != 0)
+            return 0;
+    }
+
+    /* verts are calloc'd by both loaders, so padding compares too */
+    if (memcmp(a->skin.verts, b->skin.verts, sizeof(SkelSkinVert) * a->skin.vertCount) != 0)
+        return 0;
+
+    if (a->skin.indexCount > 0 &&
+        memcmp(a->skin.indices, b->skin.indices, sizeof(unsigned int) * a->skin.indexCount) != 0)
+        return 0;
+
+    return 1;
+}
+
+int main(int argc, const char* argv[])
+{
+    if (argc != 3)
+    {
+        printf("usage: skmeshconvert <model.skmesh> <model.bskmesh>\n");
+        return 1;
+    }
+
+    SkelModel text;
+    memset(&text, 0, sizeof(text));
+
+    if (!SkelModel_FromPath(&text, argv[1]))
+    {
+        printf("failed to load %s\n", argv[1]);
+        return 1;
+    }
+
+    if (!WriteBinary(&text, argv[2]))
+        return 1;
+
+    SkelModel binary;
+    memset(&binary, 0, sizeof(binary));
+
+    if (!SkelModel_FromPath(&binary, argv[2]) || !Matches(&text, &binary))
+    {
+        printf("round trip mismatch: %s\n", argv[2]);
+        return 1;
+    }
+
+    printf("%s: %i verts, %i joints, %i attach points\n",
+           argv[2],
+           text.skin.vertCount,
+           text.skel.jointCount,
+           text.skel.attachPointCount);
+
+    /* unindexed, every corner ran the skinning shader */
+    if (text.skin.indexCount > 0)
+    {
+        printf("%u corners, ACMR %.2f (FIFO 16) instead of 3.00\n",
+               text.skin.indexCount,
+               MeshOpt_ACMR(text.skin.indices, text.skin.indexCount, text.skin.vertCount, 16));
+    }
+
+    return 0;
+}